@@ -1,7 +1,7 @@
 /******************************************************************************
 * Zowi Battery Reader Library
-* 
-* @version 20150831
+*
+* @version 20261019
 * @author Raul de Pablos Martin
 *
 ******************************************************************************/
@@ -15,17 +15,128 @@
 #endif
 
 BatReader::BatReader() {
+	average = 0;
+	lastSample = 0;
+	lastVcc = 0;
+	lastTrend = 0;
+	vccMv = ANA_REF * 1000;
+	bandgapMv = BAT_BANDGAP_MV;
+	trendMv = 0;
+	rate = 0;
+	attached = 0;
+	moving = 0;
+	sagHolding = BAT_SAG_HOLDING;
+	sagMoving = BAT_SAG_MOVING;
+}
+
+void BatReader::begin(void) {
+	average = 0;
+	update();
+}
+
+void BatReader::update(void) {
+	unsigned long now = millis();
+	if(average && now - lastSample < BAT_PERIOD) return;
+
+	// Vcc and the battery are not measured in the same call, so that
+	// update() stalls the caller for one of the two only (see BAT_PERIOD)
+	if(!average || now - lastVcc >= BAT_VCC_PERIOD) {
+		measureVcc();
+		lastVcc = now;
+		if(average) return;
+	}
+
+	// Add back what the servos are taking
+	unsigned int mv = readMillivolts() + attached * sagHolding + moving * sagMoving;
+
+	if(!average) {
+		average = (unsigned long)mv << BAT_EMA_SHIFT;
+		trendMv = mv;
+		lastTrend = now;
+	}
+	else {
+		average += mv - (average >> BAT_EMA_SHIFT);
+	}
+	lastSample = now;
+
+	// Discharge rate, smoothed over a few periods
+	if(now - lastTrend >= BAT_TREND_PERIOD) {
+		unsigned int v = voltage();
+		long drop = ((long)trendMv - v) * (16 * 60000L / 64) / (long)((now - lastTrend) / 64);
+		drop = constrain(drop, -0x7FFF, 0x7FFF);
+		rate = rate ? rate + ((drop - rate) >> 2) : drop;
+		trendMv = v;
+		lastTrend = now;
+	}
+}
+
+void BatReader::setLoad(unsigned char attached, unsigned char moving) {
+	this->attached = attached;
+	this->moving = moving;
+}
+
+void BatReader::setSag(unsigned char holding, unsigned char moving) {
+	sagHolding = holding;
+	sagMoving = moving;
+}
+
+void BatReader::setBandgap(unsigned int mv) {
+	bandgapMv = mv;
+	average = 0;
 }
 
-double BatReader::readBatVoltage(void) {
-	double readed = (double)(analogRead(BAT_PIN)*ANA_REF)/1024;
-	if(readed > BAT_MAX) return BAT_MAX;
-	else return readed;
+unsigned int BatReader::voltage(void) {
+	if(!average) update();
+	return average >> BAT_EMA_SHIFT;
 }
 
-double BatReader::readBatPercent(void) {
-	double value = (SLOPE*readBatVoltage()) - OFFSET;
-	if(value < 0) return 0;
-	else return value;
+unsigned char BatReader::level(void) {
+	return percent(voltage());
 }
 
+unsigned int BatReader::runtime(void) {
+	unsigned int mv = voltage();
+	if(rate <= 0) return BAT_RUNTIME_UNKNOWN;
+	if(mv <= BAT_MIN_MV) return 0;
+	unsigned long minutes = ((unsigned long)(mv - BAT_MIN_MV) << 4) / rate;
+	return minutes < BAT_RUNTIME_UNKNOWN ? minutes : BAT_RUNTIME_UNKNOWN - 1;
+}
+
+unsigned int BatReader::vcc(void) {
+	return vccMv;
+}
+
+unsigned int BatReader::readVoltage(void) {
+	unsigned int mv = readMillivolts();
+	return mv < BAT_MAX_MV ? mv : BAT_MAX_MV;
+}
+
+unsigned char BatReader::readLevel(void) {
+	return percent(readVoltage());
+}
+
+// Vcc from a conversion of the bandgap with Vcc as reference. Only on the
+// chips with the bandgap on channel 14, elsewhere Vcc stays at ANA_REF
+void BatReader::measureVcc(void) {
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || defined(__AVR_ATmega168__)
+	ADMUX = _BV(REFS0) | 0x0E;
+	delayMicroseconds(250);		// Settle the sample and hold on the bandgap
+	for(uint8_t i = 0; i < 2; i++) {
+		ADCSRA |= _BV(ADSC);
+		while(bit_is_set(ADCSRA, ADSC));
+	}
+	unsigned int raw = ADC;
+	if(raw) vccMv = ((unsigned long)bandgapMv << 10) / raw;
+#endif
+}
+
+unsigned int BatReader::readMillivolts(void) {
+	analogRead(BAT_PIN);		// The first reading after changing channels is often wrong
+	return ((unsigned long)analogRead(BAT_PIN) * vccMv) >> 10;
+}
+
+unsigned char BatReader::percent(unsigned int mv) {
+	if(mv <= BAT_MIN_MV) return 0;
+	if(mv >= BAT_MAX_MV) return 100;
+	return (unsigned long)(mv - BAT_MIN_MV) * 100 / (BAT_MAX_MV - BAT_MIN_MV);
+}
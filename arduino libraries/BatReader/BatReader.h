@@ -1,7 +1,24 @@
 /******************************************************************************
 * Zowi Battery Reader Library
-* 
-* @version 20150824
+*
+* The battery estimate is kept in integer millivolts. update() takes at most
+* one sample every BAT_PERIOD ms and feeds an exponential moving average, so
+* voltage(), level() and runtime() are O(1) and never block.
+*
+* The conversions of update() are blocking: the ADC is shared with the
+* analogRead() calls of the sketch (the noise sensor), which would take the
+* result of a conversion left running. The stalls are given next to
+* BAT_PERIOD and BAT_VCC_PERIOD; update() has one or the other, never both.
+*
+* The ADC reference (Vcc) is measured against the internal bandgap, and the
+* sag caused by the servos is added back from the load given with setLoad()
+* (attached and moving servos), so walking does not look like a flat battery.
+*
+* Everything is computed in integers. With ZOWI_NO_FLOAT defined (float-free
+* profile of the Zowi libraries) the readings in V and percent as double are
+* left out.
+*
+* @version 20261019
 * @author Raul de Pablos Martin
 *
 ******************************************************************************/
@@ -25,47 +42,98 @@
 #define SLOPE	100/(BAT_MAX - BAT_MIN)
 #define OFFSET	(100*BAT_MIN)/(BAT_MAX - BAT_MIN)
 
+#define BAT_MAX_MV 4200
+#define BAT_MIN_MV 3250
+#define BAT_BANDGAP_MV 1100			// Nominal, 1.0 to 1.2 V from chip to chip: see setBandgap()
+
+#define BAT_PERIOD 50				// ms between samples. Each one stalls update() for two conversions, ~0.23 ms
+#define BAT_EMA_SHIFT 4				// Filter time constant: 2^4 samples (0.8 s)
+#define BAT_VCC_PERIOD 10000		// ms between Vcc measurements. Each one stalls update() for 0.25 ms + two conversions, ~0.48 ms
+#define BAT_TREND_PERIOD 60000		// ms between discharge rate updates
+#define BAT_SAG_HOLDING 10			// Default mV lost per attached servo
+#define BAT_SAG_MOVING 60			// Default mV lost per moving servo
+#define BAT_RUNTIME_UNKNOWN 0xFFFF
+
 class BatReader
 {
 public:
-	////////////////////////////
-	// Enumerations           //
-	////////////////////////////
-
-	////////////////////////////
-	// Variables              //
-	////////////////////////////
-
 	////////////////////////////
 	// Functions              //
 	////////////////////////////
 	// BatReader -- BatReader class constructor
 	BatReader();
 
-	// readBatPercent
-	double readBatVoltage(void);
-	
-	// readBatPercent
-	double readBatPercent(void);
-	
-	
+	// begin -- measure Vcc and take the first sample
+	void begin(void);
 
-private:	
-	////////////////////////////
-	// Enumerations           //
-	////////////////////////////
-	
-	
+	// update -- sample the battery if BAT_PERIOD ms have passed. Call it often
+	void update(void);
+
+	// setLoad -- servos attached and servos moving, for the sag compensation
+	void setLoad(unsigned char attached, unsigned char moving);
+
+	// setSag -- mV lost per attached and per moving servo
+	void setSag(unsigned char holding, unsigned char moving);
+
+	// setBandgap -- measured bandgap of this chip, in mV
+	void setBandgap(unsigned int mv);
+
+	// voltage -- filtered and compensated battery voltage, in mV
+	unsigned int voltage(void);
+
+	// level -- battery percent, 0 to 100
+	unsigned char level(void);
+
+	// runtime -- minutes left at the current discharge rate, or BAT_RUNTIME_UNKNOWN
+	unsigned int runtime(void);
+
+	// vcc -- last Vcc measurement, in mV
+	unsigned int vcc(void);
+
+	// readVoltage -- single, unfiltered reading in mV (at most BAT_MAX_MV)
+	unsigned int readVoltage(void);
+
+	// readLevel -- single, unfiltered reading in percent, 0 to 100
+	unsigned char readLevel(void);
+
+#ifndef ZOWI_NO_FLOAT
+	// readBatVoltage -- single, unfiltered reading in V
+	double readBatVoltage(void) {return readVoltage() / 1000.0;}
+
+	// readBatPercent -- single, unfiltered reading in percent
+	double readBatPercent(void) {
+		return max((int)readVoltage() - BAT_MIN_MV, 0) * 100.0 / (BAT_MAX_MV - BAT_MIN_MV);
+	}
+#endif
+
+
+
+private:
 	////////////////////////////
 	// Variables              //
 	////////////////////////////
-	
-	
+	unsigned long average;			// mV << BAT_EMA_SHIFT, 0 = no samples yet
+	unsigned long lastSample;
+	unsigned long lastVcc;
+	unsigned long lastTrend;
+	unsigned int vccMv;
+	unsigned int bandgapMv;
+	unsigned int trendMv;
+	int rate;						// Discharge rate, mV per minute << 4
+	unsigned char attached;
+	unsigned char moving;
+	unsigned char sagHolding;
+	unsigned char sagMoving;
+
+
 	////////////////////////////
 	// Functions              //
 	////////////////////////////
-	
-	
+	void measureVcc(void);
+	unsigned int readMillivolts(void);
+	static unsigned char percent(unsigned int mv);
+
+
 };
 
 #endif // BATREADER_H //
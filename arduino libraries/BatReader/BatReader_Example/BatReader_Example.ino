@@ -1,18 +1,32 @@
 #include "BatReader.h"
 
 BatReader batreader;
+unsigned long lastPrint = 0;
 
 void setup() {
   // put your setup code here, to run once:
   Serial.begin(115200);
-
+  batreader.begin();
+  Serial.print("Vcc (mV): ");
+  Serial.println(batreader.vcc());
 }
 
 void loop() {
-  Serial.print("Battery Voltage: ");
-  Serial.println(batreader.readBatVoltage());
-  Serial.print("Battery Percentage: ");
-  Serial.print(batreader.readBatPercent());
-  Serial.println("%\n\r");
-  delay(1000);
+  // Cheap when there is nothing to do: call it as often as possible
+  batreader.update();
+
+  if(millis() - lastPrint >= 1000) {
+    lastPrint = millis();
+    Serial.print("Battery Voltage (mV): ");
+    Serial.println(batreader.voltage());
+    Serial.print("Battery Percentage: ");
+    Serial.print(batreader.level());
+    Serial.println("%");
+    Serial.print("Runtime (min): ");
+    if(batreader.runtime() == BAT_RUNTIME_UNKNOWN) Serial.println("unknown");
+    else Serial.println(batreader.runtime());
+    Serial.print("Single reading (mV): ");
+    Serial.println(batreader.readVoltage());
+    Serial.println();
+  }
 }
@@ -0,0 +1,192 @@
+/******************************************************************************
+* Zowi Beat Tracker Library
+*
+* @version 20261019
+*
+******************************************************************************/
+
+#include "BeatTracker.h"
+
+#if defined(ARDUINO) && ARDUINO >= 100
+  #include "Arduino.h"
+#else
+  #include "WProgram.h"
+#endif
+
+BeatTracker::BeatTracker() {
+	begin();
+}
+
+void BeatTracker::begin(void) {
+	frameLevel = -1;
+	lastLevel = 0;
+	meanRise = 0;
+	for(int i = 0; i < BEAT_HISTORY; i++) onsets[i] = 0;
+	frame = 0;
+	for(int i = 0; i < BEAT_LAGS; i++) acf[i] = 0;
+	periodQ4 = 0;
+	candidate = 0;
+	conf = 0;
+	for(int i = 0; i < BEAT_BINS; i++) comb[i] = 0;
+	beatPhase = 0;
+	beatAt = 0;
+	phaseStep = 0;
+	locked = false;
+	beat = false;
+}
+
+bool BeatTracker::update(unsigned long t, int level) {
+	if(frameLevel < 0 || t - frameTime >= (unsigned long)BEAT_GAP_FRAMES * BEAT_FRAME) {
+		// The first level, or after a long gap: the beats are lost
+		frameTime = t;
+		frameLevel = level;
+		lastLevel = level;
+		locked = false;
+		return false;
+	}
+
+	// The frames that have ended: the loudest level, then no rise in the gaps
+	if(t - frameTime >= BEAT_FRAME) {
+		step(frameLevel);
+		frameTime += BEAT_FRAME;
+		while(t - frameTime >= BEAT_FRAME) {
+			step(lastLevel);
+			frameTime += BEAT_FRAME;
+		}
+		frameLevel = level;
+	}
+	else if(level > frameLevel) {
+		frameLevel = level;
+	}
+
+	bool b = beat;
+	beat = false;
+	return b;
+}
+
+unsigned int BeatTracker::period(void) {
+	return (periodQ4 + 8) >> 4;
+}
+
+unsigned int BeatTracker::bpm(void) {
+	return periodQ4 ? (60000UL * 16 + periodQ4 / 2) / periodQ4 : 0;
+}
+
+unsigned char BeatTracker::confidence(void) {
+	return conf;
+}
+
+long BeatTracker::toBeat(unsigned long t) {
+	if(!periodQ4 || !locked) return 0;
+	// The phase at t, from the last frame
+	uint16_t at = beatPhase + (long)(t - phaseTime) * phaseStep / BEAT_FRAME;
+	return ((long)(int16_t)(beatAt - at) * periodQ4) >> 20;
+}
+
+// One frame, with its loudest level
+void BeatTracker::step(int level) {
+	// Onset: the rise, 4 for the mean of the rises
+	int rise = level - lastLevel;
+	lastLevel = level;
+	unsigned char onset = 0;
+	if(rise > 0) {
+		meanRise += ((rise << 4) - (int)meanRise) >> 5;
+		onset = min(((long)rise << 6) / (meanRise + 16), 15L);
+	}
+
+	// Autocorrelation, halved before it overflows
+	frame++;
+	onsets[frame & (BEAT_HISTORY - 1)] = onset;
+	if(onset) {
+		bool over = false;
+		for(unsigned char i = 0; i < BEAT_LAGS; i++) {
+			acf[i] += onset * onsets[(frame - (BEAT_LAG_MIN - 1) - i) & (BEAT_HISTORY - 1)];
+			if(acf[i] > 0xF000) over = true;
+		}
+		if(over) {
+			for(unsigned char i = 0; i < BEAT_LAGS; i++) acf[i] >>= 1;
+		}
+	}
+	if((frame & (BEAT_DECAY_FRAMES - 1)) == 0) {
+		for(unsigned char i = 0; i < BEAT_LAGS; i++) acf[i] -= acf[i] >> 2;
+		for(unsigned char i = 0; i < BEAT_BINS; i++) comb[i] -= comb[i] >> 2;
+		pick();
+	}
+
+	// Phase: the onsets, by the phase of the beat they fall at
+	if(!periodQ4) {
+		locked = false;
+		return;
+	}
+	uint16_t from = beatPhase - beatAt;
+	beatPhase += phaseStep;
+	phaseTime = frameTime + BEAT_FRAME / 2;
+	if(onset) {
+		comb[beatPhase >> 12] += onset << 1;
+		comb[((beatPhase >> 12) + 1) & (BEAT_BINS - 1)] += onset;
+		comb[((beatPhase >> 12) - 1) & (BEAT_BINS - 1)] += onset;
+		align();
+	}
+	if(locked && (uint16_t)(beatPhase - beatAt) < from) beat = true;
+}
+
+// The phase of the beats: the vertex of the parabola through the loudest bin
+void BeatTracker::align(void) {
+	unsigned char b = 0;
+	for(unsigned char i = 1; i < BEAT_BINS; i++) {
+		if(comb[i] > comb[b]) b = i;
+	}
+	long a = comb[(b - 1) & (BEAT_BINS - 1)], m = comb[b], c = comb[(b + 1) & (BEAT_BINS - 1)];
+	long den = a - 2 * m + c;
+	long shift = den < 0 ? (a - c) * 2048 / den : 0;
+	beatAt = ((uint16_t)b << 12) + (int)shift;
+	locked = m >= BEAT_ONSET_STRONG * 4;
+}
+
+// The tempo, from the autocorrelation
+void BeatTracker::pick(void) {
+	unsigned long best = 0, sum = 0;
+	unsigned char b = 1;
+	for(unsigned char i = 1; i < BEAT_LAGS - 1; i++) {
+		// The weight falls with the ratio to the preferred lag, as much
+		// for twice the lag as for half of it
+		int lag = BEAT_LAG_MIN - 1 + i;
+		int off = lag > BEAT_LAG_PREFERRED ? 256 - 256 * BEAT_LAG_PREFERRED / lag : 256 - 256 * lag / BEAT_LAG_PREFERRED;
+		unsigned long score = (unsigned long)acf[i] * (256 - off);
+		sum += score;
+		if(score > best) {
+			best = score;
+			b = i;
+		}
+	}
+	unsigned long mean = sum / (BEAT_LAGS - 2);
+	conf = best ? (best - mean) * 255 / best : 0;
+	if(conf < BEAT_CONFIDENCE_MIN || acf[b] < BEAT_ACF_MIN) {
+		periodQ4 = 0;
+		candidate = 0;
+		for(unsigned char i = 0; i < BEAT_BINS; i++) comb[i] = 0;
+		return;
+	}
+
+	// Between frames: the vertex of the parabola through the peak
+	long a = acf[b - 1], m = acf[b], c = acf[b + 1];
+	long den = a - 2 * m + c;
+	long shift = den < 0 ? (a - c) * 128 / den : 0;
+	unsigned char lag = BEAT_LAG_MIN - 1 + b;
+	unsigned int q = ((long)lag * 256 + shift) * BEAT_FRAME >> 4;
+
+	// Small changes are followed, a new tempo must win twice
+	long change = (long)q - periodQ4;
+	if(periodQ4 && change > -(2 * BEAT_FRAME << 4) && change < (2 * BEAT_FRAME << 4)) {
+		periodQ4 += change / 2;
+		candidate = 0;
+	}
+	else if(!periodQ4 || candidate == lag) {
+		periodQ4 = q;
+		candidate = 0;
+	}
+	else {
+		candidate = lag;
+	}
+	phaseStep = ((unsigned long)BEAT_FRAME << 20) / periodQ4;
+}
@@ -0,0 +1,112 @@
+/******************************************************************************
+* Zowi Beat Tracker Library
+*
+* Follows the beat of the music heard by the noise sensor. update() takes the
+* sound levels as they come (e.g. the noise windows of Zowi, every 8 ms) and
+* keeps the loudest of each BEAT_FRAME ms frame. Per frame:
+*
+*   - onset: the rise of the level since the last frame, relative to the
+*     mean of the rises, from 0 to 15 (4 = the mean)
+*   - tempo: the onsets are autocorrelated, with a leaky sum per lag, at the
+*     lags of BEAT_LAG_MIN to BEAT_LAG_MAX. The best lag, weighted towards
+*     BEAT_LAG_PREFERRED and refined between frames, is the beat period
+*   - phase: a running phase advances one turn per period, and the onsets
+*     are summed in BEAT_BINS bins by the phase they fall at, with the same
+*     decay. The loudest bin, refined between bins, is where the beats are
+*
+* A frame with onset costs BEAT_LAGS 8 bit multiplications, a frame without
+* none; the tempo is picked every BEAT_DECAY_FRAMES frames. All in integers.
+* tools/beatsim runs it on the host, on recordings or synthetic drums.
+*
+* @version 20261019
+*
+******************************************************************************/
+#ifndef __BEATTRACKER_H__
+#define __BEATTRACKER_H__
+
+#if defined(ARDUINO) && ARDUINO >= 100
+  #include "Arduino.h"
+#else
+  #include "WProgram.h"
+  #include "pins_arduino.h"
+#endif
+
+////////////////////////////
+// Definitions            //
+////////////////////////////
+#define BEAT_FRAME 16				// ms per frame
+#define BEAT_LAG_MIN 20				// Frames: 320 ms, 187 BPM
+#define BEAT_LAG_MAX 62				// Frames: 992 ms, 60 BPM
+#define BEAT_LAG_PREFERRED 31		// Frames: 496 ms, 121 BPM
+#define BEAT_LAGS (BEAT_LAG_MAX - BEAT_LAG_MIN + 3)	// One more on each side, to refine
+#define BEAT_HISTORY 64				// Onsets kept (power of 2, above BEAT_LAG_MAX)
+#define BEAT_DECAY_FRAMES 32		// Frames between decays of the autocorrelation (by 1/4)
+#define BEAT_BINS 16				// Phases of the beat the onsets are kept at
+#define BEAT_ONSET_STRONG 8			// Twice the mean onset: four of them in a bin give the phase
+#define BEAT_CONFIDENCE_MIN 96		// Below, there is no tempo (0 - 255)
+#define BEAT_ACF_MIN 32				// Nor below this autocorrelation (silence)
+#define BEAT_GAP_FRAMES 64			// Longer gaps in the levels start over the frames
+
+class BeatTracker
+{
+public:
+	////////////////////////////
+	// Functions              //
+	////////////////////////////
+	// BeatTracker -- BeatTracker class constructor
+	BeatTracker();
+
+	// begin -- forget the tempo and the phase
+	void begin(void);
+
+	// update -- a sound level at time t (ms). True when a beat has passed
+	bool update(unsigned long t, int level);
+
+	// period -- ms per beat, 0 when there is no tempo
+	unsigned int period(void);
+
+	// bpm -- beats per minute, 0 when there is no tempo
+	unsigned int bpm(void);
+
+	// confidence -- of the tempo, 0 - 255
+	unsigned char confidence(void);
+
+	// toBeat -- ms from t to the nearest beat (negative when it was before t),
+	// 0 when there is no tempo
+	long toBeat(unsigned long t);
+
+
+private:
+	////////////////////////////
+	// Variables              //
+	////////////////////////////
+	unsigned long frameTime;		// ms, start of the frame
+	int frameLevel;					// Loudest level of the frame, -1 = no level yet
+	int lastLevel;					// Of the last frame
+	unsigned int meanRise;			// Levels << 4
+	unsigned char onsets[BEAT_HISTORY];
+	unsigned char frame;			// Frames, modulo 256
+	unsigned int acf[BEAT_LAGS];	// Autocorrelation, from lag BEAT_LAG_MIN - 1
+	unsigned int periodQ4;			// ms << 4, 0 = no tempo
+	unsigned char candidate;		// Best lag of the last pick, when it is not the tempo
+	unsigned char conf;
+	unsigned int comb[BEAT_BINS];	// Onsets by the phase of the beat they fall at
+	uint16_t beatPhase;				// Of the last frame, 65536 = one beat
+	uint16_t phaseStep;				// Per frame
+	unsigned long phaseTime;		// ms, middle of the last frame
+	uint16_t beatAt;				// Phase of the beats
+	bool locked;					// The phase is known
+	bool beat;
+
+
+	////////////////////////////
+	// Functions              //
+	////////////////////////////
+	void step(int level);
+	void pick(void);
+	void align(void);
+
+
+};
+
+#endif // BEATTRACKER_H //
@@ -0,0 +1,69 @@
+//--------------------------------------------------------------
+//-- BeatTracker benchmark
+//-- Feeds the tracker a synthetic drum track (kick on the beats,
+//-- hi-hats on the eighths) as Zowi reads the noise sensor: a
+//-- level every 8 ms, on a simulated clock. Prints the cycles
+//-- per update, mean and worst, and when the tempo was found.
+//-- Then, with a microphone on A6, prints the tempo and the
+//-- beats of the music it hears.
+//--------------------------------------------------------------
+#include <BeatTracker.h>
+
+#define PIN_NoiseSensor A6
+#define BPM 120
+#define STEP 8          //-- ms between levels
+#define TEST_TIME 20000 //-- ms of simulated music
+
+BeatTracker tracker;
+
+//-- Sensor level of the drums at time t (ms)
+int drums(unsigned long t) {
+  unsigned int beat = 60000UL / BPM;
+  unsigned int k = t % beat, h = t % (beat / 2);
+  int level = 300 + random(20);
+  if (k < 100) level += 600 - 6 * k;
+  if (h < 30) level += 150 - 5 * h;
+  return min(level, 1023);
+}
+
+void setup() {
+  Serial.begin(115200);
+  randomSeed(1);
+
+  unsigned long busy = 0, worst = 0, found = 0, updates = 0;
+  for (unsigned long t = 0; t < TEST_TIME; t += STEP) {
+    int level = drums(t);
+    unsigned long start = micros();
+    tracker.update(t, level);
+    unsigned long us = micros() - start;
+    busy += us;
+    worst = max(worst, us);
+    updates++;
+    if (!found && tracker.bpm() == BPM) found = t;
+  }
+
+  Serial.print("Cycles per update: mean ");
+  Serial.print(busy * (F_CPU / 1000000L) / updates);
+  Serial.print(", worst ");
+  Serial.println(worst * (F_CPU / 1000000L));
+  Serial.print("Budget per update: ");
+  Serial.println(STEP * (F_CPU / 1000L));
+  Serial.print("Tempo ");
+  Serial.print(tracker.bpm());
+  Serial.print(" BPM, found after ");
+  Serial.print(found);
+  Serial.println(" ms");
+
+  tracker.begin();
+}
+
+void loop() {
+  static unsigned long last = 0;
+  if (millis() - last < STEP) return;
+  last = millis();
+  if (tracker.update(last, analogRead(PIN_NoiseSensor))) {
+    Serial.print("beat, ");
+    Serial.print(tracker.bpm());
+    Serial.println(" BPM");
+  }
+}
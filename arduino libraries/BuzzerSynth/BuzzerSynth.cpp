@@ -0,0 +1,450 @@
+/******************************************************************************
+* Zowi Buzzer Synthesizer Library
+*
+* @version 20261019
+*
+******************************************************************************/
+
+#include "BuzzerSynth.h"
+
+#if defined(ARDUINO) && ARDUINO >= 100
+  #include "Arduino.h"
+#else
+  #include "WProgram.h"
+#endif
+
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+////////////////////////////
+// Synthesizer state      //
+////////////////////////////
+// Shared with the interrupt, so it lives outside of the class instances.
+// The main context only touches it with interrupts disabled.
+struct SynthStep {
+	unsigned long inc;
+	long slope;
+	unsigned int duration;			// ms
+};
+
+struct SynthVoice {
+	unsigned int phase;
+	unsigned long inc;				// 16.16, the integer part is added to phase
+	long slope;						// Added to inc every sample
+	unsigned int remaining;			// ms left of the current note, 0 = idle
+	unsigned char duty;
+	unsigned char level;
+	unsigned char amp;				// level while sounding, 0 during rests
+	unsigned char head;
+	unsigned char count;
+	SynthStep queue[SYNTH_QUEUE];
+};
+
+static volatile uint8_t *synthPort;
+static uint8_t synthMask;
+
+static SynthVoice synthVoices[SYNTH_VOICES];
+static unsigned char synthError;	// Sigma-delta accumulator
+static unsigned char synthTick;		// Samples since the last control tick
+static volatile bool synthBusy;
+
+// Recorded sound being streamed
+static const unsigned char *pcmData;
+static unsigned int pcmLeft;			// Samples left, 0 = not playing
+static unsigned char pcmFormat;
+static unsigned char pcmTick;
+static unsigned char pcmValue;		// Current output sample (128 = silence)
+static unsigned char pcmNibble;		// ADPCM: byte holding the next code
+static int pcmPredictor;			// ADPCM decoder state
+static unsigned char pcmIndex;
+
+static const unsigned int adpcmSteps[89] PROGMEM = {
+	7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+	50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+	253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+	1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+	3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+	11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+	32767
+};
+
+static const signed char adpcmIndexes[8] PROGMEM = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+// Song being played by songVoice
+static const unsigned char *songData;
+static unsigned char songUnit;
+static unsigned char songVoice;
+
+// Phase increments of the eighth octave (C8 to B8) at SYNTH_RATE = 16000.
+// Lower octaves are obtained by halving, so every song note costs a lookup
+// and a shift
+static const unsigned long octaveIncs[12] PROGMEM = {
+	1123673247UL, 1190490335UL, 1261280574UL, 1336280220UL, 1415739577UL, 1499923833UL,
+	1589113945UL, 1683607578UL, 1783720094UL, 1889785610UL, 2002158110UL, 2121212627UL
+};
+
+
+// Start the next queued note of a voice, or leave it idle
+static void synthLoadNext(SynthVoice &s) {
+	if(s.count == 0 && songData && &s == &synthVoices[songVoice]) {
+		unsigned char note = pgm_read_byte(songData);
+		if(note != SONG_END) {
+			unsigned char octave = (note - 1) / 12;
+			s.inc = note == SONG_REST ? 0 : pgm_read_dword(&octaveIncs[(note - 1) - octave*12]) >> (8 - octave);
+			s.slope = 0;
+			s.remaining = pgm_read_byte(songData + 1) * songUnit;
+			s.amp = s.inc ? s.level : 0;
+			songData += 2;
+			if(s.remaining) return;
+		}
+		songData = 0;
+	}
+
+	if(s.count) {
+		SynthStep &n = s.queue[s.head];
+		s.inc = n.inc;
+		s.slope = n.slope;
+		s.remaining = n.duration;
+		s.amp = n.inc ? s.level : 0;
+		s.head = (s.head + 1) % SYNTH_QUEUE;
+		s.count--;
+	}
+	else {
+		s.inc = 0;
+		s.slope = 0;
+		s.amp = 0;
+	}
+}
+
+// Once per millisecond: note durations and sequencing
+static void synthControl(void) {
+	bool active = false;
+
+	for(uint8_t v = 0; v < SYNTH_VOICES; v++) {
+		SynthVoice &s = synthVoices[v];
+		if(s.remaining != SYNTH_FOREVER && s.remaining && --s.remaining == 0) synthLoadNext(s);
+		if(s.remaining) active = true;
+	}
+
+	if(!active) {
+		TIMSK2 &= ~_BV(OCIE2B);
+		*synthPort &= ~synthMask;
+	}
+}
+
+
+// Decode one IMA ADPCM code (4 bits) into the next 8 bit sample
+static unsigned char synthAdpcm(unsigned char code) {
+	unsigned int step = pgm_read_word(&adpcmSteps[pcmIndex]);
+	long diff = step >> 3;
+	if(code & 4) diff += step;
+	if(code & 2) diff += step >> 1;
+	if(code & 1) diff += step >> 2;
+
+	long predictor = pcmPredictor;
+	if(code & 8) predictor -= diff;
+	else predictor += diff;
+	if(predictor > 32767) predictor = 32767;
+	else if(predictor < -32768) predictor = -32768;
+	pcmPredictor = predictor;
+
+	signed char index = pcmIndex + (signed char)pgm_read_byte(&adpcmIndexes[code & 7]);
+	if(index < 0) index = 0;
+	else if(index > 88) index = 88;
+	pcmIndex = index;
+
+	return (pcmPredictor >> 8) + 128;
+}
+
+// Sample playback: one new sample every SYNTH_PCM_TICKS interrupts
+static void synthPcm(void) {
+	if(++pcmTick == SYNTH_PCM_TICKS) {
+		pcmTick = 0;
+		if(pcmFormat == SYNTH_PCM8) {
+			pcmValue = pgm_read_byte(pcmData++);
+		}
+		else if(pcmNibble & 1) {
+			pcmValue = synthAdpcm(pgm_read_byte(pcmData++) >> 4);
+			pcmNibble = 0;
+		}
+		else {
+			pcmValue = synthAdpcm(pgm_read_byte(pcmData) & 0x0F);
+			pcmNibble = 1;
+		}
+		if(--pcmLeft == 0) {
+			// Back to the voices
+			OCR2A = SYNTH_TOP;
+			OCR2B = SYNTH_TOP;
+			return;
+		}
+	}
+
+	unsigned int sum = pcmValue + synthError;
+	synthError = (unsigned char)sum;
+	if(sum & 0x100) *synthPort |= synthMask;
+	else *synthPort &= ~synthMask;
+}
+
+
+BuzzerSynth::BuzzerSynth() {
+}
+
+void BuzzerSynth::begin(char pin) {
+	pinMode(pin, OUTPUT);
+	digitalWrite(pin, LOW);
+	synthPort = portOutputRegister(digitalPinToPort(pin));
+	synthMask = digitalPinToBitMask(pin);
+
+	for(uint8_t v = 0; v < SYNTH_VOICES; v++) {
+		synthVoices[v].duty = 128;
+		synthVoices[v].level = 255;
+	}
+}
+
+void BuzzerSynth::playFine(unsigned long freq, unsigned long duration, char voice) {
+	if(duration == 0) duration = SYNTH_FOREVER;
+	else if(duration >= SYNTH_FOREVER) duration = SYNTH_FOREVER - 1;
+	push(voice, fineToIncrement(freq), 0, duration, true);
+}
+
+void BuzzerSynth::glideFine(unsigned long from, unsigned long to, unsigned long duration, char voice) {
+	sweep(voice, from, to, duration, true);
+}
+
+bool BuzzerSynth::noteFine(char voice, unsigned long freq, unsigned long duration) {
+	if(duration >= SYNTH_FOREVER) duration = SYNTH_FOREVER - 1;
+	return push(voice, fineToIncrement(freq), 0, duration, false);
+}
+
+bool BuzzerSynth::slideFine(char voice, unsigned long from, unsigned long to, unsigned long duration) {
+	return sweep(voice, from, to, duration, false);
+}
+
+bool BuzzerSynth::sweep(char voice, unsigned long from, unsigned long to, unsigned long duration, bool now) {
+	if(duration >= SYNTH_FOREVER) duration = SYNTH_FOREVER - 1;
+	unsigned long samples = duration * (SYNTH_RATE/1000);
+	unsigned long inc0 = fineToIncrement(from);
+	unsigned long inc1 = fineToIncrement(to);
+
+	if(samples == 0) return true;
+	// Increments are below 2^31 (Nyquist), so the difference fits in a long
+	return push(voice, inc0, ((long)inc1 - (long)inc0) / (long)samples, duration, now);
+}
+
+bool BuzzerSynth::chordFine(unsigned long duration, unsigned long f1, unsigned long f2, unsigned long f3) {
+	unsigned long freqs[3] = {f1, f2, f3};
+	uint8_t v;
+
+	for(v = 0; v < 3 && v < SYNTH_VOICES; v++) {
+		if(queueFree(v) == 0) return false;
+	}
+	for(v = 0; v < 3 && v < SYNTH_VOICES; v++) noteFine(v, freqs[v], duration);
+	return true;
+}
+
+void BuzzerSynth::setDuty(char voice, unsigned char duty) {
+	if(voice >= 0 && voice < SYNTH_VOICES) synthVoices[(uint8_t)voice].duty = duty;
+}
+
+void BuzzerSynth::setLevel(char voice, unsigned char level) {
+	if(voice < 0 || voice >= SYNTH_VOICES) return;
+	uint8_t oldSREG = SREG;
+	cli();
+	SynthVoice &s = synthVoices[(uint8_t)voice];
+	s.level = level;
+	if(s.amp) s.amp = level;
+	SREG = oldSREG;
+}
+
+void BuzzerSynth::playSample(const unsigned char *sample) {
+	unsigned int length = pgm_read_byte(sample + 1) | (pgm_read_byte(sample + 2) << 8);
+	if(length == 0) return;
+
+	uint8_t oldSREG = SREG;
+	cli();
+	pcmFormat = pgm_read_byte(sample);
+	pcmData = sample + SYNTH_SAMPLE_HEADER;
+	pcmLeft = length;
+	pcmTick = SYNTH_PCM_TICKS - 1;
+	pcmValue = 128;
+	pcmNibble = 0;
+	pcmPredictor = 0;
+	pcmIndex = 0;
+	SREG = oldSREG;
+
+	setTimer(SYNTH_PCM_TOP);
+}
+
+void BuzzerSynth::playSong(const unsigned char *song, char voice) {
+	if(voice < 0 || voice >= SYNTH_VOICES || pgm_read_byte(song) == 0) return;
+
+	uint8_t oldSREG = SREG;
+	cli();
+	SynthVoice &s = synthVoices[(uint8_t)voice];
+	s.count = 0;
+	s.remaining = 0;
+	songVoice = voice;
+	songUnit = pgm_read_byte(song);
+	songData = song + 1;
+	synthLoadNext(s);
+	SREG = oldSREG;
+
+	startTimer();
+}
+
+void BuzzerSynth::stopSample(void) {
+	uint8_t oldSREG = SREG;
+	cli();
+	if(pcmLeft) {
+		pcmLeft = 0;
+		OCR2A = SYNTH_TOP;
+		OCR2B = SYNTH_TOP;
+	}
+	SREG = oldSREG;
+}
+
+bool BuzzerSynth::isPlayingSample(void) {
+	uint8_t oldSREG = SREG;
+	cli();
+	bool playing = pcmLeft != 0;
+	SREG = oldSREG;
+	return playing;
+}
+
+void BuzzerSynth::stop(void) {
+	if(!synthPort) return;		// Before begin(): nothing plays
+
+	uint8_t oldSREG = SREG;
+	cli();
+	TIMSK2 &= ~_BV(OCIE2B);
+	pcmLeft = 0;
+	songData = 0;
+	for(uint8_t v = 0; v < SYNTH_VOICES; v++) {
+		synthVoices[v].count = 0;
+		synthVoices[v].remaining = 0;
+		synthLoadNext(synthVoices[v]);
+	}
+	*synthPort &= ~synthMask;
+	SREG = oldSREG;
+}
+
+bool BuzzerSynth::isPlaying(void) {
+	bool playing = false;
+	uint8_t oldSREG = SREG;
+	cli();
+	for(uint8_t v = 0; v < SYNTH_VOICES; v++) {
+		if(synthVoices[v].remaining || synthVoices[v].count) playing = true;
+	}
+	SREG = oldSREG;
+	return playing;
+}
+
+char BuzzerSynth::queueFree(char voice) {
+	if(voice < 0 || voice >= SYNTH_VOICES) return 0;
+	uint8_t oldSREG = SREG;
+	cli();
+	char slots = SYNTH_QUEUE - synthVoices[(uint8_t)voice].count;
+	SREG = oldSREG;
+	return slots;
+}
+
+// freq * 2^32 / (SYNTH_FINE * SYNTH_RATE), split in a whole and a fractional
+// part so that both products fit in 32 bits below Nyquist
+unsigned long BuzzerSynth::fineToIncrement(unsigned long freq) {
+	const unsigned long scale = 0x80000000UL / (SYNTH_FINE / 2);	// 2^32 / SYNTH_FINE
+	if(freq >= (unsigned long)SYNTH_FINE * (SYNTH_RATE/2)) return 0x7FFFFFFFUL;
+	return freq * (scale / SYNTH_RATE) + freq * (scale % SYNTH_RATE) / SYNTH_RATE;
+}
+
+// Queue a note on a voice. With now, the voice is cut and the queue emptied
+// first, so the note starts immediately. A zero duration queues nothing, and
+// SYNTH_FOREVER never ends: the callers clamp the other durations below it.
+bool BuzzerSynth::push(char voice, unsigned long inc, long slope, unsigned long duration, bool now) {
+	if(voice < 0 || voice >= SYNTH_VOICES) return false;
+
+	uint8_t oldSREG = SREG;
+	cli();
+	SynthVoice &s = synthVoices[(uint8_t)voice];
+	if(now && duration) {
+		s.count = 0;
+		s.remaining = 0;
+	}
+	if(duration == 0 || s.count == SYNTH_QUEUE) {
+		SREG = oldSREG;
+		return duration == 0;
+	}
+
+	SynthStep &n = s.queue[(s.head + s.count) % SYNTH_QUEUE];
+	n.inc = inc;
+	n.slope = slope;
+	n.duration = duration;
+	s.count++;
+	if(s.remaining == 0) synthLoadNext(s);
+	SREG = oldSREG;
+
+	startTimer();
+	return true;
+}
+
+void BuzzerSynth::startTimer(void) {
+	uint8_t oldSREG = SREG;
+	cli();
+	if(!(TIMSK2 & _BV(OCIE2B))) setTimer(pcmLeft ? SYNTH_PCM_TOP : SYNTH_TOP);
+	SREG = oldSREG;
+}
+
+void BuzzerSynth::setTimer(unsigned char top) {
+	if(!synthPort) return;		// The interrupt writes to the pin of begin()
+
+	uint8_t oldSREG = SREG;
+	cli();
+	// CTC mode with OCR2A as TOP. The COMPB vector is used so the library
+	// links together with tone(), which owns TIMER2_COMPA_vect
+	TCCR2A = _BV(WGM21);
+	TCCR2B = _BV(CS21);
+	OCR2A = top;
+	OCR2B = top;
+	TCNT2 = 0;
+	if(!(TIMSK2 & _BV(OCIE2B))) synthTick = 0;
+	TIFR2 = _BV(OCF2B);
+	TIMSK2 = _BV(OCIE2B);
+	SREG = oldSREG;
+}
+
+// Fixed per-sample cost: every voice is advanced and mixed whether it is
+// sounding or not. Interrupts are enabled so the servo timer is not delayed.
+ISR(TIMER2_COMPB_vect, ISR_NOBLOCK) {
+	if(synthBusy) return;
+	synthBusy = true;
+
+	if(pcmLeft) {
+		synthPcm();
+		synthBusy = false;
+		return;
+	}
+
+	unsigned int sum = 0;
+	for(uint8_t v = 0; v < SYNTH_VOICES; v++) {
+		SynthVoice &s = synthVoices[v];
+		s.phase += (unsigned int)(s.inc >> 16);
+		s.inc += s.slope;
+		if((unsigned char)(s.phase >> 8) < s.duty) sum += s.amp;
+	}
+
+	// First order sigma-delta: the carry is the output bit. A full scale
+	// mix is output as is, so a single voice is a clean pulse wave
+	if(sum < 255) {
+		sum += synthError;
+		synthError = (unsigned char)sum;
+		sum &= 0x100;
+	}
+	if(sum) *synthPort |= synthMask;
+	else *synthPort &= ~synthMask;
+
+	if(++synthTick == SYNTH_RATE/1000) {
+		synthTick = 0;
+		synthControl();
+	}
+
+	synthBusy = false;
+}
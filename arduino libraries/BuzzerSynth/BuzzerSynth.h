@@ -0,0 +1,167 @@
+/******************************************************************************
+* Zowi Buzzer Synthesizer Library
+*
+* Direct digital synthesis on the buzzer pin. A Timer2 interrupt runs
+* SYNTH_VOICES pulse wave voices at SYNTH_RATE, each one with a phase
+* accumulator and a per-sample increment slope (continuous glissandi). The
+* voices are mixed by weight and sent to the pin through a first order
+* sigma-delta modulator.
+*
+* Every voice has a small queue of notes, so chords and harmonies are
+* sequenced from the interrupt without the main loop. The per-sample work
+* does not depend on how many voices are sounding; once per millisecond the
+* note durations are updated. The interrupt runs with interrupts enabled so
+* the servo pulses are not delayed by it.
+*
+* Recorded sounds (8 bit PCM or 4 bit IMA ADPCM, see tools/wav2sample) are
+* streamed from PROGMEM by the same interrupt, which runs at SYNTH_PCM_TICKS
+* times the sample rate while a sample plays. The voices are paused meanwhile.
+*
+* Songs are packed note streams in PROGMEM (see tools/songc), played in the
+* background by one voice.
+*
+* Timer2 is shared with tone(): do not use both at the same time.
+*
+* Frequencies are fixed point, in 1/SYNTH_FINE Hz: SYNTH_FREQ(note_A5) is
+* converted by the compiler. The functions that take Hz as float are inline
+* wrappers, left out with ZOWI_NO_FLOAT (float-free profile of the Zowi
+* libraries).
+*
+* @version 20261019
+*
+******************************************************************************/
+#ifndef __BUZZERSYNTH_H__
+#define __BUZZERSYNTH_H__
+
+#if defined(ARDUINO) && ARDUINO >= 100
+  #include "Arduino.h"
+#else
+  #include "WProgram.h"
+  #include "pins_arduino.h"
+#endif
+
+////////////////////////////
+// Definitions            //
+////////////////////////////
+#define SYNTH_RATE 16000		// Samples per second (Timer2, prescaler 8)
+#define SYNTH_TOP (F_CPU/8/SYNTH_RATE - 1)
+#define SYNTH_VOICES 3
+#define SYNTH_QUEUE 4			// Queued notes per voice
+#define SYNTH_FOREVER 0xFFFF	// Notes that never end; longer ones are cut to 65534 ms
+#define SYNTH_FINE 16			// Fine frequencies: steps per Hz
+#define SYNTH_FREQ(hz) ((unsigned long)((hz) * (unsigned long)SYNTH_FINE))	// Hz, float or integer
+
+#define SYNTH_PCM_TOP 61		// 32258 Hz interrupt while a sample plays
+#define SYNTH_PCM_TICKS 4		// Interrupts per sample
+#define SYNTH_PCM_RATE (F_CPU/8/(SYNTH_PCM_TOP+1)/SYNTH_PCM_TICKS)	// 8064 Hz
+
+// Sample formats (first byte of a sample, followed by the 16 bit number of
+// samples, little endian, and a reserved byte)
+#define SYNTH_PCM8 0
+#define SYNTH_ADPCM4 1
+#define SYNTH_SAMPLE_HEADER 4
+
+// Songs: a byte with the duration unit in ms, then pairs of note and
+// duration (in units) bytes. Notes are 1 + the semitone index from C0
+// (note_C0 = 1 ... note_Eb8 = 100), SONG_REST is a silence
+#define SONG_REST 0
+#define SONG_END 0xFF
+
+
+class BuzzerSynth
+{
+public:
+	////////////////////////////
+	// Functions              //
+	////////////////////////////
+	// BuzzerSynth -- BuzzerSynth class constructor
+	BuzzerSynth();
+
+	// begin -- select the output pin and set up Timer2
+	void begin(char pin);
+
+	// playFine -- freq (1/SYNTH_FINE Hz) during duration ms (0 = until stop), now
+	void playFine(unsigned long freq, unsigned long duration = 0, char voice = 0);
+
+	// glideFine -- continuous sweep from one frequency to another in duration ms, now
+	void glideFine(unsigned long from, unsigned long to, unsigned long duration, char voice = 0);
+
+	// noteFine -- queue freq (0 = rest) on a voice. False if the queue is full
+	bool noteFine(char voice, unsigned long freq, unsigned long duration);
+
+	// slideFine -- queue a sweep on a voice. False if the queue is full
+	bool slideFine(char voice, unsigned long from, unsigned long to, unsigned long duration);
+
+	// chordFine -- queue one note on each of the first three voices
+	bool chordFine(unsigned long duration, unsigned long f1, unsigned long f2, unsigned long f3 = 0);
+
+#ifndef ZOWI_NO_FLOAT
+	// play, glide, note, slide, chord -- the same, in Hz
+	void play(float freq, unsigned long duration = 0, char voice = 0) {
+		playFine(SYNTH_FREQ(freq), duration, voice);
+	}
+	void glide(float from, float to, unsigned long duration, char voice = 0) {
+		glideFine(SYNTH_FREQ(from), SYNTH_FREQ(to), duration, voice);
+	}
+	bool note(char voice, float freq, unsigned long duration) {
+		return noteFine(voice, SYNTH_FREQ(freq), duration);
+	}
+	bool slide(char voice, float from, float to, unsigned long duration) {
+		return slideFine(voice, SYNTH_FREQ(from), SYNTH_FREQ(to), duration);
+	}
+	bool chord(unsigned long duration, float f1, float f2, float f3 = 0) {
+		return chordFine(duration, SYNTH_FREQ(f1), SYNTH_FREQ(f2), SYNTH_FREQ(f3));
+	}
+#endif
+
+	// setDuty -- pulse width of a voice, 128 = square wave
+	void setDuty(char voice, unsigned char duty);
+
+	// setLevel -- weight of a voice in the mix (the mix saturates at 255)
+	void setLevel(char voice, unsigned char level);
+
+	// playSample -- start streaming a recorded sound stored in PROGMEM
+	void playSample(const unsigned char *sample);
+
+	// stopSample -- cut the recorded sound and resume the voices
+	void stopSample(void);
+
+	// playSong -- start a packed song stored in PROGMEM on a voice
+	void playSong(const unsigned char *song, char voice = 0);
+
+	// stop -- silence every voice and empty the queues
+	void stop(void);
+
+	// isPlaying -- some voice is sounding or has queued notes
+	bool isPlaying(void);
+
+	// isPlayingSample
+	bool isPlayingSample(void);
+
+	// queueFree -- notes that can still be queued on a voice
+	char queueFree(char voice);
+
+	// fineToIncrement -- phase increment per sample for freq (1/SYNTH_FINE Hz)
+	static unsigned long fineToIncrement(unsigned long freq);
+
+#ifndef ZOWI_NO_FLOAT
+	// frequencyToIncrement -- phase increment per sample for freq Hz
+	static unsigned long frequencyToIncrement(float freq) {
+		return freq > 0 ? fineToIncrement(SYNTH_FREQ(freq)) : 0;
+	}
+#endif
+
+
+private:
+	////////////////////////////
+	// Functions              //
+	////////////////////////////
+	bool sweep(char voice, unsigned long from, unsigned long to, unsigned long duration, bool now);
+	bool push(char voice, unsigned long inc, long slope, unsigned long duration, bool now);
+	void startTimer(void);
+	void setTimer(unsigned char top);
+
+
+};
+
+#endif // BUZZERSYNTH_H //
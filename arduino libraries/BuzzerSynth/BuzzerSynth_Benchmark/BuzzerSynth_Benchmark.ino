@@ -0,0 +1,77 @@
+//--------------------------------------------------------------
+//-- BuzzerSynth benchmark
+//-- Measures the CPU taken by the synthesizer interrupt: a busy
+//-- loop is timed with the synth stopped and with every voice
+//-- playing, and the lost iterations are turned into cycles per
+//-- sample, for the voices and for sample playback. Also plays
+//-- a short chord progression.
+//--------------------------------------------------------------
+#include <BuzzerSynth.h>
+
+#define PIN_Buzzer 10
+#define TEST_TIME 2000
+
+BuzzerSynth synth;
+
+//-- One cycle of a 504 Hz sine, 8 bit PCM (header: format, length, 0)
+const unsigned char sine[] PROGMEM = {
+  SYNTH_PCM8, 16, 0, 0,
+  128, 177, 218, 246, 255, 246, 218, 177, 128, 79, 38, 10, 1, 10, 38, 79
+};
+
+//-- Busy loop iterations done in TEST_TIME ms. With pcm, the
+//-- sample is restarted as soon as it ends
+unsigned long spin(bool pcm) {
+  volatile unsigned long count = 0;
+  unsigned long start = millis();
+  while (millis() - start < TEST_TIME) {
+    if (pcm && !synth.isPlayingSample()) synth.playSample(sine);
+    count++;
+  }
+  return count;
+}
+
+void report(const char *name, unsigned long idle, unsigned long busy, long rate) {
+  //-- Fraction of the CPU used by the interrupt, in cycles per interrupt
+  float load = 1.0 - (float)busy / idle;
+  Serial.println(name);
+  Serial.print("  CPU load: ");
+  Serial.print(load * 100);
+  Serial.println(" %");
+  Serial.print("  Cycles per interrupt: ");
+  Serial.println(load * F_CPU / rate);
+  Serial.print("  Budget per interrupt: ");
+  Serial.println(F_CPU / rate);
+}
+
+void setup() {
+  Serial.begin(115200);
+  synth.begin(PIN_Buzzer);
+
+  unsigned long idle = spin(false);
+
+  synth.setLevel(0, 85);
+  synth.setLevel(1, 85);
+  synth.setLevel(2, 85);
+  synth.play(523.25, 0, 0);
+  synth.play(659.26, 0, 1);
+  synth.play(783.99, 0, 2);
+  unsigned long busy = spin(false);
+  synth.stop();
+  report("3 voices", idle, busy, SYNTH_RATE);
+
+  busy = spin(true);
+  synth.stop();
+  report("8 bit PCM", idle, busy, SYNTH_PCM_RATE * SYNTH_PCM_TICKS);
+
+  //-- C - F - G - C, queued in one go and played in the background
+  synth.chord(400, 523.25, 659.26, 783.99);
+  synth.chord(400, 698.46, 880.00, 1046.50);
+  synth.chord(400, 783.99, 987.77, 1174.66);
+  synth.chord(800, 1046.50, 1318.51, 1567.98);
+  while (synth.isPlaying()) Serial.print(".");
+  Serial.println();
+}
+
+void loop() {
+}
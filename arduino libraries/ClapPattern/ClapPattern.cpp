@@ -0,0 +1,129 @@
+/******************************************************************************
+* Zowi Clap Pattern Library
+*
+* @version 20261019
+*
+******************************************************************************/
+
+#include "ClapPattern.h"
+
+#if defined(ARDUINO) && ARDUINO >= 100
+  #include "Arduino.h"
+#else
+  #include "WProgram.h"
+#endif
+
+ClapPattern::ClapPattern() {
+	begin();
+}
+
+void ClapPattern::begin(void) {
+	for(int i = 0; i < CLAP_PATTERNS; i++) patterns[i].claps = 0;
+	last[0] = last[1] = -1;
+	deaf = 0;
+	count = 0;
+}
+
+bool ClapPattern::setPattern(const char *rhythm, unsigned char command) {
+	// x per clap, - before a long gap
+	Pattern p = {0, 0, command};
+	bool gap = false;
+	for(const char *c = rhythm; *c; c++) {
+		if(*c == 'x') {
+			if(p.claps == CLAP_MAX) return false;
+			if(gap) p.longs |= _BV(p.claps - 1);
+			p.claps++;
+			gap = false;
+		}
+		else if(*c == '-' && p.claps && !gap) {
+			gap = true;
+		}
+		else {
+			return false;
+		}
+	}
+	if(p.claps < 2 || gap) return false;
+
+	// Every gap long is every gap the same: heard as all short
+	if(p.longs == (unsigned char)(_BV(p.claps - 1) - 1)) p.longs = 0;
+
+	// In the place of the same rhythm, or in a free one
+	int free = -1;
+	for(int i = 0; i < CLAP_PATTERNS; i++) {
+		if(patterns[i].claps == p.claps && patterns[i].longs == p.longs) {
+			if(command) patterns[i] = p;
+			else patterns[i].claps = 0;
+			return true;
+		}
+		if(!patterns[i].claps && free < 0) free = i;
+	}
+	if(!command) return true;
+	if(free < 0) return false;
+	patterns[free] = p;
+	return true;
+}
+
+unsigned char ClapPattern::update(unsigned long t, int level) {
+	// The rhythm ends after a silence of CLAP_END times its longest gap
+	unsigned char command = 0;
+	unsigned long end = count > 1 ? min((unsigned long)CLAP_END * longest, (unsigned long)CLAP_GAP_MAX) : CLAP_GAP_MAX;
+	if(count && t - lastClap > end) {
+		command = match();
+		count = 0;
+	}
+
+	// A clap is a jump of the level from one of the last two
+	if(last[1] >= 0 && level - min(last[0], last[1]) >= CLAP_LEVEL && (long)(t - deaf) >= 0 &&
+	   (!count || t - lastClap >= CLAP_REFRACTORY)) clap(t);
+	last[1] = last[0];
+	last[0] = level;
+	return command;
+}
+
+unsigned char ClapPattern::claps(void) {
+	return count > CLAP_MAX ? CLAP_MAX : count;
+}
+
+void ClapPattern::ignore(unsigned long t) {
+	deaf = t;
+}
+
+// One clap at time t
+void ClapPattern::clap(unsigned long t) {
+	if(count) {
+		unsigned int gap = t - lastClap;
+		if(count < CLAP_MAX) {
+			gaps[count - 1] = gap;
+			if(gap > longest) longest = gap;
+		}
+		if(count <= CLAP_MAX) count++;
+	}
+	else {
+		count = 1;
+		longest = 0;
+	}
+	lastClap = t;
+}
+
+// The command of the rhythm heard, 0 for none
+unsigned char ClapPattern::match(void) {
+	if(count < 2 || count > CLAP_MAX) return 0;
+
+	unsigned int shortest = gaps[0];
+	for(unsigned char i = 1; i < count - 1; i++) {
+		if(gaps[i] < shortest) shortest = gaps[i];
+	}
+
+	// Short or long, against the shortest gap
+	unsigned char longs = 0;
+	for(unsigned char i = 0; i < count - 1; i++) {
+		unsigned long g = (unsigned long)gaps[i] * 16;
+		if(g >= (unsigned long)shortest * CLAP_LONG) longs |= _BV(i);
+		else if(g > (unsigned long)shortest * CLAP_SHORT) return 0;
+	}
+
+	for(unsigned char i = 0; i < CLAP_PATTERNS; i++) {
+		if(patterns[i].claps == count && patterns[i].longs == longs) return patterns[i].command;
+	}
+	return 0;
+}
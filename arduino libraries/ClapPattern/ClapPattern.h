@@ -0,0 +1,104 @@
+/******************************************************************************
+* Zowi Clap Pattern Library
+*
+* Recognises rhythms of claps in the noise levels, e.g. two claps, three
+* claps, or a long gap and then a short one, and returns the command the
+* sketch gave to each rhythm. update() takes the levels as they come (e.g.
+* the noise windows of Zowi, servo noise removed, every 8 ms):
+*
+*   - clap: the level jumps CLAP_LEVEL above one of the last two levels,
+*     CLAP_REFRACTORY ms after the last clap. The slow changes of the noise
+*     (e.g. the servos of a gait) are not claps
+*   - rhythm: the claps one after another with gaps up to CLAP_GAP_MAX. It
+*     ends after a silence of CLAP_END times its longest gap (CLAP_GAP_MAX
+*     at most). Each gap is short or long against the shortest one: up to
+*     CLAP_SHORT or from CLAP_LONG sixteenths of it, so the rhythm can be
+*     clapped faster or slower. A gap in between matches no rhythm
+*
+* Rhythms are written with an x per clap and a - before a long gap: "xx",
+* "xxx", "x-xx" (long, short). The gaps are long only next to short ones:
+* "x-x" is "xx", and "x-x-x" is "xxx". The cost per level is fixed, and a
+* few more comparisons (CLAP_MAX + CLAP_PATTERNS) when a rhythm ends. All
+* in integers.
+* tools/clapsim runs it on the host, on lists of clap times.
+*
+* @version 20261019
+*
+******************************************************************************/
+#ifndef __CLAPPATTERN_H__
+#define __CLAPPATTERN_H__
+
+#if defined(ARDUINO) && ARDUINO >= 100
+  #include "Arduino.h"
+#else
+  #include "WProgram.h"
+  #include "pins_arduino.h"
+#endif
+
+////////////////////////////
+// Definitions            //
+////////////////////////////
+#define CLAP_PATTERNS 4				// Rhythms with a command
+#define CLAP_MAX 6					// Claps of a rhythm
+#define CLAP_LEVEL 200				// Jump of the level (0 - 1023)
+#define CLAP_REFRACTORY 80			// ms, the echoes of a clap are not claps
+#define CLAP_GAP_MAX 1000			// ms, a longer gap starts another rhythm
+#define CLAP_END 3					// Longest gaps of silence that end a rhythm
+#define CLAP_SHORT 24				// Sixteenths of the shortest gap: 1.5 times
+#define CLAP_LONG 28				// 1.75 times
+
+class ClapPattern
+{
+public:
+	////////////////////////////
+	// Functions              //
+	////////////////////////////
+	// ClapPattern -- ClapPattern class constructor
+	ClapPattern();
+
+	// begin -- forget the rhythms and the claps heard
+	void begin(void);
+
+	// setPattern -- the command (1 - 255) of a rhythm, 0 to remove it. False
+	// when the rhythm is not valid or there is no place for it
+	bool setPattern(const char *rhythm, unsigned char command);
+
+	// update -- a sound level at time t (ms). The command of the rhythm that
+	// has just ended, 0 for none
+	unsigned char update(unsigned long t, int level);
+
+	// claps -- in the rhythm being heard
+	unsigned char claps(void);
+
+	// ignore -- no claps up to time t (ms), e.g. while a loud noise starts
+	void ignore(unsigned long t);
+
+
+private:
+	////////////////////////////
+	// Variables              //
+	////////////////////////////
+	struct Pattern {
+		unsigned char claps;		// 0 = free place
+		unsigned char longs;		// A bit per gap, set when it is long
+		unsigned char command;
+	};
+	Pattern patterns[CLAP_PATTERNS];
+	int last[2];					// Levels, -1 = no level yet
+	unsigned char count;			// Claps, CLAP_MAX + 1 = too many
+	unsigned long lastClap;			// ms
+	unsigned long deaf;				// ms, no claps until then
+	unsigned int gaps[CLAP_MAX - 1];	// ms
+	unsigned int longest;
+
+
+	////////////////////////////
+	// Functions              //
+	////////////////////////////
+	void clap(unsigned long t);
+	unsigned char match(void);
+
+
+};
+
+#endif // CLAPPATTERN_H //
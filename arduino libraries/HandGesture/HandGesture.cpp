@@ -0,0 +1,118 @@
+/******************************************************************************
+* Zowi Hand Gesture Library
+*
+* @version 20261019
+*
+******************************************************************************/
+
+#include "HandGesture.h"
+
+#if defined(ARDUINO) && ARDUINO >= 100
+  #include "Arduino.h"
+#else
+  #include "WProgram.h"
+#endif
+
+HandGesture::HandGesture() {
+	begin();
+}
+
+void HandGesture::begin(void) {
+	empty = false;
+	tracking = false;
+	lost = 0;
+	background = 0;
+}
+
+unsigned char HandGesture::update(unsigned long t, unsigned int reading) {
+	if(!reading || reading > HAND_RANGE) {
+		if(lost < HAND_LOST) lost++;
+		if(!tracking) {
+			if(lost == HAND_LOST) empty = true;
+			return HAND_NONE;
+		}
+		if(lost < HAND_LOST) return HAND_NONE;
+
+		// The track ends: quickly through the beam is a swipe
+		tracking = false;
+		if(!came) background = cm;
+		if(came && !done && seen >= HAND_SWIPE_READINGS && seenTime - enterTime <= HAND_SWIPE_TIME)
+			return HAND_SWIPE;
+		return HAND_NONE;
+	}
+
+	lost = 0;
+	seenTime = t;
+	if(!tracking) {
+		// What was in range at the first reading, back after a few
+		// missing echoes, did not come
+		tracking = true;
+		came = empty && !near(reading, background);
+		done = held = false;
+		moving = HAND_NONE;
+		seen = 1;
+		enterTime = t;
+		raw[0] = raw[1] = cm = reading;
+		anchor(t);
+		return HAND_NONE;
+	}
+	if(seen == 1 && !near(reading, cm)) {
+		// The first reading was a stray echo: the track starts here
+		came = came && !near(reading, background);
+		enterTime = t;
+		raw[0] = raw[1] = cm = reading;
+		anchor(t);
+		return HAND_NONE;
+	}
+	if(seen < 255) seen++;
+
+	// Median of the last three readings: a stray echo is dropped
+	unsigned int a = raw[0], b = raw[1];
+	raw[1] = a;
+	raw[0] = reading;
+	if(a > b) { unsigned int c = a; a = b; b = c; }
+	cm = reading < a ? a : reading > b ? b : reading;
+
+	// The farthest and nearest of the last HAND_MOVE_TIME
+	if(cm >= farthest || t - farTime > HAND_MOVE_TIME) { farthest = cm; farTime = t; }
+	if(cm <= nearest || t - nearTime > HAND_MOVE_TIME) { nearest = cm; nearTime = t; }
+	if(farthest - cm >= HAND_MOVE || cm - nearest >= HAND_MOVE) {
+		unsigned char gesture = cm < farthest ? HAND_APPROACH : HAND_RETREAT;
+		anchor(t);
+		if(gesture == moving) return HAND_NONE;
+		moving = gesture;
+		done = true;
+		held = false;
+		return gesture;
+	}
+
+	// Still: the move is over, and a hold, once
+	if(cm > still + HAND_STILL || cm + HAND_STILL < still) {
+		still = cm;
+		stillTime = t;
+		held = false;
+	}
+	else if(t - stillTime >= HAND_PAUSE) {
+		moving = HAND_NONE;
+	}
+	if(came && !held && t - stillTime >= HAND_HOLD_TIME) {
+		done = held = true;
+		return HAND_HOLD;
+	}
+	return HAND_NONE;
+}
+
+unsigned int HandGesture::distance(void) {
+	return tracking ? cm : 0;
+}
+
+// Within HAND_MOVE of a distance (0 = none)
+bool HandGesture::near(unsigned int reading, unsigned int cm) {
+	return cm && reading <= cm + HAND_MOVE && reading + HAND_MOVE >= cm;
+}
+
+// The moves and the hold start again from the distance now
+void HandGesture::anchor(unsigned long t) {
+	farthest = nearest = still = cm;
+	farTime = nearTime = stillTime = t;
+}
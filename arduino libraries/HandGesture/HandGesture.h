@@ -0,0 +1,107 @@
+/******************************************************************************
+* Zowi Hand Gesture Library
+*
+* Recognises the motions of a hand in front of the ultrasonic sensor. update()
+* takes the distances as they come (e.g. the non-blocking readings of Zowi,
+* every SENSE_PING_PERIOD ms) and follows what is within HAND_RANGE:
+*
+*   - approach / retreat: the distance (median of the last three readings)
+*     falls / rises HAND_MOVE from the farthest / nearest one of the last
+*     HAND_MOVE_TIME ms. Slow drifts are not moves. A long move is one
+*     gesture: the next one of the same way comes after a pause of
+*     HAND_PAUSE ms
+*   - hold: the distance stays within HAND_STILL for HAND_HOLD_TIME, once
+*     per hold
+*   - swipe: a hand that comes into range and leaves it within
+*     HAND_SWIPE_TIME with no other gesture, seen in HAND_SWIPE_READINGS
+*     readings at least. A single stray echo is not a swipe
+*
+* A hand leaves the range after HAND_LOST readings out of it, so that a
+* missing echo does not end the track. What is in range before the range
+* has been seen empty (e.g. a wall) is not a hand that came, nor is it when
+* it is back after a few missing echoes: it can approach or retreat, but it
+* does not hold or swipe. The cost per reading is fixed: a few comparisons,
+* no loops. All in integers.
+*
+* @version 20261019
+*
+******************************************************************************/
+#ifndef __HANDGESTURE_H__
+#define __HANDGESTURE_H__
+
+#if defined(ARDUINO) && ARDUINO >= 100
+  #include "Arduino.h"
+#else
+  #include "WProgram.h"
+  #include "pins_arduino.h"
+#endif
+
+////////////////////////////
+// Definitions            //
+////////////////////////////
+#define HAND_NONE 0
+#define HAND_APPROACH 1
+#define HAND_RETREAT 2
+#define HAND_HOLD 3
+#define HAND_SWIPE 4
+
+#define HAND_RANGE 50				// cm, farther is no hand
+#define HAND_MOVE 8					// cm, of an approach or a retreat
+#define HAND_MOVE_TIME 800			// ms, the move takes less
+#define HAND_PAUSE 300				// ms still, that end a move
+#define HAND_STILL 3				// cm, a hand that holds moves less
+#define HAND_HOLD_TIME 1000			// ms
+#define HAND_SWIPE_TIME 350			// ms in range, at most
+#define HAND_SWIPE_READINGS 2
+#define HAND_LOST 3					// Readings out of range that end the track
+
+class HandGesture
+{
+public:
+	////////////////////////////
+	// Functions              //
+	////////////////////////////
+	// HandGesture -- HandGesture class constructor
+	HandGesture();
+
+	// begin -- forget the hand. What is in range before HAND_LOST readings
+	// out of it is not a hand that came
+	void begin(void);
+
+	// update -- a reading (cm, 0 or above HAND_RANGE when there is no echo)
+	// at time t (ms). The gesture that has just been made, HAND_NONE for none
+	unsigned char update(unsigned long t, unsigned int reading);
+
+	// distance -- of the hand (cm, filtered), 0 when there is none
+	unsigned int distance(void);
+
+
+private:
+	////////////////////////////
+	// Variables              //
+	////////////////////////////
+	bool empty;						// The range has been empty since begin()
+	bool tracking;					// Something in range
+	bool came;						// It came into range
+	bool done;						// A gesture in this track
+	bool held;						// The hold has been told
+	unsigned char moving;			// HAND_APPROACH / HAND_RETREAT being made
+	unsigned char lost;				// Readings out of range
+	unsigned char seen;				// Readings in range
+	unsigned int raw[2];			// cm, the last two readings
+	unsigned int cm;				// Median of three
+	unsigned int farthest, nearest, still;	// cm
+	unsigned int background;		// cm, of what was in range before it was empty
+	unsigned long farTime, nearTime, stillTime, enterTime, seenTime;	// ms
+
+
+	////////////////////////////
+	// Functions              //
+	////////////////////////////
+	bool near(unsigned int reading, unsigned int cm);
+	void anchor(unsigned long t);
+
+
+};
+
+#endif // HANDGESTURE_H //
@@ -0,0 +1,72 @@
+//--------------------------------------------------------------
+//-- HandGesture example
+//-- First times the recogniser on a simulated hand (a swipe, an
+//-- approach and a hold, one reading every 60 ms) and prints the
+//-- cycles per update, mean and worst, and the gestures found.
+//-- Then pings the ultrasonic sensor without waiting for the
+//-- echoes and prints the gestures of a hand in front of it.
+//--------------------------------------------------------------
+#include <US.h>
+#include <HandGesture.h>
+
+#define PIN_Trigger 8
+#define PIN_Echo 9
+#define STEP 60         //-- ms between pings, as SENSE_PING_PERIOD
+
+US us;
+HandGesture hand;
+
+const char *names[] = {"none", "approach", "retreat", "hold", "swipe"};
+
+//-- Distance of the simulated hand at time t (ms), US_NO_ECHO for none
+unsigned int simulated(unsigned long t) {
+  if (t < 1000) return US_NO_ECHO;
+  if (t < 1200) return 20;                      //-- Swipe
+  if (t < 2000) return US_NO_ECHO;
+  if (t < 2800) return 45 - (t - 2000) / 25;    //-- Approach, 40 cm/s
+  if (t < 4500) return 13 + random(2);          //-- Hold
+  return US_NO_ECHO;
+}
+
+void setup() {
+  Serial.begin(115200);
+  us.init(PIN_Trigger, PIN_Echo);
+  randomSeed(1);
+
+  unsigned long busy = 0, worst = 0, updates = 0;
+  for (unsigned long t = 0; t < 5000; t += STEP) {
+    unsigned int cm = simulated(t);
+    unsigned long start = micros();
+    unsigned char gesture = hand.update(t, cm);
+    unsigned long spent = micros() - start;
+    busy += spent;
+    worst = max(worst, spent);
+    updates++;
+    if (gesture) {
+      Serial.print(t);
+      Serial.print(" ms: ");
+      Serial.println(names[gesture]);
+    }
+  }
+
+  Serial.print("Cycles per update: mean ");
+  Serial.print(busy * (F_CPU / 1000000L) / updates);
+  Serial.print(", worst ");
+  Serial.println(worst * (F_CPU / 1000000L));
+
+  hand.begin();
+}
+
+void loop() {
+  static unsigned long last = 0;
+  if (us.update()) {
+    unsigned char gesture = hand.update(last, us.cm());
+    if (gesture) {
+      Serial.print(names[gesture]);
+      Serial.print(", ");
+      Serial.print(hand.distance());
+      Serial.println(" cm");
+    }
+  }
+  if (millis() - last >= STEP && us.ping()) last = millis();
+}
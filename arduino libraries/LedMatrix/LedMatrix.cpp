@@ -61,6 +61,98 @@ void LedMatrix::setEntireMatrix(void) {
 	sendMemory();
 }
 
+void LedMatrix::writeMasked(unsigned long value, unsigned long mask) {
+	memory = blit(memory, value, mask);
+	sendMemory();
+}
+
+// Leds of every row that survive a shift of n columns. Column 1 is the MSB
+// of the row, so a left shift clears the n low bits of each row.
+static unsigned long keepLowColumns(char n) {
+	return ((0x3FUL << n) & 0x3FUL) * ROW_REPEAT;
+}
+
+static unsigned long keepHighColumns(char n) {
+	return ((0x3FUL >> n)) * ROW_REPEAT;
+}
+
+unsigned long LedMatrix::shiftLeft(unsigned long frame, char n) {
+	return (frame << n) & keepLowColumns(n);
+}
+
+unsigned long LedMatrix::shiftRight(unsigned long frame, char n) {
+	return (frame >> n) & keepHighColumns(n);
+}
+
+unsigned long LedMatrix::shiftUp(unsigned long frame, char n) {
+	return (frame << (n*COLUMNS)) & MATRIX_MASK;
+}
+
+unsigned long LedMatrix::shiftDown(unsigned long frame, char n) {
+	return (frame & MATRIX_MASK) >> (n*COLUMNS);
+}
+
+unsigned long LedMatrix::rollLeft(unsigned long frame, char n) {
+	n = ((n % COLUMNS) + COLUMNS) % COLUMNS;
+	return shiftLeft(frame, n) | shiftRight(frame, COLUMNS - n);
+}
+
+unsigned long LedMatrix::rollRight(unsigned long frame, char n) {
+	n = ((n % COLUMNS) + COLUMNS) % COLUMNS;
+	return shiftRight(frame, n) | shiftLeft(frame, COLUMNS - n);
+}
+
+unsigned long LedMatrix::rollUp(unsigned long frame, char n) {
+	n = ((n % ROWS) + ROWS) % ROWS;
+	return shiftUp(frame, n) | shiftDown(frame, ROWS - n);
+}
+
+unsigned long LedMatrix::rollDown(unsigned long frame, char n) {
+	n = ((n % ROWS) + ROWS) % ROWS;
+	return shiftDown(frame, n) | shiftUp(frame, ROWS - n);
+}
+
+unsigned long LedMatrix::mirror(unsigned long frame) {
+	// Reverse the 6 bits of every row at once: swap the bits of each pair,
+	// then swap the first and last pair (the middle one stays in place)
+	frame = ((frame >> 1) & 0x15555555UL) | ((frame & 0x15555555UL) << 1);
+	return ((frame & 0x030C30C3UL) << 4) | ((frame >> 4) & 0x030C30C3UL) | (frame & 0x0C30C30CUL);
+}
+
+unsigned long LedMatrix::flip(unsigned long frame) {
+	return ((frame & 0x0000003FUL) << 24) | ((frame & 0x00000FC0UL) << 12) | (frame & 0x0003F000UL)
+	     | ((frame >> 12) & 0x00000FC0UL) | ((frame >> 24) & 0x0000003FUL);
+}
+
+unsigned long LedMatrix::invert(unsigned long frame) {
+	return ~frame & MATRIX_MASK;
+}
+
+unsigned long LedMatrix::layerAnd(unsigned long bottom, unsigned long top) {
+	return bottom & top;
+}
+
+unsigned long LedMatrix::layerOr(unsigned long bottom, unsigned long top) {
+	return bottom | top;
+}
+
+unsigned long LedMatrix::layerXor(unsigned long bottom, unsigned long top) {
+	return bottom ^ top;
+}
+
+unsigned long LedMatrix::blit(unsigned long bottom, unsigned long top, unsigned long mask) {
+	// Equivalent to (bottom & ~mask) | (top & mask) with one operation less
+	return bottom ^ ((bottom ^ top) & mask);
+}
+
+unsigned long LedMatrix::rowMask(char row) {
+	return (0x3FUL << (MATRIX_LENGTH - row*COLUMNS)) & MATRIX_MASK;
+}
+
+unsigned long LedMatrix::columnMask(char column) {
+	return (1UL << (COLUMNS - column)) * ROW_REPEAT;
+}
+
 void LedMatrix::sendMemory(void) {
 	int i;
 	
@@ -22,6 +22,8 @@
 #define ROWS 5
 #define COLUMNS 6
 #define MATRIX_LENGTH ROWS*COLUMNS
+#define MATRIX_MASK 0x3FFFFFFFUL	// All the 30 leds of a frame
+#define ROW_REPEAT 0x01041041UL		// Multiplier that copies a 6 bit row pattern into the 5 rows
 
 
 
@@ -64,6 +66,52 @@ public:
 	
 	// setEntireMatrix
 	void setEntireMatrix(void);
+	
+	// writeMasked -- blit value over the leds selected by mask
+	void writeMasked(unsigned long value, unsigned long mask);
+	
+	////////////////////////////
+	// Frame compositing      //
+	////////////////////////////
+	// Frames are packed as in writeFull: row 1 in bits 29..24 (column 1 is
+	// the MSB of each row) down to row 5 in bits 5..0. These functions only
+	// use shifts and masks, they do not touch the matrix.
+	
+	// shiftLeft / shiftRight -- move n columns, emptied columns are cleared
+	static unsigned long shiftLeft(unsigned long frame, char n);
+	static unsigned long shiftRight(unsigned long frame, char n);
+	
+	// shiftUp / shiftDown -- move n rows, emptied rows are cleared
+	static unsigned long shiftUp(unsigned long frame, char n);
+	static unsigned long shiftDown(unsigned long frame, char n);
+	
+	// rollLeft / rollRight / rollUp / rollDown -- as shift, wrapping around.
+	// A negative n rolls the other way
+	static unsigned long rollLeft(unsigned long frame, char n);
+	static unsigned long rollRight(unsigned long frame, char n);
+	static unsigned long rollUp(unsigned long frame, char n);
+	static unsigned long rollDown(unsigned long frame, char n);
+	
+	// mirror -- swap columns left to right
+	static unsigned long mirror(unsigned long frame);
+	
+	// flip -- swap rows top to bottom
+	static unsigned long flip(unsigned long frame);
+	
+	// invert -- turn on the leds that are off and vice versa
+	static unsigned long invert(unsigned long frame);
+	
+	// layerAnd / layerOr / layerXor -- combine two frames
+	static unsigned long layerAnd(unsigned long bottom, unsigned long top);
+	static unsigned long layerOr(unsigned long bottom, unsigned long top);
+	static unsigned long layerXor(unsigned long bottom, unsigned long top);
+	
+	// blit -- copy top over bottom only where mask is set
+	static unsigned long blit(unsigned long bottom, unsigned long top, unsigned long mask);
+	
+	// rowMask / columnMask -- frame with an entire row/column set (1 based)
+	static unsigned long rowMask(char row);
+	static unsigned long columnMask(char column);
 
 
 
@@ -0,0 +1,42 @@
+#include <LedMatrix.h>
+
+#define smile_code      0b00000000100001010010001100000000
+#define eyes_code       0b00010010000000000000000000000000
+
+LedMatrix ledmatrix(11, 13, 12);
+
+void setup() {
+}
+
+void loop() {
+  unsigned long frame;
+  int i;
+
+  // Blinking eyes layered over a mouth: only the first row is replaced
+  for(i = 0; i < 4; i++) {
+    ledmatrix.writeFull(LedMatrix::layerOr(smile_code, eyes_code));
+    delay(600);
+    ledmatrix.writeMasked(0, LedMatrix::rowMask(1));
+    delay(150);
+  }
+
+  // Mouth sliding around the matrix
+  frame = smile_code;
+  for(i = 0; i < 12; i++) {
+    frame = LedMatrix::rollRight(frame, 1);
+    ledmatrix.writeFull(frame);
+    delay(100);
+  }
+
+  // Procedural wave: a diagonal rolled to the right, mirrored every pass
+  frame = 0b00100000010000001000000100000010;
+  for(i = 0; i < 24; i++) {
+    frame = LedMatrix::rollRight(frame, 1);
+    ledmatrix.writeFull((i / COLUMNS) & 1 ? LedMatrix::mirror(frame) : frame);
+    delay(80);
+  }
+
+  // Negative of a mouth
+  ledmatrix.writeFull(LedMatrix::invert(smile_code));
+  delay(1000);
+}
@@ -0,0 +1,99 @@
+/******************************************************************************
+* Zowi Noise Model Library
+*
+* @version 20261019
+*
+******************************************************************************/
+
+#include "NoiseModel.h"
+
+#if defined(ARDUINO) && ARDUINO >= 100
+  #include "Arduino.h"
+#else
+  #include "WProgram.h"
+#endif
+
+NoiseModel::NoiseModel() {
+	begin();
+}
+
+void NoiseModel::begin(void) {
+	for(int i = 0; i < NOISE_STATES; i++) {
+		age[i] = 0;
+		learnt[i] = 0;
+	}
+	rest = 0;
+	restDev = 0;
+}
+
+int NoiseModel::update(unsigned int key, unsigned char phase, int level) {
+	if(key == NOISE_REST) {
+		if(!rest) rest = level << 4;
+		learn(rest, restDev, level);
+		return 0;
+	}
+
+	int s = find(key);
+	if(s < 0) {
+		// In a free place, or in the place of the state heard least recently
+		s = 0;
+		for(int i = 1; i < NOISE_STATES; i++) {
+			if(!learnt[s]) break;
+			if(!learnt[i] || age[i] > age[s]) s = i;
+		}
+		keys[s] = key;
+		learnt[s] = 0;
+	}
+	for(int i = 0; i < NOISE_STATES; i++) {
+		if(age[i] < 0xFF) age[i]++;
+	}
+	age[s] = 0;
+
+	unsigned char bin = phase / (256 / NOISE_BINS);
+	int expect = 0;
+	if(learnt[s] & _BV(bin)) {
+		expect = top(floors[s][bin], devs[s][bin]);
+	}
+	else {
+		floors[s][bin] = level << 4;
+		devs[s][bin] = 0;
+		learnt[s] |= _BV(bin);
+	}
+	learn(floors[s][bin], devs[s][bin], level);
+	return expect;
+}
+
+int NoiseModel::expected(unsigned int key, unsigned char phase) {
+	int s = find(key);
+	unsigned char bin = phase / (256 / NOISE_BINS);
+	if(s < 0 || !(learnt[s] & _BV(bin))) return 0;
+	return top(floors[s][bin], devs[s][bin]);
+}
+
+int NoiseModel::restFloor(void) {
+	return (rest + 8) >> 4;
+}
+
+int NoiseModel::find(unsigned int key) {
+	for(int i = 0; i < NOISE_STATES; i++) {
+		if(learnt[i] && keys[i] == key) return i;
+	}
+	return -1;
+}
+
+// Floor plus the margin, above the rest floor
+int NoiseModel::top(unsigned int floor, unsigned int dev) {
+	long noise = ((long)floor + NOISE_MARGIN * dev - rest + 8) >> 4;
+	return noise > 0 ? noise : 0;
+}
+
+void NoiseModel::learn(unsigned int &floor, unsigned int &dev, int level) {
+	// A level far above the floor (a clap) counts as NOISE_OUTLIER deviations
+	int d = (level << 4) - (int)floor;
+	int cap = NOISE_OUTLIER * dev + (NOISE_OUTLIER_MIN << 4);
+	if(d > cap) d = cap;
+	if(d < 0) floor -= (unsigned int)(-d) >> NOISE_FALL_SHIFT;
+	else floor += (unsigned int)d >> NOISE_RISE_SHIFT;
+	int err = (d < 0 ? -d : d) - (int)dev;
+	dev += err >> NOISE_DEV_SHIFT;
+}
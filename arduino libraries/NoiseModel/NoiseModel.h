@@ -0,0 +1,93 @@
+/******************************************************************************
+* Zowi Noise Model Library
+*
+* The noise sensor hears the servos of Zowi as well as the room. This model
+* learns the noise the servos make, as a signature per motion state (a key
+* chosen by the caller, e.g. the gait being played) and per phase of its
+* cycle, in NOISE_BINS bins. The room is learnt at rest (key NOISE_REST).
+*
+* update() takes one level of the noise envelope (0 - 1023) with its state
+* and phase and returns the servo noise expected there, above the rest floor:
+* the level minus that is what the room made, as if Zowi were still. A floor
+* and a mean deviation are kept per bin; the expected noise is the floor plus
+* NOISE_MARGIN deviations. The floor falls fast and rises slowly, and the
+* levels far above it are clipped, so a clap barely moves the model.
+*
+* The model remembers NOISE_STATES motion states; a new one takes the place
+* of the one used least recently. Everything is in integers, O(NOISE_STATES)
+* per level.
+*
+* @version 20261019
+*
+******************************************************************************/
+#ifndef __NOISEMODEL_H__
+#define __NOISEMODEL_H__
+
+#if defined(ARDUINO) && ARDUINO >= 100
+  #include "Arduino.h"
+#else
+  #include "WProgram.h"
+  #include "pins_arduino.h"
+#endif
+
+////////////////////////////
+// Definitions            //
+////////////////////////////
+#define NOISE_STATES 4				// Motion states remembered
+#define NOISE_BINS 8				// Phases of the cycle per motion state
+#define NOISE_REST 0				// Key of Zowi at rest
+#define NOISE_FALL_SHIFT 2			// The floor falls 1/4 of the way per level
+#define NOISE_RISE_SHIFT 4			// and rises 1/16
+#define NOISE_DEV_SHIFT 3			// Deviation filter: 2^3 levels
+#define NOISE_MARGIN 2				// Deviations added to the floor
+#define NOISE_OUTLIER 3				// Deviations a level is clipped to when learning
+#define NOISE_OUTLIER_MIN 16		// and at least this above the floor
+
+class NoiseModel
+{
+public:
+	////////////////////////////
+	// Functions              //
+	////////////////////////////
+	// NoiseModel -- NoiseModel class constructor
+	NoiseModel();
+
+	// begin -- forget the rest floor and all the signatures
+	void begin(void);
+
+	// update -- learn a level heard at a motion state and phase (256 = one
+	// turn). Returns the servo noise expected there, learnt before this level
+	int update(unsigned int key, unsigned char phase, int level);
+
+	// expected -- servo noise expected at a state and phase, above the rest
+	// floor. 0 for the states not learnt
+	int expected(unsigned int key, unsigned char phase);
+
+	// restFloor -- level of the room, at rest
+	int restFloor(void);
+
+
+private:
+	////////////////////////////
+	// Variables              //
+	////////////////////////////
+	unsigned int keys[NOISE_STATES];
+	unsigned char age[NOISE_STATES];			// Levels since the state was heard, saturated
+	unsigned char learnt[NOISE_STATES];			// A bit per bin with a floor, 0 = free place
+	unsigned int floors[NOISE_STATES][NOISE_BINS];	// Levels << 4
+	unsigned int devs[NOISE_STATES][NOISE_BINS];	// Levels << 4
+	unsigned int rest;						// Levels << 4, 0 = not learnt
+	unsigned int restDev;
+
+
+	////////////////////////////
+	// Functions              //
+	////////////////////////////
+	int find(unsigned int key);
+	int top(unsigned int floor, unsigned int dev);
+	static void learn(unsigned int &floor, unsigned int &dev, int level);
+
+
+};
+
+#endif // NOISEMODEL_H //
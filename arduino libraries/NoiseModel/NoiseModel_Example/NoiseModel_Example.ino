@@ -0,0 +1,57 @@
+//--------------------------------------------------------------
+//-- NoiseModel_Example
+//-- Zowi walks and learns the noise of its servos. Clap while it
+//-- walks: each walk prints the loudest noise heard, raw and with
+//-- the servo noise removed (what the room made). A clap shows in
+//-- the second one, the servos alone do not.
+//--------------------------------------------------------------
+#include <Servo.h>
+#include <Oscillator.h>
+#include <OscillatorBank.h>
+#include <EEPROM.h>
+#include <US.h>
+#include <LedMatrix.h>
+#include <BatReader.h>
+#include <BuzzerSynth.h>
+#include <NoiseModel.h>
+#include <Zowi.h>
+
+#define PIN_YL 2
+#define PIN_YR 3
+#define PIN_RL 4
+#define PIN_RR 5
+
+Zowi zowi;
+NoiseModel noiseModel;
+
+void setup()
+{
+  Serial.begin(115200);
+  zowi.init(PIN_YL, PIN_YR, PIN_RL, PIN_RR, true);
+  zowi.attachNoiseModel(&noiseModel);
+  zowi.senseNoiseAt(SENSE_ANY);
+
+  //-- The room, at rest
+  unsigned long start = millis();
+  while (millis() - start < 2000) zowi.update();
+  zowi.getNoisePeak();
+}
+
+void loop()
+{
+  //-- The raw peak, from the readings of the walk
+  int raw = 0;
+  ZowiReading reading;
+  zowi.setVelocity(100, 0);
+  unsigned long start = millis();
+  while (millis() - start < 4000) {
+    zowi.update();
+    if (zowi.getNoiseReading(reading)) raw = max(raw, reading.value);
+  }
+  zowi.home();
+
+  Serial.print("Loudest: raw ");
+  Serial.print(raw);
+  Serial.print(", servo noise removed ");
+  Serial.println(zowi.getNoisePeak());
+}
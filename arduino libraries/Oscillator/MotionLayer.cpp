@@ -0,0 +1,220 @@
+//--------------------------------------------------------------
+//-- MotionLayer.cpp
+//-- Secondary motions added on top of an OscillatorBank
+//--------------------------------------------------------------
+//-- GPL license
+//--------------------------------------------------------------
+#include "MotionLayer.h"
+
+/*************************************/
+/* WaveLayer                         */
+/*************************************/
+WaveLayer::WaveLayer()
+{
+  for (uint8_t i = 0; i < MOTIONLAYER_JOINTS; i++) {
+    _A[i]=0;
+    _phase0[i]=0;
+  }
+  _wave=wave_sine;
+  _running=false;
+  SetT(500);
+}
+
+void WaveLayer::SetT(unsigned int T)
+{
+  if (T == 0) return;
+  _Tus=T * 1000UL;
+  _inc=0xFFFFFFFFUL / _Tus;
+}
+
+void WaveLayer::start(unsigned long duration)
+{
+  _t0=micros();
+  _start=_t0;
+  _duration=duration * 1000;
+  _running=true;
+}
+
+bool WaveLayer::update(unsigned long t, int offset[], uint8_t n)
+{
+  if (!_running) return false;
+
+  if (_duration && (long)(t - _start) >= (long)_duration) {
+    _running=false;
+    return false;
+  }
+  long dt = t - _t0;
+  if (dt < 0) return true;
+
+  //-- Same phase as OscillatorBank: _t0 is kept within one period
+  if ((unsigned long)dt >= _Tus) {
+    _t0 += dt - dt % _Tus;
+    dt %= _Tus;
+  }
+  unsigned int ph = ((unsigned long)dt * _inc) >> 16;
+
+  for (uint8_t i = 0; i < n; i++) {
+    if (!_A[i]) continue;
+    long wave = (long)_A[i] * OSCILLATOR_FINE * oscillatorWave(_wave, ph + _phase0[i]);
+    offset[i] += (wave + OSCILLATOR_WAVE_ONE / 2) >> 14;
+  }
+  return true;
+}
+
+
+/*************************************/
+/* KeyframeLayer                     */
+/*************************************/
+KeyframeLayer::KeyframeLayer()
+{
+  _frames=0;
+}
+
+void KeyframeLayer::start(const int *frames, uint8_t count, uint8_t joints, bool loop)
+{
+  _frames=frames;
+  _count=count;
+  _joints=min(joints, MOTIONLAYER_JOINTS);
+  _loop=loop;
+  _frame=0;
+  _start=micros();
+}
+
+bool KeyframeLayer::update(unsigned long t, int offset[], uint8_t n)
+{
+  if (!_frames || !_count) return false;
+  uint8_t row = 1 + _joints;
+
+  //-- Skip the frames already reached
+  for (;;) {
+    unsigned long length = pgm_read_word(_frames + _frame * row) * 1000UL;
+    if ((long)(t - _start) < (long)length) break;
+    _start += length;
+    if (++_frame >= _count) {
+      if (!_loop) {
+        _frames=0;
+        return false;
+      }
+      _frame=0;
+    }
+  }
+
+  //-- Interpolate from the previous frame (the last one when looping,
+  //-- 0 offsets at the start)
+  const int *to = _frames + _frame * row;
+  const int *from = _frame ? to - row : (_loop ? _frames + (_count - 1) * row : 0);
+  unsigned long length = pgm_read_word(to) * 1000UL;
+  long elapsed = t - _start;
+  int l = elapsed <= 0 ? 0 : ((unsigned long)elapsed << 8) / length;   //-- Q8
+
+  for (uint8_t i = 0; i < _joints && i < n; i++) {
+    int a = from ? (int16_t)pgm_read_word(from + 1 + i) * OSCILLATOR_FINE : 0;
+    int b = (int16_t)pgm_read_word(to + 1 + i) * OSCILLATOR_FINE;
+    offset[i] += a + (int)((long)(b - a) * l >> 8);
+  }
+  return true;
+}
+
+
+/*************************************/
+/* PoseLayer                         */
+/*************************************/
+PoseLayer::PoseLayer()
+{
+  for (uint8_t i = 0; i < MOTIONLAYER_JOINTS; i++) {
+    _target[i]=0;
+    _current[i]=0;
+  }
+  _rate=0;
+  _last=micros();
+}
+
+bool PoseLayer::update(unsigned long t, int offset[], uint8_t n)
+{
+  //-- Largest step since the last sample (1/OSCILLATOR_FINE degrees)
+  long dt = t - _last;
+  _last = t;
+  long step = 0x7FFF;
+  if (_rate && dt >= 0) step = min((long)_rate * OSCILLATOR_FINE * (dt >> 4) / 62500L, 0x7FFFL);
+
+  for (uint8_t i = 0; i < n && i < MOTIONLAYER_JOINTS; i++) {
+    int d = _target[i] - _current[i];
+    _current[i] += constrain(d, -step, step);
+    offset[i] += _current[i];
+  }
+  return true;
+}
+
+
+/*************************************/
+/* GaitLayer                         */
+/*************************************/
+GaitLayer::GaitLayer()
+{
+  _gait=0;
+}
+
+//-- Play the gait until stop()
+void GaitLayer::start(const unsigned char *gait)
+{
+  startFine(gait, GAIT_CYCLE_FINE);
+  _forever=true;
+}
+
+//-- Play cycles / GAIT_CYCLE_FINE turns of the gait, rounded to whole
+//-- rows. Less than half a row plays nothing
+void GaitLayer::startFine(const unsigned char *gait, unsigned long cycles)
+{
+  _gait=gait;
+  _rows=pgm_read_byte(gait);
+  _joints=min(pgm_read_byte(gait + 1), MOTIONLAYER_JOINTS);
+  _forever=false;
+  _left=(cycles * _rows + GAIT_CYCLE_FINE / 2) / GAIT_CYCLE_FINE;
+  _row=_rows - 1;
+  _started=false;
+  if (!_left) _gait=0;
+}
+
+//-- Decode the next row
+void GaitLayer::row()
+{
+  if (++_row >= _rows) {
+    _row=0;
+    _p=_gait + 2;
+  }
+  for (uint8_t i = 0; i < _joints; i++) {
+    uint8_t b = pgm_read_byte(_p++);
+    if (b == GAIT_ABSOLUTE) {
+      _pos[i] = (int16_t)pgm_read_word(_p);
+      _p += 2;
+    }
+    else {
+      _pos[i] += (int8_t)b;
+    }
+  }
+}
+
+bool GaitLayer::update(unsigned long t, int offset[], uint8_t n)
+{
+  if (!_gait) return false;
+
+  if (!_started) {
+    _started=true;
+    _next=t;
+  }
+  //-- After the last row, the layer ends with its position
+  bool more = true;
+  while ((long)(t - _next) >= 0) {
+    if (!_forever && !_left) {
+      more = false;
+      break;
+    }
+    _left--;
+    row();
+    _next += OSCILLATOR_FRAME * 1000UL;
+  }
+
+  for (uint8_t i = 0; i < _joints && i < n; i++) offset[i] += _pos[i];
+  if (!more) _gait=0;
+  return more;
+}
@@ -0,0 +1,161 @@
+//--------------------------------------------------------------
+//-- MotionLayer.h
+//-- Secondary motions added on top of an OscillatorBank
+//--------------------------------------------------------------
+//-- A layer adds an offset to each joint. The bank asks its layers
+//-- once per sample, weights their offsets, adds them to the gait
+//-- and clamps the result to the limits of the joints. Offsets are
+//-- in 1/OSCILLATOR_FINE degrees, in the direction of the servo
+//-- (the reverse of the joint is not applied).
+//--
+//--   * WaveLayer: a periodic wave on some joints (head shake,
+//--     wiggle of the feet...)
+//--   * KeyframeLayer: poses from a PROGMEM table, interpolated
+//--   * PoseLayer: poses streamed by the program, with a rate limit
+//--   * GaitLayer: a gait baked by tools/gaitbake, one row per frame
+//--
+//-- New sources derive from MotionLayer and implement update()
+//--------------------------------------------------------------
+//-- GPL license
+//--------------------------------------------------------------
+#ifndef MotionLayer_h
+#define MotionLayer_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+  #include "Arduino.h"
+#else
+  #include "WProgram.h"
+#endif
+#include "Oscillator.h"
+
+#define MOTIONLAYER_JOINTS  8     //-- Most joints of a layer
+#define MOTIONLAYER_WEIGHT  256   //-- Full weight (Q8)
+#define GAIT_ABSOLUTE       0x80  //-- Baked gaits: a 16 bit position follows
+#define GAIT_CYCLE_FINE     256   //-- Baked gaits: fixed point cycles
+
+template <uint8_t N> class OscillatorBank;
+
+class MotionLayer
+{
+  public:
+    MotionLayer() {_weight=MOTIONLAYER_WEIGHT; _next=0;};
+
+    //-- Offsets of the n joints at time t (us), added to offset[].
+    //-- Returning false removes the layer from the bank after this
+    //-- sample
+    virtual bool update(unsigned long t, int offset[], uint8_t n) = 0;
+
+    void SetWeight(unsigned int weight) {_weight=weight;};
+    unsigned int getWeight() {return _weight;};
+
+  private:
+    unsigned int _weight;   //-- Q8
+    MotionLayer *_next;     //-- Next layer of the bank
+
+    template <uint8_t N> friend class OscillatorBank;
+};
+
+
+//-- Periodic wave on some joints, for a time or until stopped
+class WaveLayer : public MotionLayer
+{
+  public:
+    WaveLayer();
+    void SetA(uint8_t i, int A) {_A[i]=A;};
+    void SetPhase(uint8_t i, unsigned int phase) {_phase0[i]=phase;};   //-- 1 turn = 65536
+#ifndef ZOWI_NO_FLOAT
+    void SetPh(uint8_t i, double Ph) {SetPhase(i, (long)(Ph * (32768 / M_PI)));};
+#endif
+    void SetT(unsigned int T);
+    void SetWave(const int *wave) {_wave=wave;};
+    void start(unsigned long duration=0);   //-- ms, 0 = until stop()
+    void stop() {_running=false;};
+    virtual bool update(unsigned long t, int offset[], uint8_t n);
+
+  private:
+    int _A[MOTIONLAYER_JOINTS];             //-- Amplitude (degrees)
+    unsigned int _phase0[MOTIONLAYER_JOINTS];
+    const int *_wave;
+    unsigned long _Tus;
+    unsigned long _inc;
+    unsigned long _t0;                      //-- Time of phase 0 (us)
+    unsigned long _start;
+    unsigned long _duration;                //-- us, 0 = no end
+    bool _running;
+};
+
+
+//-- Keyframes in PROGMEM: count rows of (1 + joints) ints, the time
+//-- to reach the frame (ms) and the offsets of the joints (degrees).
+//-- The offsets are linearly interpolated between frames
+class KeyframeLayer : public MotionLayer
+{
+  public:
+    KeyframeLayer();
+    void start(const int *frames, uint8_t count, uint8_t joints, bool loop=false);
+    void stop() {_frames=0;};
+    virtual bool update(unsigned long t, int offset[], uint8_t n);
+
+  private:
+    const int *_frames;
+    uint8_t _count;
+    uint8_t _joints;
+    bool _loop;
+    uint8_t _frame;           //-- Frame being reached
+    unsigned long _start;     //-- Time of the previous frame (us)
+};
+
+
+//-- Poses set by the program (serial commands, sensors...). The
+//-- offsets move to the last pose at a limited rate
+class PoseLayer : public MotionLayer
+{
+  public:
+    PoseLayer();
+    void SetPose(uint8_t i, int offset) {_target[i]=offset * OSCILLATOR_FINE;};
+    void SetRate(unsigned int rate) {_rate=rate;};   //-- degrees per second, 0 = no limit
+    virtual bool update(unsigned long t, int offset[], uint8_t n);
+
+  private:
+    int _target[MOTIONLAYER_JOINTS];    //-- 1/OSCILLATOR_FINE degrees
+    int _current[MOTIONLAYER_JOINTS];
+    unsigned int _rate;
+    unsigned long _last;
+};
+
+
+//-- Gait baked by tools/gaitbake: rows, joints, then one row per
+//-- OSCILLATOR_FRAME with a change of position (signed byte) or
+//-- GAIT_ABSOLUTE and the position (16 bits) of each joint. The
+//-- first row is played at the first sample of the bank, then a row
+//-- per frame (the rows of the samples that are skipped are decoded)
+class GaitLayer : public MotionLayer
+{
+  public:
+    GaitLayer();
+    void start(const unsigned char *gait);   //-- Until stop()
+    void startFine(const unsigned char *gait, unsigned long cycles);  //-- 1/GAIT_CYCLE_FINE
+#ifndef ZOWI_NO_FLOAT
+    void start(const unsigned char *gait, float cycles) {startFine(gait, cycles > 0 ? cycles * GAIT_CYCLE_FINE + 0.5 : 0);};
+#endif
+    void stop() {_gait=0;};
+    bool playing() {return _gait;};
+    unsigned int getPhase() {return ((unsigned long)_row << 16) / _rows;};   //-- Of the row played, 1 turn = 65536
+    virtual bool update(unsigned long t, int offset[], uint8_t n);
+
+  private:
+    void row();
+
+    const unsigned char *_gait;
+    const unsigned char *_p;     //-- Next row
+    uint8_t _row;
+    uint8_t _rows;
+    uint8_t _joints;
+    bool _forever;
+    unsigned long _left;         //-- Rows left to play
+    bool _started;
+    unsigned long _next;         //-- Time of the next row (us)
+    int _pos[MOTIONLAYER_JOINTS];
+};
+
+#endif
@@ -12,25 +12,69 @@
   #include <pins_arduino.h>
 #endif
 #include "Oscillator.h"
-#include <Servo.h>
 
 //-- This function returns true if another sample
-//-- should be taken (i.e. the TS time has passed since
-//-- the last sample was taken
+//-- should be taken. The samples follow an absolute schedule
+//-- (one every TS, or every frame when interpolating): a late
+//-- sample does not delay the next ones, and the samples that
+//-- were missed altogether are skipped
 bool Oscillator::next_sample()
 {
-  
-  //-- Read current time
-  _currentMillis = millis();
- 
-  //-- Check if the timeout has passed
-  if(_currentMillis - _previousMillis > _TS) {
-    _previousMillis = _currentMillis;   
-
-    return true;
+  unsigned long now = micros();
+  unsigned long ts = (_interpolate ? OSCILLATOR_FRAME : _TS) * 1000UL;
+
+  //-- A deadline is never more than a sampling period and two frames
+  //-- ahead (see schedule()). Farther, refresh() has not been called
+  //-- for over 2^31 us: the deadline has wrapped around, it is late
+  unsigned long ahead = _nextSample - now;
+  if ((long)ahead > 0 && ahead <= (_TS + 2UL * OSCILLATOR_FRAME) * 1000) return false;
+
+  unsigned long late = now - _nextSample;
+  if (late >= ts) _nextSample += late - late % ts;
+  _sampleTime = _nextSample + _lead;
+  _nextSample += ts;
+
+  //-- Later than a whole segment: the interpolation starts again here
+  if (late >= _TS * 1000UL) _segmentEnd = _sampleTime - 1;
+
+  return true;
+}
+
+//-- Start the schedule now. With ServoPulse, and a period that is a
+//-- multiple of the frame, the samples are taken OSCILLATOR_LEAD before
+//-- a frame start, with the position for the frame start: they are
+//-- sent as soon as they are computed, and with no lag
+void Oscillator::schedule()
+{
+  _nextSample = micros();
+  _lead = 0;
+#ifndef OSCILLATOR_SERVO_LIB
+  if (_interpolate || _TS % OSCILLATOR_FRAME == 0) {
+    _nextSample = ServoPulse::nextFrame() - OSCILLATOR_LEAD;
+    _lead = OSCILLATOR_LEAD;
   }
-  
-  return false;
+#endif
+  _segmentEnd = _nextSample + _lead - 1;
+}
+
+//-- Position of the oscillation at time t (us), in 1/OSCILLATOR_FINE
+//-- degrees. Fixed point, as OscillatorBank: the sine is the table
+//-- wave_sine
+int Oscillator::position(unsigned long t)
+{
+  //-- _t0 is kept within one period of the samples
+  long dt = t - _t0;
+  if (dt < 0) dt += _Tus;
+  if ((unsigned long)dt >= _Tus) {
+    _t0 += dt - dt % _Tus;
+    dt %= _Tus;
+  }
+  unsigned int ph = ((unsigned long)dt * _inc) >> 16;
+
+  long wave = (long)_A * OSCILLATOR_FINE * oscillatorWave(_wave ? _wave : wave_sine, ph + _phase0);
+  int pos = _O * OSCILLATOR_FINE + (int)((wave + OSCILLATOR_WAVE_ONE / 2) >> 14);
+  if (_rev) pos=-pos;
+  return pos;
 }
 
 //-- Attach an oscillator to a servo
@@ -46,18 +90,18 @@ void Oscillator::attach(int pin, bool rev)
       _servo.write(90);
 
       //-- Initialization of oscilaltor parameters
-      _TS=30;
+      _TS=OSCILLATOR_TS;
+      _interpolate=false;
       _T=2000;
-      _N = _T/_TS;
-      _inc = 2*M_PI/_N;
-
-      _previousMillis=0;
+      _Tus=_T * 1000UL;
+      _inc=0xFFFFFFFFUL / _Tus;
+      Reset();
 
       //-- Default parameters
       _A=45;
-      _phase=0;
       _phase0=0;
       _O=0;
+      _wave=0;
       _stop=false;
 
       //-- Reverse mode
@@ -80,14 +124,54 @@ void Oscillator::detach()
 /*************************************/
 void Oscillator::SetT(unsigned int T)
 {
+  if (T == 0 || T == _T) return;
+
+  //-- Keep the current phase: move the time of phase 0, elapsed * T / _T
+  unsigned long now = micros();
+  unsigned long elapsed = (now - _t0) % _Tus;
+  _t0 = now - (elapsed / _T * T + elapsed % _T * T / _T);
+
   //-- Assign the new period
   _T=T;
-  
-  //-- Recalculate the parameters
-  _N = _T/_TS;
-  _inc = 2*M_PI/_N;
+  _Tus=T * 1000UL;
+  _inc=0xFFFFFFFFUL / _Tus;
 };
 
+
+/*****************************************/
+/* Start the oscillation at phase 0, now */
+/*****************************************/
+void Oscillator::Reset()
+{
+  _t0 = micros();
+  schedule();
+}
+
+
+/*************************************************/
+/* Set the sampling period, in ms. Multiples of  */
+/* OSCILLATOR_FRAME are aligned with the frames  */
+/*************************************************/
+void Oscillator::SetTS(unsigned int TS)
+{
+  if (TS == 0 || TS == _TS) return;
+  _TS=TS;
+  schedule();
+}
+
+
+/****************************************************/
+/* With interpolation the sine is only computed     */
+/* every TS, and the servo is written every frame   */
+/* with a position on the line between two samples  */
+/****************************************************/
+void Oscillator::SetInterpolation(bool interpolate)
+{
+  if (interpolate == _interpolate) return;
+  _interpolate=interpolate;
+  schedule();
+}
+
 /*******************************/
 /* Manual set of the position  */
 /******************************/
@@ -106,21 +190,35 @@ void Oscillator::SetPosition(int position)
 void Oscillator::refresh()
 {
   
-  //-- Only When TS milliseconds have passed, the new sample is obtained
-  if (next_sample()) {
-  
-      //-- If the oscillator is not stopped, calculate the servo position
-      if (!_stop) {
-        //-- Sample the sine function and set the servo pos
-         _pos = round(_A * sin(_phase + _phase0) + _O);
-	       if (_rev) _pos=-_pos;
-         _servo.write(_pos+90+_trim);
-      }
-
-      //-- Increment the phase
-      //-- It is always increased, even when the oscillator is stop
-      //-- so that the coordination is always kept
-      _phase = _phase + _inc;
+  //-- Only when the deadline of the next sample has passed
+  if (!next_sample()) return;
+
+  //-- The phase runs even when the oscillator is stopped (it is
+  //-- computed from the time) so that the coordination is kept
+  if (_stop) {
+    _segmentEnd = _sampleTime - 1;
+    return;
+  }
 
+  if (_interpolate) {
+    unsigned long ts = _TS * 1000UL;
+    if ((long)(_sampleTime - _segmentEnd) >= 0) {
+      //-- Next segment. It continues the previous one unless frames were skipped
+      _from = _sampleTime == _segmentEnd ? _to : position(_sampleTime);
+      _segmentStart = _sampleTime;
+      _segmentEnd = _sampleTime + ts;
+      _to = position(_segmentEnd);
+    }
+    _pos = _from + (long)(_to - _from) * (long)(_sampleTime - _segmentStart) / (long)ts;
   }
+  else {
+    _pos = position(_sampleTime);
+  }
+
+  int pos = _pos + (90 + _trim) * OSCILLATOR_FINE;
+#ifdef OSCILLATOR_SERVO_LIB
+  _servo.write((pos + OSCILLATOR_FINE / 2) / OSCILLATOR_FINE);
+#else
+  _servo.writeFine(pos * (SERVOPULSE_FINE / OSCILLATOR_FINE));
+#endif
 }
@@ -8,7 +8,31 @@
 #ifndef Oscillator_h
 #define Oscillator_h
 
-#include <Servo.h>
+//-- The servos are driven by the ServoPulse engine (all the pulses of a
+//-- frame start at once, 1/16 degree steps). Uncomment to use the Arduino
+//-- Servo library instead
+//#define OSCILLATOR_SERVO_LIB
+
+//-- The oscillators are computed in fixed point. Define ZOWI_NO_FLOAT
+//-- in the compiler flags (float-free profile of the Zowi libraries)
+//-- to also leave out the float API: SetPh in radians, getPosition
+//-- in degrees
+
+#include "OscillatorWaves.h"
+
+#ifdef OSCILLATOR_SERVO_LIB
+  #include <Servo.h>
+  typedef Servo OscillatorServo;
+#else
+  #include <ServoPulse.h>
+  typedef ServoPulse OscillatorServo;
+#endif
+
+//-- Sampling
+#define OSCILLATOR_TS     20    //-- Default sampling period (ms)
+#define OSCILLATOR_FRAME  20    //-- Servo pulse frame (ms)
+#define OSCILLATOR_LEAD   2000  //-- Time between a sample and the frame start that sends it (us)
+#define OSCILLATOR_FINE   16    //-- Fixed point positions: steps per degree
 
 //-- Macro for converting from degrees to radians
 #ifndef DEG2RAD
@@ -23,40 +47,61 @@ class Oscillator
     void detach();
     
     void SetA(unsigned int A) {_A=A;};
-    void SetO(unsigned int O) {_O=O;};
-    void SetPh(double Ph) {_phase0=Ph;};
+    void SetO(int O) {_O=O;};
+    void SetPhase(unsigned int ph) {_phase0=ph;};   //-- 1 turn = 65536
     void SetT(unsigned int T);
+    void SetWave(const int *wave) {_wave=wave;};
+    void SetTS(unsigned int TS);
+    void SetInterpolation(bool interpolate);
     void SetTrim(int trim){_trim=trim;};
     int getTrim() {return _trim;};
+    int getPositionFine() {return _pos;};   //-- 1/OSCILLATOR_FINE degrees
     void SetPosition(int position); 
     void Stop() {_stop=true;};
     void Play() {_stop=false;};
-    void Reset() {_phase=0;};
+    void Reset();
     void refresh();
+
+#ifndef ZOWI_NO_FLOAT
+    void SetPh(double Ph) {SetPhase((long)(Ph * (32768 / M_PI)));};
+    double getPosition() {return (double)_pos / OSCILLATOR_FINE;};
+#endif
     
   private:
     bool next_sample();  
+    int position(unsigned long t);
+    void schedule();
     
   private:
     //-- Servo that is attached to the oscillator
-    Servo _servo;
+    OscillatorServo _servo;
     
     //-- Oscillators parameters
     unsigned int _A;  //-- Amplitude (degrees)
-    unsigned int _O;  //-- Offset (degrees)
+    int _O;           //-- Offset (degrees)
     unsigned int _T;  //-- Period (miliseconds)
-    double _phase0;   //-- Phase (radians)
+    unsigned int _phase0;  //-- Phase (1 turn = 65536)
+    const int *_wave; //-- Waveform (PROGMEM table), 0 = sine
     
     //-- Internal variables
-    int _pos;         //-- Current servo pos
+    int _pos;         //-- Current servo pos (1/OSCILLATOR_FINE degrees)
     int _trim;        //-- Calibration offset
-    double _phase;    //-- Current phase
-    double _inc;      //-- Increment of phase
-    double _N;        //-- Number of samples
+    unsigned long _Tus;  //-- Period (us)
+    unsigned long _inc;  //-- Phase per microsecond (1 turn = 2^32)
     unsigned int _TS; //-- sampling period (ms)
+    bool _interpolate;  //-- Write every frame, between samples
     
-    long _previousMillis; 
-    long _currentMillis;
+    //-- Absolute schedule, in microseconds
+    unsigned long _t0;          //-- Time of phase 0
+    unsigned long _nextSample;  //-- Deadline of the next sample
+    unsigned long _sampleTime;  //-- Time of the position of the current sample
+    unsigned int _lead;         //-- From the deadline to that time
+
+    //-- Interpolation: segment between two samples
+    unsigned long _segmentStart;
+    unsigned long _segmentEnd;
+    int _from;
+    int _to;
     
     //-- Oscillation mode. If true, the servo is stopped
     bool _stop;
@@ -0,0 +1,612 @@
+//--------------------------------------------------------------
+//-- OscillatorBank.h
+//-- Sinusoidal oscillations in N servos that share one clock
+//--------------------------------------------------------------
+//-- The same oscillations as N Oscillator objects, with the state
+//-- of the joints in arrays (struct of arrays) and in fixed point:
+//--   * phases are 16 bits (65536 = one turn)
+//--   * positions are 1/OSCILLATOR_FINE degrees
+//--   * waveforms are PROGMEM tables (OscillatorWaves.h), the sine
+//--     by default
+//-- refresh() reads the clock once and updates all the joints in
+//-- one loop. The sampling settings (SetTS, SetInterpolation) are
+//-- shared by the joints. N is up to 8 (joint masks are 8 bits).
+//--
+//-- Crossfade(ms) before changing the parameters blends the old
+//-- oscillation into the new one, with the new period.
+//--
+//-- CPG mode (SetCPG): each joint is a phase oscillator coupled to
+//-- the others (Kuramoto mean field), that keeps the phase offsets
+//-- of SetPh. The amplitudes, offsets and frequencies follow their
+//-- targets with a time constant, so that parameter changes never
+//-- make the servos jump.
+//--
+//-- Motion layers (addLayer, see MotionLayer.h) add weighted offsets
+//-- to the oscillations. They are summed once per sample, and the
+//-- positions are clamped to the limits of the joints (SetLimits).
+//--------------------------------------------------------------
+//-- GPL license
+//--------------------------------------------------------------
+#ifndef OscillatorBank_h
+#define OscillatorBank_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+  #include "Arduino.h"
+#else
+  #include "WProgram.h"
+#endif
+#include "Oscillator.h"
+#include "MotionLayer.h"
+
+//-- All the joints
+#define OSCILLATOR_ALL 0xFF
+
+//-- Longest CPG integration step (us), for late samples
+#define OSCILLATOR_CPG_MAXDT 50000
+
+template <uint8_t N>
+class OscillatorBank
+{
+  static_assert(N >= 1 && N <= 8, "OscillatorBank: 1 to 8 joints");
+
+  public:
+    OscillatorBank();
+    void attach(uint8_t i, int pin, bool rev =false);
+    void detach(uint8_t i);
+
+    void SetA(uint8_t i, unsigned int A) {_A[i]=A;};
+    void SetO(uint8_t i, int O) {_O[i]=O;};
+    void SetPhase(uint8_t i, unsigned int phase) {_phase0[i]=phase;};   //-- 1 turn = 65536
+#ifndef ZOWI_NO_FLOAT
+    void SetPh(uint8_t i, double Ph) {SetPhase(i, (long)(Ph * (32768 / M_PI)));};
+#endif
+    void SetT(uint8_t i, unsigned int T);
+    void SetWave(uint8_t i, const int *wave) {_wave[i]=wave ? wave : wave_sine; _segment&=~_BV(i);};
+    void SetTS(unsigned int TS);
+    void SetInterpolation(bool interpolate);
+    void SetCPG(unsigned int tau);
+    void Crossfade(unsigned int ms);
+    void SetLimits(uint8_t i, int min, int max);
+    void addLayer(MotionLayer *layer);
+    void removeLayer(MotionLayer *layer);
+    void SetTrim(uint8_t i, int trim) {_trim[i]=trim;};
+    int getTrim(uint8_t i) {return _trim[i];};
+    int getPosition(uint8_t i) {return _pos[i];};
+    unsigned int getPhase(uint8_t i) {return _T[i] ? phase(i, _sampleTime) : 0;};   //-- Of the cycle, at the last sample
+    void Align(uint8_t i, unsigned long t) {setPhase(i, 0, t);};   //-- Phase 0 of the cycle at time t (us)
+    void SetPosition(uint8_t i, int position);
+    void Stop(uint8_t i) {_stop|=_BV(i);};
+    void Play(uint8_t i) {_stop&=~_BV(i);};
+    void Reset(uint8_t i);
+    void refresh(uint8_t joints =OSCILLATOR_ALL);
+
+  private:
+    void schedule();
+    void setPhase(uint8_t i, unsigned int ph, unsigned long t);
+    void cpgHold(uint8_t i, int position);
+    void cpgStep();
+    static long cpgGain(long d, long beta);
+    int cpgPosition(uint8_t i);
+    unsigned int phase(uint8_t i, unsigned long t);
+    int shape(uint8_t i, unsigned int ph);
+    int fadeShape(uint8_t i, unsigned int ph);
+    void mix(int offset[]);
+    int position(uint8_t i, unsigned long t);
+    void write(uint8_t i);
+
+  private:
+    //-- Servos attached to the joints
+    OscillatorServo _servo[N];
+
+    //-- Oscillators parameters
+    unsigned int _A[N];         //-- Amplitude (degrees)
+    int _O[N];                  //-- Offset (degrees)
+    unsigned int _T[N];         //-- Period (miliseconds)
+    unsigned long _Tus[N];      //-- Period (microseconds)
+    unsigned long _inc[N];      //-- Phase per microsecond (1 turn = 2^32)
+    unsigned int _phase0[N];    //-- Phase (1 turn = 65536)
+    const int *_wave[N];        //-- Waveform (PROGMEM table)
+
+    //-- Internal variables
+    int _pos[N];                //-- Current position (1/OSCILLATOR_FINE degrees)
+    int _trim[N];               //-- Calibration offset (degrees)
+    int _min[N];                //-- Limits (1/OSCILLATOR_FINE degrees from home)
+    int _max[N];
+    unsigned long _t0[N];       //-- Time of phase 0 (us)
+    uint8_t _stop;              //-- Stopped joints
+    uint8_t _rev;               //-- Reversed joints
+    uint8_t _held;              //-- Joints at a fixed position (SetPosition)
+
+    //-- Shared schedule (see Oscillator)
+    unsigned int _TS;
+    bool _interpolate;
+    unsigned long _nextSample;
+    unsigned long _sampleTime;
+    unsigned int _lead;
+
+    //-- Interpolation: segment between two samples
+    unsigned long _segmentStart;
+    unsigned long _segmentEnd;
+    uint8_t _segment;           //-- Joints with a valid segment
+    int _from[N];
+    int _to[N];
+
+    //-- Crossfade: the previous oscillation
+    unsigned long _fadeStart;   //-- us
+    unsigned long _fadeUs;      //-- Length, 0 = no crossfade
+    unsigned int _fadeA[N];
+    int _fadeO[N];              //-- 1/OSCILLATOR_FINE degrees
+    unsigned int _fadePhase0[N];
+    const int *_fadeWave[N];
+
+    //-- Motion layers (linked list)
+    MotionLayer *_layers;
+
+    //-- CPG mode: integrated state
+    unsigned int _cpgTau;       //-- Time constant (ms), 0 = off
+    unsigned long _cpgTime;     //-- Time of the state (us)
+    unsigned long _cpgPhase[N]; //-- Phase (1 turn = 2^32)
+    unsigned long _cpgOmega[N]; //-- Frequency (_inc << 4)
+    long _cpgA[N];              //-- Amplitude (1/(OSCILLATOR_FINE * 256) degrees)
+    long _cpgO[N];              //-- Offset (1/(OSCILLATOR_FINE * 256) degrees)
+};
+
+
+template <uint8_t N>
+OscillatorBank<N>::OscillatorBank()
+{
+  for (uint8_t i = 0; i < N; i++) {
+    _A[i]=45;
+    _O[i]=0;
+    _phase0[i]=0;
+    _pos[i]=0;
+    _trim[i]=0;
+    _wave[i]=wave_sine;
+    _T[i]=0;
+    SetT(i, 2000);
+    SetLimits(i, 0, 180);
+  }
+  _layers=0;
+  _stop=0;
+  _rev=0;
+  _held=0;
+  _fadeUs=0;
+  _TS=OSCILLATOR_TS;
+  _interpolate=false;
+  _cpgTau=0;
+  schedule();
+}
+
+//-- Attach joint i to a servo and move it to the home position
+template <uint8_t N>
+void OscillatorBank<N>::attach(uint8_t i, int pin, bool rev)
+{
+  if (_servo[i].attached()) return;
+
+  _servo[i].attach(pin);
+  _servo[i].write(90);
+
+  _A[i]=45;
+  _O[i]=0;
+  _phase0[i]=0;
+  _wave[i]=wave_sine;
+  SetT(i, 2000);
+  Reset(i);
+  _stop&=~_BV(i);
+  if (rev) _rev|=_BV(i);
+  else _rev&=~_BV(i);
+  _pos[i]=0;
+  _held|=_BV(i);
+  if (_cpgTau) cpgHold(i, 90);
+}
+
+template <uint8_t N>
+void OscillatorBank<N>::detach(uint8_t i)
+{
+  if (_servo[i].attached()) _servo[i].detach();
+}
+
+//-- Set the period of joint i, in ms, keeping its current phase
+template <uint8_t N>
+void OscillatorBank<N>::SetT(uint8_t i, unsigned int T)
+{
+  if (T == 0 || T == _T[i]) return;
+
+  unsigned long now = micros();
+  unsigned int ph = _T[i] ? phase(i, now) : 0;
+
+  _T[i]=T;
+  _Tus[i]=T * 1000UL;
+  _inc[i]=0xFFFFFFFFUL / _Tus[i];
+  setPhase(i, ph, now);
+}
+
+//-- Move the time of phase 0 of joint i so that its phase is ph at time t
+template <uint8_t N>
+void OscillatorBank<N>::setPhase(uint8_t i, unsigned int ph, unsigned long t)
+{
+  //-- Time from phase 0 to ph: ph * T * 1000 / 65536
+  _t0[i]=t - ((((unsigned long)ph * _T[i]) >> 8) * 125 >> 5);
+  _segment&=~_BV(i);
+}
+
+//-- Sampling period, shared by all the joints (ms)
+template <uint8_t N>
+void OscillatorBank<N>::SetTS(unsigned int TS)
+{
+  if (TS == 0 || TS == _TS) return;
+  _TS=TS;
+  schedule();
+}
+
+template <uint8_t N>
+void OscillatorBank<N>::SetInterpolation(bool interpolate)
+{
+  if (interpolate == _interpolate) return;
+  _interpolate=interpolate;
+  schedule();
+}
+
+//-- CPG mode, with a time constant in ms (0 = off). The state
+//-- starts from the current phases and parameters, and the phases
+//-- are kept when the mode is left
+template <uint8_t N>
+void OscillatorBank<N>::SetCPG(unsigned int tau)
+{
+  if (tau == _cpgTau) return;
+  unsigned long now = micros();
+
+  for (uint8_t i = 0; i < N; i++) {
+    if (!_cpgTau) {
+      _cpgPhase[i] = (unsigned long)(unsigned int)(phase(i, now) + _phase0[i]) << 16;
+      _cpgOmega[i] = _inc[i] << 4;
+      _cpgA[i] = (long)_A[i] * (OSCILLATOR_FINE << 8);
+      _cpgO[i] = (long)_O[i] * (OSCILLATOR_FINE << 8);
+    }
+    else if (!tau) {
+      setPhase(i, (_cpgPhase[i] >> 16) - _phase0[i], now);
+    }
+  }
+  _cpgTime = now;
+  _cpgTau = tau;
+  schedule();
+}
+
+//-- Manual set of the position of joint i (degrees, 90 = home)
+template <uint8_t N>
+void OscillatorBank<N>::SetPosition(uint8_t i, int position)
+{
+  _servo[i].write(position+_trim[i]);
+  _pos[i]=(position - 90) * OSCILLATOR_FINE;
+  _held|=_BV(i);
+  if (_cpgTau) cpgHold(i, position);
+}
+
+//-- Range of joint i, in servo degrees before the trim (0 to 180
+//-- by default)
+template <uint8_t N>
+void OscillatorBank<N>::SetLimits(uint8_t i, int min, int max)
+{
+  _min[i]=(min - 90) * OSCILLATOR_FINE;
+  _max[i]=(max - 90) * OSCILLATOR_FINE;
+}
+
+//-- Add a layer to the motion. It runs until removed or until its
+//-- update() returns false
+template <uint8_t N>
+void OscillatorBank<N>::addLayer(MotionLayer *layer)
+{
+  for (MotionLayer *l = _layers; l; l = l->_next)
+    if (l == layer) return;
+  layer->_next=_layers;
+  _layers=layer;
+}
+
+template <uint8_t N>
+void OscillatorBank<N>::removeLayer(MotionLayer *layer)
+{
+  for (MotionLayer **link = &_layers; *link; link = &(*link)->_next) {
+    if (*link == layer) {
+      *link=layer->_next;
+      layer->_next=0;
+      return;
+    }
+  }
+}
+
+//-- Blend, over ms, from the current oscillation (or position, for
+//-- the joints that are held or already in a crossfade) into the one
+//-- set next with SetA, SetO, SetPh... The old one follows the new
+//-- period, so the phase is kept. Not used in CPG mode
+template <uint8_t N>
+void OscillatorBank<N>::Crossfade(unsigned int ms)
+{
+  if (_cpgTau) return;
+  unsigned long now = micros();
+  bool fading = _fadeUs && (long)(now - _fadeStart) < (long)_fadeUs;
+
+  for (uint8_t i = 0; i < N; i++) {
+    if (fading || (_held & _BV(i))) {
+      _fadeA[i] = 0;
+      _fadeO[i] = (_rev & _BV(i)) ? -_pos[i] : _pos[i];
+    }
+    else {
+      _fadeA[i] = _A[i];
+      _fadeO[i] = _O[i] * OSCILLATOR_FINE;
+    }
+    _fadePhase0[i] = _phase0[i];
+    _fadeWave[i] = _wave[i];
+  }
+  _fadeStart = now;
+  _fadeUs = ms * 1000UL;
+}
+
+//-- CPG mode: the joint is still at a position. The next oscillation
+//-- grows from there
+template <uint8_t N>
+void OscillatorBank<N>::cpgHold(uint8_t i, int position)
+{
+  long o = (long)(position - 90) * (OSCILLATOR_FINE << 8);
+  _cpgA[i] = 0;
+  _cpgO[i] = (_rev & _BV(i)) ? -o : o;
+}
+
+//-- CPG mode: integrate the state up to the sample time
+template <uint8_t N>
+void OscillatorBank<N>::cpgStep()
+{
+  long dt = _sampleTime - _cpgTime;
+  _cpgTime = _sampleTime;
+  if (dt <= 0) return;
+  if (dt > OSCILLATOR_CPG_MAXDT) dt = OSCILLATOR_CPG_MAXDT;
+
+  //-- dt / tau, Q14 (one division per step)
+  unsigned long tau = _cpgTau * 1000UL;
+  long beta = (unsigned long)dt >= tau ? 16384 : ((unsigned long)dt << 14) / tau;
+
+  //-- Mean field of the phases, relative to their offsets
+  int s[N], c[N];
+  long S = 0, C = 0;
+  for (uint8_t i = 0; i < N; i++) {
+    unsigned int rel = (unsigned int)(_cpgPhase[i] >> 16) - _phase0[i];
+    s[i] = oscillatorWave(wave_sine, rel);
+    c[i] = oscillatorWave(wave_sine, rel + 16384);
+    S += s[i];
+    C += c[i];
+  }
+  S /= N;
+  C /= N;
+
+  for (uint8_t i = 0; i < N; i++) {
+    //-- Parameters: first order towards the targets
+    _cpgA[i] += cpgGain((long)_A[i] * (OSCILLATOR_FINE << 8) - _cpgA[i], beta);
+    _cpgO[i] += cpgGain((long)_O[i] * (OSCILLATOR_FINE << 8) - _cpgO[i], beta);
+    _cpgOmega[i] += cpgGain((long)((_inc[i] << 4) - _cpgOmega[i]), beta);
+
+    //-- Phase: own frequency, plus the coupling sin(mean - rel) / tau.
+    //-- 41722 = 2^32 / (2 pi 2^14), Q14 radians to phase units
+    long k = (S * c[i] - C * s[i]) >> 14;
+    _cpgPhase[i] += (_cpgOmega[i] >> 4) * dt + (k * beta >> 14) * 41722;
+  }
+}
+
+//-- CPG mode: d * beta >> 14, beta in Q14 up to one. In two parts:
+//-- the amplitudes and frequencies times beta overflow 32 bits
+template <uint8_t N>
+long OscillatorBank<N>::cpgGain(long d, long beta)
+{
+  return (d >> 14) * beta + ((d & 0x3FFF) * beta >> 14);
+}
+
+//-- CPG mode: position of joint i from the state
+template <uint8_t N>
+int OscillatorBank<N>::cpgPosition(uint8_t i)
+{
+  long wave = (_cpgA[i] >> 8) * oscillatorWave(_wave[i], _cpgPhase[i] >> 16);
+  int pos = (_cpgO[i] >> 8) + (int)((wave + OSCILLATOR_WAVE_ONE / 2) >> 14);
+  return (_rev & _BV(i)) ? -pos : pos;
+}
+
+//-- Start the oscillation of joint i at phase 0, now. The schedule
+//-- and the segments of the other joints go on
+template <uint8_t N>
+void OscillatorBank<N>::Reset(uint8_t i)
+{
+  setPhase(i, 0, micros());
+}
+
+//-- Start the shared schedule now, aligned with the servo frames
+//-- as in Oscillator::schedule()
+template <uint8_t N>
+void OscillatorBank<N>::schedule()
+{
+  _nextSample = micros();
+  _lead = 0;
+#ifndef OSCILLATOR_SERVO_LIB
+  if (_interpolate || _TS % OSCILLATOR_FRAME == 0) {
+    _nextSample = ServoPulse::nextFrame() - OSCILLATOR_LEAD;
+    _lead = OSCILLATOR_LEAD;
+  }
+#endif
+  _segment = 0;
+  _segmentEnd = _nextSample + _lead - 1;
+}
+
+//-- Phase of joint i at time t
+template <uint8_t N>
+unsigned int OscillatorBank<N>::phase(uint8_t i, unsigned long t)
+{
+  //-- _t0 is kept within one period of the samples, so that dt * inc
+  //-- fits in 32 bits. t may be before _t0 by more than a period
+  //-- (Align() in the future, a segment start): signed modulo
+  long dt = t - _t0[i];
+  if (dt < 0 || (unsigned long)dt >= _Tus[i]) {
+    dt %= (long)_Tus[i];
+    if (dt < 0) dt += _Tus[i];
+    _t0[i] = t - dt;
+  }
+  return ((unsigned long)dt * _inc[i]) >> 16;
+}
+
+//-- Position of joint i at time t
+template <uint8_t N>
+int OscillatorBank<N>::position(uint8_t i, unsigned long t)
+{
+  //-- A joint at rest (A = 0) needs no phase, unless a crossfade still
+  //-- moves it: the baked gaits play on joints at rest. Its _t0 is
+  //-- then left as it is; phase() recovers it within 35 minutes, and
+  //-- Zowi::oscillateServos() aligns the joints anyway
+  if (!_A[i] && !_fadeUs) {
+    int pos = _O[i] * OSCILLATOR_FINE;
+    return (_rev & _BV(i)) ? -pos : pos;
+  }
+
+  unsigned int ph = phase(i, t);
+  int pos = shape(i, ph);
+
+  //-- Crossfade, eased in and out: l^2 (3 - 2 l), Q8
+  if (_fadeUs) {
+    long elapsed = t - _fadeStart;
+    if (elapsed < (long)_fadeUs) {
+      long l = elapsed <= 0 ? 0 : ((unsigned long)elapsed << 8) / _fadeUs;
+      l = (l * l >> 8) * (768 - 2 * l) >> 8;
+      int old = fadeShape(i, ph);
+      pos = old + (int)((long)(pos - old) * l >> 8);
+    }
+  }
+  return (_rev & _BV(i)) ? -pos : pos;
+}
+
+//-- Oscillation of joint i at a phase, before the reverse
+template <uint8_t N>
+int OscillatorBank<N>::shape(uint8_t i, unsigned int ph)
+{
+  if (!_A[i]) return _O[i] * OSCILLATOR_FINE;
+  long wave = (long)_A[i] * OSCILLATOR_FINE * oscillatorWave(_wave[i], ph + _phase0[i]);
+  return _O[i] * OSCILLATOR_FINE + (int)((wave + OSCILLATOR_WAVE_ONE / 2) >> 14);
+}
+
+//-- The same, for the oscillation before the crossfade
+template <uint8_t N>
+int OscillatorBank<N>::fadeShape(uint8_t i, unsigned int ph)
+{
+  long wave = (long)_fadeA[i] * OSCILLATOR_FINE * oscillatorWave(_fadeWave[i], ph + _fadePhase0[i]);
+  return _fadeO[i] + (int)((wave + OSCILLATOR_WAVE_ONE / 2) >> 14);
+}
+
+//-- Weighted sum of the layers at the sample time. The layers that
+//-- are over leave the list
+template <uint8_t N>
+void OscillatorBank<N>::mix(int offset[])
+{
+  for (uint8_t i = 0; i < N; i++) offset[i] = 0;
+
+  MotionLayer **link = &_layers;
+  while (*link) {
+    MotionLayer *layer = *link;
+    int o[N];
+    for (uint8_t i = 0; i < N; i++) o[i] = 0;
+
+    bool more = layer->update(_sampleTime, o, N);
+    if (layer->_weight == MOTIONLAYER_WEIGHT)
+      for (uint8_t i = 0; i < N; i++) offset[i] += o[i];
+    else
+      for (uint8_t i = 0; i < N; i++) offset[i] += (long)o[i] * layer->_weight >> 8;
+
+    if (more) {
+      link = &layer->_next;
+    }
+    else {
+      *link = layer->_next;
+      layer->_next = 0;
+    }
+  }
+}
+
+template <uint8_t N>
+void OscillatorBank<N>::write(uint8_t i)
+{
+  int pos = _pos[i] + (90 + _trim[i]) * OSCILLATOR_FINE;
+#ifdef OSCILLATOR_SERVO_LIB
+  _servo[i].write((pos + OSCILLATOR_FINE / 2) / OSCILLATOR_FINE);
+#else
+  _servo[i].writeFine(pos * (SERVOPULSE_FINE / OSCILLATOR_FINE));
+#endif
+}
+
+//-- This function should be periodically called in order to maintain
+//-- the oscillations. When a sample is due, the joints in the mask
+//-- that are not stopped are updated, with the offsets of the layers;
+//-- the writes reach the servos in the same frame
+template <uint8_t N>
+void OscillatorBank<N>::refresh(uint8_t joints)
+{
+  unsigned long now = micros();
+
+  //-- A deadline is never more than a sampling period and two frames
+  //-- ahead. Farther, it has wrapped around (see Oscillator): late
+  unsigned long ahead = _nextSample - now;
+  if ((long)ahead > 0 && ahead <= (_TS + 2UL * OSCILLATOR_FRAME) * 1000) return;
+
+  //-- The CPG mode samples every TS, with no interpolation
+  bool interpolate = _interpolate && !_cpgTau;
+  unsigned long ts = (interpolate ? OSCILLATOR_FRAME : _TS) * 1000UL;
+  unsigned long late = now - _nextSample;
+  if (late >= ts) _nextSample += late - late % ts;
+  _sampleTime = _nextSample + _lead;
+  _nextSample += ts;
+
+  joints &= ~_stop;
+  if (_cpgTau) cpgStep();
+
+  //-- Interpolation: a new segment every TS. It continues the previous
+  //-- one for the joints that had it, the others compute its start.
+  //-- Later than a whole segment, a new one starts here
+  unsigned long segment = _TS * 1000UL;
+  uint8_t chain = 0;
+  if (late >= segment) _segmentEnd = _sampleTime - 1;
+  if (interpolate && (long)(_sampleTime - _segmentEnd) >= 0) {
+    if (_sampleTime == _segmentEnd) chain = _segment;
+    _segment = 0;
+    _segmentStart = _sampleTime;
+    _segmentEnd = _sampleTime + segment;
+  }
+
+  int offset[N];
+  bool layers = _layers;
+  if (layers) mix(offset);
+
+#ifndef OSCILLATOR_SERVO_LIB
+  ServoPulse::hold();
+#endif
+  for (uint8_t i = 0; i < N; i++) {
+    uint8_t bit = _BV(i);
+    if (!(joints & bit)) continue;
+
+    if (_cpgTau) {
+      _pos[i] = cpgPosition(i);
+    }
+    else if (interpolate) {
+      if (!(_segment & bit)) {
+        _from[i] = (chain & bit) ? _to[i] : position(i, _segmentStart);
+        _to[i] = position(i, _segmentEnd);
+        _segment |= bit;
+      }
+      _pos[i] = _from[i] + (long)(_to[i] - _from[i]) * (long)(_sampleTime - _segmentStart) / (long)segment;
+    }
+    else {
+      _pos[i] = position(i, _sampleTime);
+    }
+    if (layers) _pos[i] += offset[i];
+    _pos[i] = constrain(_pos[i], _min[i], _max[i]);
+    write(i);
+    _held &= ~bit;
+  }
+#ifndef OSCILLATOR_SERVO_LIB
+  ServoPulse::release();
+#endif
+
+  if (_fadeUs && (long)(_sampleTime - _fadeStart) >= (long)_fadeUs) _fadeUs = 0;
+}
+
+#endif
@@ -0,0 +1,98 @@
+//--------------------------------------------------------------
+//-- OscillatorBank_Baked
+//-- Cycles per tick of Zowi's gaits computed by the oscillators
+//-- against the same gaits baked by tools/gaitbake and played by
+//-- GaitLayer, and the flash used by each table.
+//-- The servos are on pins 2 to 5 (Zowi YL, YR, RL, RR).
+//--------------------------------------------------------------
+#include <ServoPulse.h>
+#include <Oscillator.h>
+#include <OscillatorBank.h>
+#include <MotionLayer.h>
+#include <Zowi_gaits.h>
+
+#define RUN 3000   //-- ms per measure
+
+struct Gait {
+  const char *name;
+  const unsigned char *table;
+  unsigned int bytes;
+  int A[4], O[4], T;
+  double ph[4];
+};
+
+//-- As in Zowi.cpp
+const Gait gaits[4] = {
+  {"walk", gait_walk_1000_forward, sizeof(gait_walk_1000_forward),
+   {30, 30, 20, 20}, {0, 0, 4, -4}, 1000, {0, 0, -M_PI/2, -M_PI/2}},
+  {"turn", gait_turn_2000_left, sizeof(gait_turn_2000_left),
+   {30, 10, 20, 20}, {0, 0, 4, -4}, 2000, {0, 0, -M_PI/2, -M_PI/2}},
+  {"moonwalker", gait_moonwalker_900_20_left, sizeof(gait_moonwalker_900_20_left),
+   {0, 0, 20, 20}, {0, 0, 12, -12}, 900, {0, 0, -M_PI/2, -M_PI/2 - M_PI/3}},
+  {"crusaito", gait_crusaito_900_20_forward, sizeof(gait_crusaito_900_20_forward),
+   {25, 25, 20, 20}, {0, 0, 14, -14}, 900, {90, 90, 0, -M_PI/3}},
+};
+
+OscillatorBank<4> bank;
+GaitLayer layer;
+
+//-- Cycles per tick (the refresh calls that took a sample)
+unsigned long measure()
+{
+  unsigned long busy = 0, ticks = 0;
+  unsigned long start = millis();
+  unsigned long frames = ServoPulse::frames();
+  while (millis() - start < RUN) {
+    unsigned long t = micros();
+    bank.refresh();
+    t = micros() - t;
+    if (ServoPulse::frames() == frames) continue;
+    frames = ServoPulse::frames();
+    if (t > 50) {
+      busy += t;
+      ticks++;
+    }
+  }
+  return busy * (F_CPU / 1000000L) / max(ticks, 1UL);
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  for (int i = 0; i < 4; i++) bank.attach(i, 2 + i);
+
+  for (int g = 0; g < 4; g++) {
+    for (int i = 0; i < 4; i++) {
+      bank.SetA(i, gaits[g].A[i]);
+      bank.SetO(i, gaits[g].O[i]);
+      bank.SetT(i, gaits[g].T);
+      bank.SetPh(i, gaits[g].ph[i]);
+    }
+    unsigned long oscillators = measure();
+
+    for (int i = 0; i < 4; i++) {
+      bank.SetA(i, 0);
+      bank.SetO(i, 0);
+    }
+    layer.start(gaits[g].table);
+    bank.addLayer(&layer);
+    unsigned long baked = measure();
+    layer.stop();
+    bank.refresh();
+
+    Serial.print(gaits[g].name);
+    Serial.print(": oscillators ");
+    Serial.print(oscillators);
+    Serial.print(" cycles, baked ");
+    Serial.print(baked);
+    Serial.print(" cycles, table ");
+    Serial.print(gaits[g].bytes);
+    Serial.println(" bytes");
+  }
+
+  for (int i = 0; i < 4; i++) bank.SetPosition(i, 90);
+}
+
+void loop()
+{
+}
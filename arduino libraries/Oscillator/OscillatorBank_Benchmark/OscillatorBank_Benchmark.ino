@@ -0,0 +1,113 @@
+//--------------------------------------------------------------
+//-- OscillatorBank_Benchmark
+//-- Cycles per tick of N Oscillator objects (array of objects)
+//-- against OscillatorBank<N> (struct of arrays), N = 4 and 6.
+//-- The servos are on pins 2 to 7 (the pins do not need servos).
+//--   * tick : a sample of all the joints
+//--   * poll : a call when no sample is due
+//--------------------------------------------------------------
+#include <ServoPulse.h>
+#include <Oscillator.h>
+#include <OscillatorBank.h>
+
+#define RUN 3000   //-- ms per layout
+
+const int pins[6] = {2, 3, 4, 5, 6, 7};
+const int A[6] = {30, 30, 20, 20, 15, 15};
+const int O[6] = {0, 0, 4, -4, 0, 0};
+
+Oscillator osc[6];
+OscillatorBank<4> bank4;
+OscillatorBank<6> bank6;
+
+void report(const char *name, unsigned long busy, unsigned long calls, unsigned long poll)
+{
+  //-- Run time less the polls, per sample
+  unsigned long ticks = RUN / OSCILLATOR_TS;
+  unsigned long cycles = busy * (F_CPU / 1000000L);
+  unsigned long polls = calls - ticks;
+  Serial.print(name);
+  Serial.print(": tick ");
+  Serial.print((cycles - polls * poll) / ticks);
+  Serial.print(" cycles, poll ");
+  Serial.print(poll);
+  Serial.println(" cycles");
+}
+
+void objects(int n)
+{
+  for (int i = 0; i < n; i++) {
+    osc[i].attach(pins[i]);
+    osc[i].SetA(A[i]);
+    osc[i].SetO(O[i]);
+    osc[i].SetT(1000);
+  }
+
+  //-- Polls: the samples are taken 2 ms before a frame starts, none
+  //-- is due right after it
+  unsigned long f = ServoPulse::frames();
+  while (ServoPulse::frames() == f);
+  unsigned long t = micros();
+  for (int k = 0; k < 100; k++)
+    for (int i = 0; i < n; i++) osc[i].refresh();
+  unsigned long poll = (micros() - t) * (F_CPU / 1000000L) / 100;
+
+  unsigned long busy = 0, calls = 0;
+  unsigned long start = millis();
+  while (millis() - start < RUN) {
+    t = micros();
+    ServoPulse::hold();
+    for (int i = 0; i < n; i++) osc[i].refresh();
+    ServoPulse::release();
+    busy += micros() - t;
+    calls++;
+  }
+  for (int i = 0; i < n; i++) osc[i].detach();
+
+  Serial.print(n);
+  report(" x Oscillator", busy, calls, poll);
+}
+
+template <uint8_t N>
+void bank(OscillatorBank<N> &b)
+{
+  for (int i = 0; i < N; i++) {
+    b.attach(i, pins[i]);
+    b.SetA(i, A[i]);
+    b.SetO(i, O[i]);
+    b.SetT(i, 1000);
+  }
+
+  unsigned long f = ServoPulse::frames();
+  while (ServoPulse::frames() == f);
+  unsigned long t = micros();
+  for (int k = 0; k < 100; k++) b.refresh();
+  unsigned long poll = (micros() - t) * (F_CPU / 1000000L) / 100;
+
+  unsigned long busy = 0, calls = 0;
+  unsigned long start = millis();
+  while (millis() - start < RUN) {
+    t = micros();
+    b.refresh();
+    busy += micros() - t;
+    calls++;
+  }
+  for (int i = 0; i < N; i++) b.detach(i);
+
+  Serial.print(N);
+  report(" x OscillatorBank", busy, calls, poll);
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println("Oscillator layouts, cycles per tick");
+  objects(4);
+  bank(bank4);
+  objects(6);
+  bank(bank6);
+}
+
+void loop()
+{
+}
@@ -0,0 +1,109 @@
+//--------------------------------------------------------------
+//-- OscillatorBank_Layers
+//-- A walk with a head shake on the hips and a wiggle of the
+//-- feet on top, and the cycles per tick of the bank with 0 to 3
+//-- motion layers. The servos are on pins 2 to 5 (Zowi YL, YR,
+//-- RL, RR).
+//--------------------------------------------------------------
+#include <ServoPulse.h>
+#include <Oscillator.h>
+#include <OscillatorBank.h>
+#include <MotionLayer.h>
+
+#define RUN 3000   //-- ms per measure
+
+const int A[4] = {30, 30, 20, 20};
+const int O[4] = {0, 0, 4, -4};
+const double Ph[4] = {0, 0, -M_PI/2, -M_PI/2};
+
+//-- Nod of the feet: time (ms), YL, YR, RL, RR (degrees)
+const int nod[] PROGMEM = {
+  200, 0, 0, 10, -10,
+  200, 0, 0, 0, 0,
+};
+
+OscillatorBank<4> bank;
+WaveLayer shake;
+WaveLayer wiggle;
+KeyframeLayer feet;
+PoseLayer pose;
+
+//-- Cycles per tick with the layers in the bank
+void measure(int layers)
+{
+  unsigned long busy = 0, ticks = 0;
+  unsigned long start = millis();
+  unsigned long frames = ServoPulse::frames();
+  while (millis() - start < RUN) {
+    unsigned long t = micros();
+    bank.refresh();
+    t = micros() - t;
+    if (ServoPulse::frames() == frames) continue;
+    frames = ServoPulse::frames();
+    if (t > 50) {
+      busy += t;
+      ticks++;
+    }
+  }
+
+  Serial.print(layers);
+  Serial.print(" layers: ");
+  Serial.print(busy * (F_CPU / 1000000L) / max(ticks, 1UL));
+  Serial.println(" cycles per tick");
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  for (int i = 0; i < 4; i++) {
+    bank.attach(i, 2 + i);
+    bank.SetA(i, A[i]);
+    bank.SetO(i, O[i]);
+    bank.SetT(i, 1000);
+    bank.SetPh(i, Ph[i]);
+  }
+
+  //-- Head shake: the hips turn together, on top of the walk
+  shake.SetA(0, 15);
+  shake.SetA(1, 15);
+  shake.SetT(400);
+  shake.start();
+
+  //-- Wiggle of the feet, half weight
+  wiggle.SetA(2, 10);
+  wiggle.SetA(3, 10);
+  wiggle.SetPh(3, M_PI);
+  wiggle.SetT(250);
+  wiggle.SetWeight(MOTIONLAYER_WEIGHT / 2);
+  wiggle.start();
+
+  feet.start(nod, 2, 4, true);
+  pose.SetRate(60);
+
+  measure(0);
+  bank.addLayer(&shake);
+  measure(1);
+  bank.addLayer(&wiggle);
+  measure(2);
+  bank.addLayer(&feet);
+  measure(3);
+  bank.removeLayer(&feet);
+  bank.addLayer(&pose);
+
+  //-- Stream poses to the hips: lean left and right
+  for (int k = 0; k < 4; k++) {
+    pose.SetPose(0, (k & 1) ? -10 : 10);
+    pose.SetPose(1, (k & 1) ? -10 : 10);
+    unsigned long start = millis();
+    while (millis() - start < 1000) bank.refresh();
+  }
+
+  shake.stop();
+  wiggle.stop();
+  bank.removeLayer(&pose);
+  for (int i = 0; i < 4; i++) bank.SetPosition(i, 90);
+}
+
+void loop()
+{
+}
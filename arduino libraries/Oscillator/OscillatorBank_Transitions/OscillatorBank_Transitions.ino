@@ -0,0 +1,85 @@
+//--------------------------------------------------------------
+//-- OscillatorBank_Transitions
+//-- Peak joint velocity when Zowi's gaits follow each other,
+//-- with no crossfade and with crossfades of several lengths.
+//-- The servos are on pins 2 to 5 (Zowi YL, YR, RL, RR).
+//--------------------------------------------------------------
+#include <ServoPulse.h>
+#include <Oscillator.h>
+#include <OscillatorBank.h>
+
+struct Gait {
+  int A[4], O[4], T;
+  double ph[4];
+};
+
+//-- walk, turn, updown, moonwalker, crusaito, walk (as in Zowi.cpp)
+const Gait gaits[6] = {
+  {{30, 30, 20, 20}, {0, 0, 4, -4}, 1000, {0, 0, -M_PI/2, -M_PI/2}},
+  {{30, 10, 20, 20}, {0, 0, 4, -4}, 1000, {0, 0, -M_PI/2, -M_PI/2}},
+  {{0, 0, 20, 20}, {0, 0, 20, -20}, 1000, {0, 0, -M_PI/2, M_PI/2}},
+  {{0, 0, 20, 20}, {0, 0, 20, -20}, 900, {0, 0, -M_PI/2, -M_PI/2 + 2*M_PI/3}},
+  {{25, 25, 20, 20}, {0, 0, 20, -20}, 900, {0, 0, -M_PI/2, M_PI/2}},
+  {{30, 30, 20, 20}, {0, 0, 4, -4}, 1000, {0, 0, -M_PI/2, -M_PI/2}},
+};
+
+OscillatorBank<4> bank;
+
+void run(unsigned int fade)
+{
+  double transition = 0, steady = 0;
+  int last[4];
+  for (int i = 0; i < 4; i++) last[i] = bank.getPosition(i);
+
+  for (int g = 0; g < 6; g++) {
+    if (fade) bank.Crossfade(fade);
+    for (int i = 0; i < 4; i++) {
+      bank.SetA(i, gaits[g].A[i]);
+      bank.SetO(i, gaits[g].O[i]);
+      bank.SetT(i, gaits[g].T);
+      bank.SetPh(i, gaits[g].ph[i]);
+    }
+
+    //-- Two cycles: the first second is the transition
+    unsigned long start = millis();
+    unsigned long frames = ServoPulse::frames();
+    while (millis() - start < 2UL * gaits[g].T) {
+      bank.refresh();
+      if (ServoPulse::frames() == frames) continue;
+      frames = ServoPulse::frames();
+
+      for (int i = 0; i < 4; i++) {
+        double v = abs(bank.getPosition(i) - last[i]) * (1000.0 / OSCILLATOR_FINE / OSCILLATOR_FRAME);
+        last[i] = bank.getPosition(i);
+        if (g == 0) continue;
+        if (millis() - start < 1000) transition = max(transition, v);
+        else steady = max(steady, v);
+      }
+    }
+  }
+
+  Serial.print("crossfade ");
+  Serial.print(fade);
+  Serial.print(" ms: peak velocity in transitions ");
+  Serial.print(transition, 0);
+  Serial.print(" deg/s, in steady gaits ");
+  Serial.print(steady, 0);
+  Serial.println(" deg/s");
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  for (int i = 0; i < 4; i++) bank.attach(i, 2 + i);
+
+  run(0);
+  run(200);
+  run(400);
+  run(800);
+
+  for (int i = 0; i < 4; i++) bank.SetPosition(i, 90);
+}
+
+void loop()
+{
+}
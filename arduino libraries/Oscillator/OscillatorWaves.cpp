@@ -0,0 +1,55 @@
+//--------------------------------------------------------------
+//-- OscillatorWaves.cpp
+//-- Built-in waveform tables (see OscillatorWaves.h)
+//--------------------------------------------------------------
+//-- GPL license
+//--------------------------------------------------------------
+#include "OscillatorWaves.h"
+
+//-- sin(phase)
+const int wave_sine[OSCILLATOR_WAVE_POINTS] PROGMEM = {
+       0,   1606,   3196,   4756,   6270,   7723,   9102,  10394,
+   11585,  12665,  13623,  14449,  15137,  15679,  16069,  16305,
+   16384,  16305,  16069,  15679,  15137,  14449,  13623,  12665,
+   11585,  10394,   9102,   7723,   6270,   4756,   3196,   1606,
+       0,  -1606,  -3196,  -4756,  -6270,  -7723,  -9102, -10394,
+  -11585, -12665, -13623, -14449, -15137, -15679, -16069, -16305,
+  -16384, -16305, -16069, -15679, -15137, -14449, -13623, -12665,
+  -11585, -10394,  -9102,  -7723,  -6270,  -4756,  -3196,  -1606
+};
+
+//-- Triangle, rising through 0 at phase 0 like the sine
+const int wave_triangle[OSCILLATOR_WAVE_POINTS] PROGMEM = {
+       0,   1024,   2048,   3072,   4096,   5120,   6144,   7168,
+    8192,   9216,  10240,  11264,  12288,  13312,  14336,  15360,
+   16384,  15360,  14336,  13312,  12288,  11264,  10240,   9216,
+    8192,   7168,   6144,   5120,   4096,   3072,   2048,   1024,
+       0,  -1024,  -2048,  -3072,  -4096,  -5120,  -6144,  -7168,
+   -8192,  -9216, -10240, -11264, -12288, -13312, -14336, -15360,
+  -16384, -15360, -14336, -13312, -12288, -11264, -10240,  -9216,
+   -8192,  -7168,  -6144,  -5120,  -4096,  -3072,  -2048,  -1024
+};
+
+//-- Smoothed square: tanh(3 sin(phase)) / tanh(3)
+const int wave_square[OSCILLATOR_WAVE_POINTS] PROGMEM = {
+       0,   4707,   8669,  11556,  13454,  14628,  15331,  15749,
+   15999,  16150,  16243,  16300,  16337,  16360,  16374,  16382,
+   16384,  16382,  16374,  16360,  16337,  16300,  16243,  16150,
+   15999,  15749,  15331,  14628,  13454,  11556,   8669,   4707,
+       0,  -4707,  -8669, -11556, -13454, -14628, -15331, -15749,
+  -15999, -16150, -16243, -16300, -16337, -16360, -16374, -16382,
+  -16384, -16382, -16374, -16360, -16337, -16300, -16243, -16150,
+  -15999, -15749, -15331, -14628, -13454, -11556,  -8669,  -4707
+};
+
+//-- Skewed sine: sin(phase + 0.5 sin(phase)), fast rise and slow fall
+const int wave_skewed[OSCILLATOR_WAVE_POINTS] PROGMEM = {
+       0,   2403,   4746,   6974,   9034,  10884,  12489,  13826,
+   14880,  15649,  16139,  16364,  16345,  16108,  15681,  15094,
+   14378,  13561,  12670,  11728,  10756,   9771,   8786,   7813,
+    6857,   5925,   5018,   4136,   3277,   2438,   1616,    805,
+       0,   -805,  -1616,  -2438,  -3277,  -4136,  -5018,  -5925,
+   -6857,  -7813,  -8786,  -9771, -10756, -11728, -12670, -13561,
+  -14378, -15094, -15681, -16108, -16345, -16364, -16139, -15649,
+  -14880, -13826, -12489, -10884,  -9034,  -6974,  -4746,  -2403
+};
@@ -0,0 +1,45 @@
+//--------------------------------------------------------------
+//-- OscillatorWaves.h
+//-- Periodic waveforms for the oscillators, in PROGMEM tables
+//--------------------------------------------------------------
+//-- A waveform is one period in OSCILLATOR_WAVE_POINTS points,
+//-- from -OSCILLATOR_WAVE_ONE to OSCILLATOR_WAVE_ONE, starting at
+//-- phase 0. User tables have the same format:
+//--
+//--   const int myWave[OSCILLATOR_WAVE_POINTS] PROGMEM = {...};
+//--
+//-- and the value at a 16-bit phase (65536 = one turn) is linearly
+//-- interpolated between the two nearest points
+//--------------------------------------------------------------
+//-- GPL license
+//--------------------------------------------------------------
+#ifndef OscillatorWaves_h
+#define OscillatorWaves_h
+
+#if defined(ARDUINO) && ARDUINO >= 100
+  #include "Arduino.h"
+#else
+  #include "WProgram.h"
+#endif
+#include <avr/pgmspace.h>
+
+#define OSCILLATOR_WAVE_POINTS  64
+#define OSCILLATOR_WAVE_ONE     16384   //-- Table value for 1.0 (Q14)
+
+//-- Built-in waveforms
+extern const int wave_sine[OSCILLATOR_WAVE_POINTS] PROGMEM;
+extern const int wave_triangle[OSCILLATOR_WAVE_POINTS] PROGMEM;
+extern const int wave_square[OSCILLATOR_WAVE_POINTS] PROGMEM;
+extern const int wave_skewed[OSCILLATOR_WAVE_POINTS] PROGMEM;
+
+//-- Value of a waveform at a phase (1 turn = 65536): the top 6 bits
+//-- of the phase select the point, the low 10 bits interpolate
+inline int oscillatorWave(const int *wave, uint16_t phase)
+{
+  uint8_t i = phase >> 10;
+  int a = (int16_t)pgm_read_word(wave + i);
+  int b = (int16_t)pgm_read_word(wave + ((i + 1) & (OSCILLATOR_WAVE_POINTS - 1)));
+  return a + (int)(((long)(b - a) * (phase & 0x3FF)) >> 10);
+}
+
+#endif
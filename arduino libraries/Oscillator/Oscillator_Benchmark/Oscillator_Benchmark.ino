@@ -0,0 +1,88 @@
+//--------------------------------------------------------------
+//-- Oscillator_Benchmark
+//-- Trajectory error versus CPU load of the sampling settings
+//-- (SetTS, SetInterpolation), for a slow and a fast oscillation.
+//-- A servo on pin 2 (Zowi YL). Results on the serial monitor:
+//--   * rms / max : error of the position of each servo frame
+//--                 against the sine at the frame start (degrees)
+//--   * cpu       : time spent in refresh() (% of the run)
+//--------------------------------------------------------------
+#include <ServoPulse.h>
+#include <Oscillator.h>
+
+#define PIN 2
+#define AMPLITUDE 20
+#define RUN 5000   //-- ms per setting
+
+Oscillator osc;
+
+void run(unsigned int T, unsigned int TS, bool interpolate)
+{
+  osc.SetA(AMPLITUDE);
+  osc.SetO(0);
+  osc.SetT(T);
+  osc.SetTS(TS);
+  osc.SetInterpolation(interpolate);
+  osc.Reset();
+  unsigned long t0 = micros();
+
+  unsigned long start = millis();
+  unsigned long busy = 0;
+  unsigned long frames = ServoPulse::frames();
+  double error2 = 0, errorMax = 0;
+  int n = 0;
+
+  while (millis() - start < RUN) {
+    unsigned long t = micros();
+    osc.refresh();
+    busy += micros() - t;
+
+    //-- A new frame: its pulse is the last position written
+    if (ServoPulse::frames() != frames) {
+      frames = ServoPulse::frames();
+      unsigned long frameStart = ServoPulse::nextFrame() - SERVOPULSE_FRAME;
+      double pos = osc.getPosition();
+      double ideal = AMPLITUDE * sin(2 * M_PI * ((frameStart - t0) % (T * 1000UL)) / (T * 1000.0));
+      double e = fabs(pos - ideal);
+      if (millis() - start > 500) {   //-- Skip the first samples
+        error2 += e * e;
+        if (e > errorMax) errorMax = e;
+        n++;
+      }
+    }
+  }
+
+  Serial.print("T=");
+  Serial.print(T);
+  Serial.print(" TS=");
+  Serial.print(TS);
+  Serial.print(interpolate ? " interp" : "       ");
+  Serial.print("  rms ");
+  Serial.print(sqrt(error2 / n), 2);
+  Serial.print("  max ");
+  Serial.print(errorMax, 2);
+  Serial.print("  cpu ");
+  Serial.print(busy / (RUN * 10.0), 2);
+  Serial.println(" %");
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  osc.attach(PIN);
+  Serial.println("Oscillator sampling benchmark");
+
+  unsigned int periods[2] = {500, 1000};
+  for (int i = 0; i < 2; i++) {
+    run(periods[i], 30, false);
+    run(periods[i], 20, false);
+    run(periods[i], 40, true);
+    run(periods[i], 60, true);
+    run(periods[i], 100, true);
+  }
+  osc.detach();
+}
+
+void loop()
+{
+}
@@ -0,0 +1,100 @@
+/******************************************************************************
+* Zowi Polar Histogram Library
+*
+* @version 20261019
+*
+******************************************************************************/
+
+#include "PolarHistogram.h"
+
+#if defined(ARDUINO) && ARDUINO >= 100
+  #include "Arduino.h"
+#else
+  #include "WProgram.h"
+#endif
+
+#if POLAR_BINS != 16
+  #error The cosines are for 16 bins
+#endif
+
+// Cosine of the angle between two bins, x64
+static const signed char cosines[POLAR_BINS] PROGMEM = {
+	64, 59, 45, 24, 0, -24, -45, -59, -64, -59, -45, -24, 0, 24, 45, 59
+};
+
+PolarHistogram::PolarHistogram() {
+	begin();
+}
+
+void PolarHistogram::begin(void) {
+	for(int i = 0; i < POLAR_BINS; i++) bins[i] = 0;
+}
+
+void PolarHistogram::reading(uint16_t heading, unsigned int cm) {
+	unsigned char b = bin(heading);
+	unsigned int d = (!cm || cm > POLAR_FAR ? POLAR_FAR : cm) * POLAR_FINE;
+	walked[b] = 0;
+
+	// Nearer weighs more: an obstacle shows at once, a stray miss does not open it
+	if(!bins[b]) bins[b] = d;
+	else if(d < bins[b]) bins[b] -= (bins[b] - d) * 3 / 4;
+	else bins[b] += (d - bins[b]) / 4;
+}
+
+void PolarHistogram::moved(uint16_t heading, int cm) {
+	unsigned char b = bin(heading);
+	unsigned char step = abs(cm);
+	for(unsigned char i = 0; i < POLAR_BINS; i++) {
+		if(!bins[i]) continue;
+		if(walked[i] + step > POLAR_FORGET) {
+			bins[i] = 0;
+			continue;
+		}
+		walked[i] += step;
+
+		// Closer by the cosine of the angle: cm * 16 * cos / 64
+		long d = bins[i] - ((long)cm * (signed char)pgm_read_byte(&cosines[(i - b) & (POLAR_BINS - 1)]) >> 2);
+		bins[i] = d < POLAR_FINE ? POLAR_FINE : d > POLAR_FAR * POLAR_FINE ? POLAR_FAR * POLAR_FINE : d;
+	}
+}
+
+unsigned int PolarHistogram::distance(uint16_t heading) {
+	return (bins[bin(heading)] + POLAR_FINE / 2) / POLAR_FINE;
+}
+
+unsigned int PolarHistogram::clearance(uint16_t heading) {
+	return open(bin(heading));
+}
+
+uint16_t PolarHistogram::best(uint16_t heading) {
+	// From the heading outwards, left first: the smaller turn wins a tie
+	unsigned char from = bin(heading), found = from;
+	int score = open(from);
+	for(unsigned char turn = 1; turn <= POLAR_BINS / 2; turn++) {
+		for(signed char side = 1; side >= -1; side -= 2) {
+			unsigned char b = (from + side * turn) & (POLAR_BINS - 1);
+			int s = (int)open(b) - POLAR_TURN_COST * turn;
+			if(s > score) {
+				score = s;
+				found = b;
+			}
+		}
+	}
+	return (uint16_t)found << 12;
+}
+
+// The bin of a heading, the nearest one
+unsigned char PolarHistogram::bin(uint16_t heading) {
+	return ((heading + 0x800) >> 12) & (POLAR_BINS - 1);
+}
+
+// The nearest obstacle within POLAR_WIDTH bins, cm
+unsigned int PolarHistogram::open(unsigned char b) {
+	unsigned int nearest = POLAR_FAR * POLAR_FINE;
+	for(signed char i = -POLAR_WIDTH; i <= POLAR_WIDTH; i++) {
+		unsigned int d = bins[(b + i) & (POLAR_BINS - 1)];
+		if(!d) d = POLAR_UNKNOWN * POLAR_FINE;
+		if(d < nearest) nearest = d;
+	}
+	return nearest / POLAR_FINE;
+}
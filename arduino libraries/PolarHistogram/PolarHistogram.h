@@ -0,0 +1,93 @@
+/******************************************************************************
+* Zowi Polar Histogram Library
+*
+* A small map of the obstacles around Zowi: the distance to the nearest
+* obstacle in POLAR_BINS directions, by heading (16 bits, 65536 = one turn).
+* The headings come from dead reckoning (e.g. the walks and turns of Zowi):
+*
+*   - reading: a distance of the ultrasonic sensor goes to the direction it
+*     was taken at, filtered: a nearer reading weighs 3/4, a farther one 1/4,
+*     so a stray echo does not open or close a direction on its own. No echo
+*     (or farther than POLAR_FAR) is POLAR_FAR
+*   - moved: walking shortens the distances ahead and lengthens those
+*     behind (by the cosine of the angle). After POLAR_FORGET cm walked a
+*     direction is unknown again: the dead reckoning drifts
+*   - best: the most open direction. A direction is as open as the nearest
+*     obstacle within POLAR_WIDTH bins each side (Zowi needs room for its
+*     body); an unknown one is worth POLAR_UNKNOWN cm, and every bin turned
+*     costs POLAR_TURN_COST cm, so that Zowi turns no more than it needs
+*
+* Readings cost a few operations, moved() and best() a loop over the bins.
+* All in integers. tools/navsim runs it on the host, in virtual rooms.
+*
+* @version 20261019
+*
+******************************************************************************/
+#ifndef __POLARHISTOGRAM_H__
+#define __POLARHISTOGRAM_H__
+
+#if defined(ARDUINO) && ARDUINO >= 100
+  #include "Arduino.h"
+#else
+  #include "WProgram.h"
+  #include "pins_arduino.h"
+#endif
+
+////////////////////////////
+// Definitions            //
+////////////////////////////
+#define POLAR_BINS 16				// Directions, 22.5 degrees each
+#define POLAR_FINE 16				// Distances are kept in 1/16 cm
+#define POLAR_FAR 150				// cm, farther (or no echo) is open
+#define POLAR_UNKNOWN 60			// cm, the worth of a direction with no readings
+#define POLAR_FORGET 60				// cm walked, then the readings are forgotten
+#define POLAR_WIDTH 1				// Bins each side that Zowi needs free
+#define POLAR_TURN_COST 6			// cm of openness per bin turned
+
+class PolarHistogram
+{
+public:
+	////////////////////////////
+	// Functions              //
+	////////////////////////////
+	// PolarHistogram -- PolarHistogram class constructor
+	PolarHistogram();
+
+	// begin -- forget all the directions
+	void begin(void);
+
+	// reading -- a distance (cm, 0 when there is no echo) at a heading
+	void reading(uint16_t heading, unsigned int cm);
+
+	// moved -- Zowi walked cm (negative: backwards) towards a heading
+	void moved(uint16_t heading, int cm);
+
+	// distance -- to the obstacle at a heading (cm), 0 when it is unknown
+	unsigned int distance(uint16_t heading);
+
+	// clearance -- how open a heading is: the nearest obstacle within
+	// POLAR_WIDTH bins (cm), POLAR_UNKNOWN for the unknown ones
+	unsigned int clearance(uint16_t heading);
+
+	// best -- the heading of the most open direction, turning from a heading
+	uint16_t best(uint16_t heading);
+
+
+private:
+	////////////////////////////
+	// Variables              //
+	////////////////////////////
+	unsigned int bins[POLAR_BINS];		// 1/POLAR_FINE cm, 0 = unknown
+	unsigned char walked[POLAR_BINS];	// cm since the last reading
+
+
+	////////////////////////////
+	// Functions              //
+	////////////////////////////
+	static unsigned char bin(uint16_t heading);
+	unsigned int open(unsigned char bin);
+
+
+};
+
+#endif // POLARHISTOGRAM_H //
@@ -0,0 +1,239 @@
+/******************************************************************************
+* Zowi Servo Pulse Library
+*
+* @version 20261019
+*
+******************************************************************************/
+
+#include "ServoPulse.h"
+
+#if defined(ARDUINO) && ARDUINO >= 100
+  #include "Arduino.h"
+#else
+  #include "WProgram.h"
+#endif
+
+#include <avr/interrupt.h>
+
+////////////////////////////
+// Pulse engine state     //
+////////////////////////////
+// Written by the main context with interrupts disabled, read by the
+// frame start interrupt when pulseDirty is set
+struct PulseChannel {
+	volatile uint8_t *port;			// 0 = free channel
+	uint8_t mask;
+	unsigned int ticks;				// Pulse width
+};
+
+static PulseChannel channels[SERVOPULSE_CHANNELS];
+static volatile bool pulseDirty;
+static volatile uint8_t pulseHold;
+
+// Committed frame, only used by the interrupts. The pulse ends are sorted
+// by width, the starts are grouped by port
+static volatile uint8_t *framePorts[SERVOPULSE_CHANNELS];
+static uint8_t frameMasks[SERVOPULSE_CHANNELS];
+static unsigned int frameWidths[SERVOPULSE_CHANNELS];
+static uint8_t frameCount;
+static volatile uint8_t *startPorts[SERVOPULSE_CHANNELS];
+static uint8_t startMasks[SERVOPULSE_CHANNELS];
+static uint8_t startCount;
+static unsigned int frameStart;
+static uint8_t frameNext;
+static volatile unsigned long frameCounter;
+
+
+// Copy the channels into the frame (interrupt context)
+static void pulseCommit(void) {
+	frameCount = 0;
+	startCount = 0;
+
+	for(uint8_t c = 0; c < SERVOPULSE_CHANNELS; c++) {
+		PulseChannel &ch = channels[c];
+		if(!ch.port) continue;
+
+		uint8_t i = frameCount++;
+		while(i && frameWidths[i - 1] > ch.ticks) {
+			framePorts[i] = framePorts[i - 1];
+			frameMasks[i] = frameMasks[i - 1];
+			frameWidths[i] = frameWidths[i - 1];
+			i--;
+		}
+		framePorts[i] = ch.port;
+		frameMasks[i] = ch.mask;
+		frameWidths[i] = ch.ticks;
+
+		uint8_t s = 0;
+		while(s < startCount && startPorts[s] != ch.port) s++;
+		if(s == startCount) {
+			startPorts[startCount++] = ch.port;
+			startMasks[s] = 0;
+		}
+		startMasks[s] |= ch.mask;
+	}
+	pulseDirty = false;
+}
+
+
+// Frame start: Timer1 reached TOP (ICR1)
+ISR(TIMER1_CAPT_vect) {
+	frameCounter++;
+	if(pulseDirty && !pulseHold) pulseCommit();
+	if(!frameCount) return;
+
+	for(uint8_t s = 0; s < startCount; s++) *startPorts[s] |= startMasks[s];
+	frameStart = TCNT1;
+	frameNext = 0;
+
+	OCR1B = frameStart + frameWidths[0];
+	TIFR1 = _BV(OCF1B);
+	TIMSK1 |= _BV(OCIE1B);
+}
+
+// End of the shortest pulse left. The following ends that are too close
+// to leave the interrupt are waited for here
+ISR(TIMER1_COMPB_vect) {
+	uint8_t i = frameNext;
+
+	for(;;) {
+		*framePorts[i] &= ~frameMasks[i];
+		if(++i >= frameCount) {
+			TIMSK1 &= ~_BV(OCIE1B);
+			break;
+		}
+		unsigned int end = frameStart + frameWidths[i];
+		if((int)(end - TCNT1) > SERVOPULSE_MARGIN) {
+			OCR1B = end;
+			break;
+		}
+		while((int)(TCNT1 - end) < 0);
+	}
+	frameNext = i;
+}
+
+
+ServoPulse::ServoPulse() {
+	channel = -1;
+}
+
+char ServoPulse::attach(int pin) {
+	if(channel >= 0) return channel;
+
+	for(uint8_t c = 0; c < SERVOPULSE_CHANNELS; c++) {
+		if(channels[c].port) continue;
+
+		pinMode(pin, OUTPUT);
+		digitalWrite(pin, LOW);
+
+		uint8_t oldSREG = SREG;
+		cli();
+		channels[c].port = portOutputRegister(digitalPinToPort(pin));
+		channels[c].mask = digitalPinToBitMask(pin);
+		channels[c].ticks = SERVOPULSE_TICKS(SERVOPULSE_DEFAULT_US);
+		pulseDirty = true;
+		SREG = oldSREG;
+
+		channel = c;
+		startTimer();
+		return channel;
+	}
+	return -1;
+}
+
+// The pin stays low from the next committed frame
+void ServoPulse::detach(void) {
+	if(channel < 0) return;
+
+	uint8_t oldSREG = SREG;
+	cli();
+	channels[(uint8_t)channel].port = 0;
+	pulseDirty = true;
+	SREG = oldSREG;
+
+	channel = -1;
+}
+
+bool ServoPulse::attached(void) {
+	return channel >= 0;
+}
+
+void ServoPulse::write(int value) {
+	if(value < SERVOPULSE_MIN_US) writeFine(value * SERVOPULSE_FINE);
+	else writeMicroseconds(value);
+}
+
+void ServoPulse::writeFine(int position) {
+	position = constrain(position, 0, 180 * SERVOPULSE_FINE);
+	setTicks(SERVOPULSE_TICKS(SERVOPULSE_MIN_US) + (((unsigned long)position * SERVOPULSE_SCALE) >> 12));
+}
+
+void ServoPulse::writeMicroseconds(int us) {
+	us = constrain(us, SERVOPULSE_MIN_US, SERVOPULSE_MAX_US);
+	setTicks(SERVOPULSE_TICKS(us));
+}
+
+int ServoPulse::read(void) {
+	long us = readMicroseconds();
+	return ((us - SERVOPULSE_MIN_US) * 180 + (SERVOPULSE_MAX_US - SERVOPULSE_MIN_US) / 2) / (SERVOPULSE_MAX_US - SERVOPULSE_MIN_US);
+}
+
+int ServoPulse::readMicroseconds(void) {
+	if(channel < 0) return 0;
+	uint8_t oldSREG = SREG;
+	cli();
+	unsigned int ticks = channels[(uint8_t)channel].ticks;
+	SREG = oldSREG;
+	return (unsigned long)ticks * 8 / (F_CPU / 1000000L);
+}
+
+void ServoPulse::hold(void) {
+	pulseHold++;
+}
+
+void ServoPulse::release(void) {
+	if(pulseHold) pulseHold--;
+}
+
+unsigned long ServoPulse::frames(void) {
+	uint8_t oldSREG = SREG;
+	cli();
+	unsigned long n = frameCounter;
+	SREG = oldSREG;
+	return n;
+}
+
+unsigned long ServoPulse::nextFrame(void) {
+	if(!(TIMSK1 & _BV(ICIE1))) return micros();
+
+	uint8_t oldSREG = SREG;
+	cli();
+	unsigned int left = ICR1 - TCNT1 + 1;
+	unsigned long now = micros();
+	SREG = oldSREG;
+	return now + (unsigned long)left * 8 / (F_CPU / 1000000L);
+}
+
+void ServoPulse::setTicks(unsigned int ticks) {
+	if(channel < 0) return;
+
+	uint8_t oldSREG = SREG;
+	cli();
+	channels[(uint8_t)channel].ticks = ticks;
+	pulseDirty = true;
+	SREG = oldSREG;
+}
+
+void ServoPulse::startTimer(void) {
+	if(TIMSK1 & _BV(ICIE1)) return;
+
+	uint8_t oldSREG = SREG;
+	cli();
+	TCCR1A = 0;
+	TCCR1B = _BV(WGM13) | _BV(WGM12) | _BV(CS11);	// CTC, TOP = ICR1, clk/8
+	ICR1 = SERVOPULSE_TICKS(SERVOPULSE_FRAME) - 1;
+	TCNT1 = 0;
+	TIFR1 = _BV(ICF1) | _BV(OCF1B);
+	TIMSK1 = _BV(ICIE1);		// Also stops the Servo library interrupt, if it was running
+	SREG = oldSREG;
+}
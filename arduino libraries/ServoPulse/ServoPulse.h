@@ -0,0 +1,114 @@
+/******************************************************************************
+* Zowi Servo Pulse Library
+*
+* Servo pulse engine on Timer1 with 0.5 us resolution. All the channels
+* start their pulses together at the frame start (one port write per
+* port), and each pulse is ended by an output compare interrupt, in order
+* of length. Positions are committed at the frame start, so a frame never
+* mixes old and new positions of a group of writes (see hold()/release()).
+*
+* Degrees are converted to timer ticks with a fixed-point multiply, with no
+* map() or division in the write path. writeFine() takes 1/SERVOPULSE_FINE
+* degree steps (about 0.6 us); the Servo library write() has 1 degree
+* steps (about 10 us).
+*
+* Timer1 is shared with the Servo library: do not attach Servo objects
+* while ServoPulse channels are attached. The interrupts used (input
+* capture and compare B) are not the ones of the Servo library, so both
+* libraries can be linked in the same sketch.
+*
+* @version 20261019
+*
+******************************************************************************/
+#ifndef __SERVOPULSE_H__
+#define __SERVOPULSE_H__
+
+#if defined(ARDUINO) && ARDUINO >= 100
+  #include "Arduino.h"
+#else
+  #include "WProgram.h"
+  #include "pins_arduino.h"
+#endif
+
+////////////////////////////
+// Definitions            //
+////////////////////////////
+#define SERVOPULSE_CHANNELS 8
+#define SERVOPULSE_FRAME 20000		// us between frame starts
+#define SERVOPULSE_MIN_US 544		// Pulse at 0 degrees (same as the Servo library)
+#define SERVOPULSE_MAX_US 2400		// Pulse at 180 degrees
+#define SERVOPULSE_DEFAULT_US 1500
+#define SERVOPULSE_FINE 16			// writeFine() steps per degree
+
+#define SERVOPULSE_TICKS(us) ((unsigned long)(us) * (F_CPU / 1000000L) / 8)	// Timer1, prescaler 8
+#define SERVOPULSE_MARGIN 24		// Pulse ends closer than this (ticks) are timed by polling
+#define SERVOPULSE_LATENCY 6		// Ticks from the frame start to the pins going high
+
+// Ticks per fine step, << 12
+#define SERVOPULSE_SCALE ((SERVOPULSE_TICKS(SERVOPULSE_MAX_US - SERVOPULSE_MIN_US) << 12) / (180L * SERVOPULSE_FINE))
+
+
+class ServoPulse
+{
+public:
+	////////////////////////////
+	// Functions              //
+	////////////////////////////
+	// ServoPulse -- ServoPulse class constructor
+	ServoPulse();
+
+	// attach -- start the pulses on a pin. Returns the channel, -1 if none is free
+	char attach(int pin);
+
+	// detach -- stop the pulses and free the channel
+	void detach(void);
+
+	// attached
+	bool attached(void);
+
+	// write -- degrees (0-180), or microseconds if the value is a pulse width,
+	// as in the Servo library
+	void write(int value);
+
+	// writeFine -- position in 1/SERVOPULSE_FINE degrees (0 to 180*SERVOPULSE_FINE)
+	void writeFine(int position);
+
+	// writeMicroseconds -- pulse width
+	void writeMicroseconds(int us);
+
+	// read -- last position written, in degrees
+	int read(void);
+
+	// readMicroseconds -- last pulse width written
+	int readMicroseconds(void);
+
+	// hold -- the following writes wait for release()
+	static void hold(void);
+
+	// release -- the writes since hold() are committed together at the next frame start
+	static void release(void);
+
+	// frames -- number of frames started since the timer was started
+	static unsigned long frames(void);
+
+	// nextFrame -- micros() time of the next frame start (now if no channel was attached)
+	static unsigned long nextFrame(void);
+
+
+private:
+	////////////////////////////
+	// Variables              //
+	////////////////////////////
+	char channel;
+
+
+	////////////////////////////
+	// Functions              //
+	////////////////////////////
+	void setTicks(unsigned int ticks);
+	static void startTimer(void);
+
+
+};
+
+#endif // SERVOPULSE_H //
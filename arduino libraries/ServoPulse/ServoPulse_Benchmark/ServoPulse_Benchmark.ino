@@ -0,0 +1,103 @@
+#include <Servo.h>
+#include <ServoPulse.h>
+
+// Zowi servo pins: YL, YR, RL, RR (all on PORTD)
+const int pins[4] = {2, 3, 4, 5};
+#define PINS_MASK 0x3C
+
+Servo servos[4];
+ServoPulse pulses[4];
+
+// Time between the first and the last rising edge of the four pins in one
+// frame, in us (micros() has 4 us steps)
+unsigned long measureSkew(void) {
+  unsigned long rise[4];
+  uint8_t seen = 0, last;
+  unsigned long t0 = millis();
+
+  // Wait for a gap between frames
+  while((PIND & PINS_MASK) && millis() - t0 < 100);
+  delayMicroseconds(2000);
+  last = PIND;
+
+  while(seen != 0x0F && millis() - t0 < 100) {
+    uint8_t now = PIND;
+    uint8_t up = now & ~last;
+    unsigned long t = micros();
+    last = now;
+    for(int i = 0; i < 4; i++) {
+      if((up & _BV(pins[i])) && !(seen & _BV(i))) {
+        rise[i] = t;
+        seen |= _BV(i);
+      }
+    }
+  }
+
+  unsigned long first = rise[0], end = rise[0];
+  for(int i = 1; i < 4; i++) {
+    first = min(first, rise[i]);
+    end = max(end, rise[i]);
+  }
+  return end - first;
+}
+
+void report(const char *name, unsigned long us, int calls) {
+  Serial.print(name);
+  Serial.print(": ");
+  Serial.print(us * (F_CPU / 1000000L) / calls);
+  Serial.println(" cycles per call");
+}
+
+void setup() {
+  Serial.begin(115200);
+  unsigned long t;
+  int i;
+
+  // Arduino Servo library
+  for(i = 0; i < 4; i++) servos[i].attach(pins[i]);
+  t = micros();
+  for(i = 0; i < 1000; i++) servos[i & 3].write(45 + (i & 63));
+  report("Servo.write(degrees)", micros() - t, 1000);
+  for(i = 0; i < 4; i++) servos[i].write(90);
+  delay(100);
+  Serial.print("Servo skew between the 4 channels: ");
+  Serial.print(measureSkew());
+  Serial.println(" us");
+  for(i = 0; i < 4; i++) servos[i].detach();
+
+  // ServoPulse
+  for(i = 0; i < 4; i++) pulses[i].attach(pins[i]);
+  t = micros();
+  for(i = 0; i < 1000; i++) pulses[i & 3].write(45 + (i & 63));
+  report("ServoPulse.write(degrees)", micros() - t, 1000);
+  t = micros();
+  for(i = 0; i < 1000; i++) pulses[i & 3].writeFine((45 + (i & 63)) * SERVOPULSE_FINE + (i & 15));
+  report("ServoPulse.writeFine(1/16 degree)", micros() - t, 1000);
+  for(i = 0; i < 4; i++) pulses[i].write(90);
+  delay(100);
+  Serial.print("ServoPulse skew between the 4 channels: ");
+  Serial.print(measureSkew());
+  Serial.println(" us");
+
+  // Resolution
+  Serial.print("Servo.write step: ");
+  Serial.print((SERVOPULSE_MAX_US - SERVOPULSE_MIN_US) / 180.0);
+  Serial.println(" us");
+  Serial.print("ServoPulse.writeFine step: ");
+  Serial.print((SERVOPULSE_MAX_US - SERVOPULSE_MIN_US) / (180.0 * SERVOPULSE_FINE));
+  Serial.println(" us (timer resolution 0.5 us)");
+}
+
+void loop() {
+  // Slow sweep with 1/16 degree steps, the four servos in the same frame
+  static int position = 60 * SERVOPULSE_FINE;
+  static int step = 1;
+
+  ServoPulse::hold();
+  for(int i = 0; i < 4; i++) pulses[i].writeFine(position);
+  ServoPulse::release();
+
+  position += step;
+  if(position >= 120 * SERVOPULSE_FINE || position <= 60 * SERVOPULSE_FINE) step = -step;
+  delay(2);
+}
@@ -2,9 +2,17 @@
 
 //****** US ******//
 US::US(){
+  _state = 0;
+  _cm = US_NO_ECHO;
+  _dropped = 0;
+  _timed = false;
 }
 
 US::US(int pinTrigger, int pinEcho){
+  _state = 0;
+  _cm = US_NO_ECHO;
+  _dropped = 0;
+  _timed = false;
   US::init(pinTrigger,pinEcho);
 }
 
@@ -16,23 +24,117 @@ void US::init(int pinTrigger, int pinEcho)
   pinMode( _pinEcho , INPUT );
 }
 
-long US::TP_init()
+void US::trigger()
 {
     digitalWrite(_pinTrigger, LOW);
     delayMicroseconds(2);
     digitalWrite(_pinTrigger, HIGH);
     delayMicroseconds(10);
     digitalWrite(_pinTrigger, LOW);
-    long microseconds = pulseIn(_pinEcho,HIGH,40000); //40000
+}
+
+long US::TP_init()
+{
+    trigger();
+    long microseconds = pulseIn(_pinEcho,HIGH,US_TIMEOUT); //40000
     return microseconds;
 }
 
-float US::read(){
+unsigned int US::readCm(){
+  // The sensor does not hear a trigger during an echo: the measure
+  // running and its echo end first, and its distance is dropped
+  while (_state) update();
+  unsigned long start = micros();
+  while (digitalRead(_pinEcho) && micros() - start < US_TIMEOUT);
+
   long microseconds = US::TP_init();
-  long distance;
+  unsigned int distance;
   distance = microseconds/29/2;
   if (distance == 0){
-    distance = 999;
+    distance = US_NO_ECHO;
   }
   return distance;
-}
\ No newline at end of file
+}
+
+bool US::ping(){
+  // The echo of the last measure must be over
+  if (_state || digitalRead(_pinEcho)) return false;
+  trigger();
+  _start = _poll = micros();
+  _state = 1;
+  return true;
+}
+
+bool US::update(){
+  if (!_state) return false;
+  if (_timed) return timed();
+  unsigned long now = micros();
+  bool echo = digitalRead(_pinEcho);
+
+  // Not followed: the echo may have started or ended long ago
+  if (now - _poll > US_POLL_GAP) {
+    _state = 0;
+    _dropped++;
+    return false;
+  }
+  _poll = now;
+
+  if (_state == 1) {
+    if (echo) {
+      _start = now;
+      _state = 2;
+    }
+    else if (now - _start >= US_RISE_TIMEOUT) {
+      _cm = US_NO_ECHO;
+      _state = 0;
+      return true;
+    }
+    return false;
+  }
+
+  // As readCm(): no echo within US_TIMEOUT is no obstacle
+  unsigned long us = now - _start;
+  if (echo && us < US_TIMEOUT) return false;
+  _cm = echo ? 0 : us/29/2;
+  if (_cm == 0) _cm = US_NO_ECHO;
+  _state = 0;
+  return true;
+}
+
+// The edges of the echo, from the pin-change interrupt
+void US::edge(){
+  unsigned long now = micros();
+  _timed = true;
+  bool echo = digitalRead(_pinEcho);
+  if (_state == 1 && echo) {
+    _start = now;
+    _state = 2;
+  }
+  else if (_state == 2 && !echo) {
+    _end = now;
+    _state = 3;
+  }
+}
+
+// update() with the edges timed by edge(): only the timeouts are polled
+bool US::timed(){
+  uint8_t oldSREG = SREG;
+  cli();
+  unsigned long now = micros();
+  uint8_t state = _state;
+  unsigned long start = _start;
+  unsigned long end = _end;
+  SREG = oldSREG;
+
+  if (state == 3) {
+    // As readCm(): an echo of US_TIMEOUT or more is no obstacle
+    _cm = end - start < US_TIMEOUT ? (end - start)/29/2 : 0;
+  }
+  else {
+    if (now - start < (state == 1 ? US_RISE_TIMEOUT : US_TIMEOUT)) return false;
+    _cm = 0;
+  }
+  if (_cm == 0) _cm = US_NO_ECHO;
+  _state = 0;
+  return true;
+}
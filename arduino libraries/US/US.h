@@ -2,18 +2,54 @@
 #define US_h
 #include "Arduino.h"
 
+#define US_TIMEOUT 40000	// us of echo, no obstacle beyond
+#define US_RISE_TIMEOUT 5000	// us from the trigger to the echo
+#define US_NO_ECHO 999	// cm when there is no echo
+#define US_POLL_GAP 1000	// us between the calls of update(), at most
+
 class US
 {
 public:
 	US();
 	void init(int pinTrigger, int pinEcho);
 	US(int pinTrigger, int pinEcho);
-	float read();
+	unsigned int readCm();	// 999 when there is no echo. Ends a measure running first
+#ifndef ZOWI_NO_FLOAT
+	float read() {return readCm();}
+#endif
+
+	// Non-blocking measure: ping() starts it (false when one is running)
+	// and update() follows the echo. Call update() often: the error is
+	// the time between the calls (58 us per cm). It returns true when
+	// the distance is ready in cm(). Calls more than US_POLL_GAP apart
+	// (e.g. a blocking function in between) give the measure up, with
+	// no distance: the echo was not followed. dropped() counts them
+	bool ping();
+	bool update();
+	bool busy() {return _state != 0;}
+	unsigned int cm() {return _cm;}
+	unsigned int dropped() {return _dropped;}
+
+	// Echo timed by a pin-change interrupt: call edge() from it, on both
+	// edges of the echo pin (e.g. enableInterrupt(pin, f, CHANGE) of
+	// EnableInterrupt). From the first edge on, the error is the
+	// interrupt latency, and update() may be called any time
+	void edge();
 
 private:
 	int _pinTrigger;
 	int _pinEcho;
 	long TP_init();
+	void trigger();
+	bool timed();
+
+	volatile uint8_t _state;	// 0 idle, 1 waiting for the echo, 2 in the echo, 3 echo over (edge())
+	volatile unsigned long _start;	// us, of the trigger or the echo
+	volatile unsigned long _end;	// us, of the end of the echo (edge())
+	unsigned long _poll;	// us, of the last call of ping() or update()
+	unsigned int _cm;
+	unsigned int _dropped;	// Measures given up
+	volatile bool _timed;	// edge() is called
 
 };
 
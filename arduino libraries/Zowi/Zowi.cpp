@@ -8,8 +8,14 @@
 
 
 #include "Zowi.h"
+#include "Zowi_songs.h"
 #include <Oscillator.h>
 #include <US.h>
+#include <NoiseModel.h>
+#include <BeatTracker.h>
+#include <ClapPattern.h>
+#include <HandGesture.h>
+#include "Zowi_map.h"
 
 
 
@@ -20,6 +26,11 @@ void Zowi::init(int YL, int YR, int RL, int RR, bool load_calibration, int Noise
   servo_pins[2] = RL;
   servo_pins[3] = RR;
 
+  sample_time = OSCILLATOR_TS;
+  sample_interpolate = false;
+  for (int i = 0; i < 4; i++) servo_wave[i] = 0;
+  transition_time = 0;
+  velocity_mode = false;
   attachServos();
   isZowiResting=false;
 
@@ -27,7 +38,7 @@ void Zowi::init(int YL, int YR, int RL, int RR, bool load_calibration, int Noise
     for (int i = 0; i < 4; i++) {
       int servo_trim = EEPROM.read(i);
       if (servo_trim > 128) servo_trim -= 256;
-      servo[i].SetTrim(servo_trim);
+      servo.SetTrim(i, servo_trim);
     }
   }
   
@@ -40,41 +51,83 @@ void Zowi::init(int YL, int YR, int RL, int RR, bool load_calibration, int Noise
   pinBuzzer = Buzzer;
   pinNoiseSensor = NoiseSensor;
 
-  pinMode(Buzzer,OUTPUT);
+  buzzer.begin(Buzzer);
   pinMode(NoiseSensor,INPUT);
+
+  battery.begin();
+  setPowerPolicy(POWER_BALANCED);
+
+  phase_events = 0;
+  phase_time = quiet_time = millis();
+  for (int i = 0; i < 4; i++) phase_pos[i] = 0;
+  sense_distance = sense_noise = false;
+  distance_new = noise_new = false;
+  noise_count = 0;
+  distance_tag.time = noise_time = 0;
+  distance_tag.expected = 0;
+  noise_model = 0;
+  noise_key = NOISE_KEY_MOVE;
+  noise_peak = 0;
+  phase_speed = 0;
+  beat_tracker = 0;
+  beat_follow = beat_new = false;
+  clap_pattern = 0;
+  clap_command = 0;
+  hand_gesture = 0;
+  hand_event = HAND_NONE;
+  nav = 0;
 }
 
 ///////////////////////////////////////////////////////////////////
 //-- ATTACH & DETACH FUNCTIONS ----------------------------------//
 ///////////////////////////////////////////////////////////////////
 void Zowi::attachServos(){
-    servo[0].attach(servo_pins[0]);
-    servo[1].attach(servo_pins[1]);
-    servo[2].attach(servo_pins[2]);
-    servo[3].attach(servo_pins[3]);
+    servo.attach(0, servo_pins[0]);
+    servo.attach(1, servo_pins[1]);
+    servo.attach(2, servo_pins[2]);
+    servo.attach(3, servo_pins[3]);
+    servo.SetTS(sample_time);
+    servo.SetInterpolation(sample_interpolate);
+    for (int i = 0; i < 4; i++) servo.SetWave(i, servo_wave[i]);
+    battery.setLoad(4, 0);
 }
 
 void Zowi::detachServos(){
-    servo[0].detach();
-    servo[1].detach();
-    servo[2].detach();
-    servo[3].detach();
+    servo.detach(0);
+    servo.detach(1);
+    servo.detach(2);
+    servo.detach(3);
+    battery.setLoad(0, 0);
+}
+
+//-- The positions written between _holdServos and _releaseServos
+//--   reach the servos in the same pulse frame
+void Zowi::_holdServos(){
+#ifndef OSCILLATOR_SERVO_LIB
+    ServoPulse::hold();
+#endif
+}
+
+void Zowi::_releaseServos(){
+#ifndef OSCILLATOR_SERVO_LIB
+    ServoPulse::release();
+#endif
 }
 
 ///////////////////////////////////////////////////////////////////
 //-- OSCILLATORS TRIMS ------------------------------------------//
 ///////////////////////////////////////////////////////////////////
 void Zowi::setTrims(int YL, int YR, int RL, int RR) {
-  servo[0].SetTrim(YL);
-  servo[1].SetTrim(YR);
-  servo[2].SetTrim(RL);
-  servo[3].SetTrim(RR);
+  servo.SetTrim(0, YL);
+  servo.SetTrim(1, YR);
+  servo.SetTrim(2, RL);
+  servo.SetTrim(3, RR);
 }
 
 void Zowi::saveTrimsOnEEPROM() {
   
   for (int i = 0; i < 4; i++){ 
-      EEPROM.write(i, servo[i].getTrim());
+      EEPROM.write(i, servo.getTrim(i));
   } 
       
 }
@@ -85,62 +138,160 @@ void Zowi::saveTrimsOnEEPROM() {
 ///////////////////////////////////////////////////////////////////
 void Zowi::_moveServos(int time, int  servo_target[]) {
 
+  velocity_mode = false;
+  _noiseStart(NOISE_KEY_MOVE);
   attachServos();
   if(getRestState()==true){
         setRestState(false);
   }
 
+  //-- Battery governor: slower moves, servo groups starting one after another
+  int scale = getPowerScale();
+  int groups = _powerGroups(scale);
+  time = (long)time * 256 / scale;
+
   if(time>10){
-    for (int i = 0; i < 4; i++) increment[i] = ((servo_target[i]) - servo_position[i]) / (time / 10.0);
-    final_time =  millis() + time;
+    int moving = 0;
+    for (int i = 0; i < 4; i++) {
+      if (servo_target[i] != servo_position[i]) moving++;
+    }
+    battery.setLoad(4, moving);
+    final_time =  millis() + time + (groups - 1) * POWER_STAGGER;
 
     for (int iteration = 1; millis() < final_time; iteration++) {
       partial_time = millis() + 10;
-      for (int i = 0; i < 4; i++) servo[i].SetPosition(servo_position[i] + (iteration * increment[i]));
-      while (millis() < partial_time); //pause
+      _holdServos();
+      for (int i = 0; i < 4; i++) {
+        //-- k steps of 10 ms on the line to the target, rounded down
+        int k = constrain(iteration - (i % groups) * (POWER_STAGGER / 10), 0, time / 10);
+        long moved = 10L * (servo_target[i] - servo_position[i]) * k;
+        servo.SetPosition(i, ((long)servo_position[i] * time + moved) / time);
+      }
+      _releaseServos();
+      while (millis() < partial_time) { //pause
+        battery.update();
+        _sense();
+      }
     }
+    battery.setLoad(4, 0);
   }
-  else{
-    for (int i = 0; i < 4; i++) servo[i].SetPosition(servo_target[i]);
-  }
+  _holdServos();
+  for (int i = 0; i < 4; i++) servo.SetPosition(i, servo_target[i]);
+  _releaseServos();
   for (int i = 0; i < 4; i++) servo_position[i] = servo_target[i];
 }
 
 
-void Zowi::oscillateServos(int A[4], int O[4], int T, double phase_diff[4], float cycle=1){
+#ifndef ZOWI_NO_FLOAT
+void Zowi::oscillateServos(int A[4], int O[4], int T, double phase_diff[4], float cycle){
+
+  unsigned int phase[4];
+  for (int i=0; i<4; i++) phase[i] = (long)(phase_diff[i] * (32768 / M_PI));
+  oscillateServos(A, O, T, phase, cycle > 0 ? cycle * ZOWI_STEP_FINE : 0);
+}
+#endif
 
+
+//-- oscillateServos, with the phases in 16 bits (1 turn = 65536) and
+//-- the cycles in 1/ZOWI_STEP_FINE
+void Zowi::oscillateServos(int A[4], int O[4], int T, const unsigned int phase[4], unsigned long cycle){
+
+  int moving = 0;
   for (int i=0; i<4; i++) {
-    servo[i].SetO(O[i]);
-    servo[i].SetA(A[i]);
-    servo[i].SetT(T);
-    servo[i].SetPh(phase_diff[i]);
+    servo.SetO(i, O[i]);
+    servo.SetA(i, A[i]);
+    servo.SetT(i, T);
+    servo.SetPhase(i, phase[i]);
+    if (A[i] != 0) moving++;
   }
-  double ref=millis();
-   for (double x=ref; x<=T*cycle+ref; x=millis()){
-     for (int i=0; i<4; i++){
-        servo[i].refresh();
-     }
+  battery.setLoad(4, moving);
+
+  //-- Following the beat: the cycle starts at the nearest beat
+  long beat = beat_follow ? beat_tracker->toBeat(millis()) : 0;
+  if (beat) {
+    unsigned long t = micros() + beat * 1000;
+    for (int i=0; i<4; i++) servo.Align(i, t);
+  }
+
+  //-- Battery governor: with several groups, the groups take turns,
+  //--   a servo frame each, so that their current peaks do not add up
+  int groups = _powerGroups(getPowerScale());
+  unsigned long duration = (unsigned long)T * (cycle / ZOWI_STEP_FINE) + (unsigned long)T * (cycle % ZOWI_STEP_FINE) / ZOWI_STEP_FINE;
+  unsigned long ref=millis();
+  while (millis() - ref <= duration) {
+     servo.refresh(_powerJoints(groups));
+     battery.update();
+     _sense();
   }
+  battery.setLoad(4, 0);
 }
 
 
-void Zowi::_execute(int A[4], int O[4], int T, double phase_diff[4], float steps = 1.0){
+//-- Oscillate a gait of Zowi_motions.h with height h
+void Zowi::_execute(const ZowiGait *gait, int h, int T, ZowiSteps steps){
 
+  velocity_mode = false;
   attachServos();
   if(getRestState()==true){
         setRestState(false);
   }
 
+  //-- The gait, from flash
+  ZowiGait g;
+  memcpy_P(&g, gait, sizeof(ZowiGait));
+  if (g.hmax) h = min(h, (int)g.hmax);
+
+  _noiseStart(_noiseKey(gait, T, h));   //-- For the servo noise model
+
+  //-- Battery governor: smaller (closer to home) and slower oscillations
+  int scale = getPowerScale();
+  int A2[4], O2[4];
+  unsigned int phase[4];
+  for (int i = 0; i < 4; i++) {
+    A2[i] = (long)(g.A[i] + g.Ah[i] * h / 2) * scale >> 8;
+    O2[i] = (long)(g.O[i] + g.Oh[i] * h / 2) * scale >> 8;
+    phase[i] = g.ph[i];
+  }
+  T = (long)T * 256 / scale;
+
+  //-- Following the beat: a whole number of beats per cycle
+  unsigned int beat = beat_follow ? beat_tracker->period() : 0;
+  if (beat) T = max(((long)T + beat / 2) / beat, 1L) * beat;
+
+  //-- Dead reckoning of walk and turn, smaller with the battery
+  if (nav) {
+    nav->turn = nav->walk = 0;
+    if (gait == &motion_walk[0] || gait == &motion_walk[1]) {
+      nav->walk = (gait == &motion_walk[0] ? NAV_WALK_STEP : -NAV_WALK_STEP) * POLAR_FINE;
+    }
+    else if (gait == &motion_turn[0] || gait == &motion_turn[1]) {
+      nav->turn = (gait == &motion_turn[0] ? 1 : -1) * (int)(NAV_TURN_STEP * 65536L / 360);
+      nav->walk = NAV_TURN_WALK * POLAR_FINE;
+    }
+    nav->turn = (long)nav->turn * scale >> 8;
+    nav->walk = (long)nav->walk * scale >> 8;
+    nav->T = T;
+    nav->turn_rest = nav->walk_rest = 0;
+    nav->time = millis();
+  }
 
-  int cycles=(int)steps;    
+  //-- Blend from the previous motion (or position) into this one
+  if (transition_time) servo.Crossfade(transition_time);
+
+  //-- 256 steps and more do not fit in 16 bits
+  unsigned long cycles = steps > 0 ? steps * (unsigned long)ZOWI_STEP_FINE : 0;
 
   //-- Execute complete cycles
-  if (cycles >= 1) 
-    for(int i = 0; i < cycles; i++) 
-      oscillateServos(A,O, T, phase_diff);
-      
-  //-- Execute the final not complete cycle    
-  oscillateServos(A,O, T, phase_diff,(float)steps-cycles);
+  for (unsigned long i = 0; i < cycles / ZOWI_STEP_FINE; i++)
+    oscillateServos(A2,O2, T, phase);
+
+  //-- Execute the final not complete cycle
+  oscillateServos(A2,O2, T, phase, cycles % ZOWI_STEP_FINE);
+  noise_key = NOISE_KEY_MOVE;
+  if (nav) {
+    if (nav->turn || nav->walk) _navigate(millis());
+    nav->turn = nav->walk = 0;
+  }
 }
 
 
@@ -181,7 +332,7 @@ void Zowi::setRestState(bool state){
 //--    steps: Number of steps
 //--    T: Period
 //---------------------------------------------------------
-void Zowi::jump(float steps, int T){
+void Zowi::jump(ZowiSteps steps, int T){
 
   int up[]={90,90,150,30};
   _moveServos(T,up);
@@ -197,7 +348,7 @@ void Zowi::jump(float steps, int T){
 //--    * T : Period
 //--    * Dir: Direction: FORWARD / BACKWARD
 //---------------------------------------------------------
-void Zowi::walk(float steps, int T, int dir){
+void Zowi::walk(ZowiSteps steps, int T, int dir){
 
   //-- Oscillator parameters for walking
   //-- Hip sevos are in phase
@@ -206,12 +357,10 @@ void Zowi::walk(float steps, int T, int dir){
   //--      -90 : Walk forward
   //--       90 : Walk backward
   //-- Feet servos also have the same offset (for tiptoe a little bit)
-  int A[4]= {30, 30, 20, 20};
-  int O[4] = {0, 0, 4, -4};
-  double phase_diff[4] = {0, 0, DEG2RAD(dir * -90), DEG2RAD(dir * -90)};
+  //-- (motion_walk, Zowi_motions.h)
 
   //-- Let's oscillate the servos!
-  _execute(A, O, T, phase_diff, steps);  
+  _execute(&motion_walk[dir == BACKWARD], 0, T, steps);
 }
 
 
@@ -222,28 +371,16 @@ void Zowi::walk(float steps, int T, int dir){
 //--   * T: Period
 //--   * Dir: Direction: LEFT / RIGHT
 //---------------------------------------------------------
-void Zowi::turn(float steps, int T, int dir){
+void Zowi::turn(ZowiSteps steps, int T, int dir){
 
   //-- Same coordination than for walking (see Zowi::walk)
   //-- The Amplitudes of the hip's oscillators are not igual
   //-- When the right hip servo amplitude is higher, the steps taken by
   //--   the right leg are bigger than the left. So, the robot describes an 
-  //--   left arc
-  int A[4]= {30, 30, 20, 20};
-  int O[4] = {0, 0, 4, -4};
-  double phase_diff[4] = {0, 0, DEG2RAD(-90), DEG2RAD(-90)}; 
-    
-  if (dir == LEFT) {  
-    A[0] = 30; //-- Left hip servo
-    A[1] = 10; //-- Right hip servo
-  }
-  else {
-    A[0] = 10;
-    A[1] = 30;
-  }
-    
+  //--   left arc (motion_turn, Zowi_motions.h)
+
   //-- Let's oscillate the servos!
-  _execute(A, O, T, phase_diff, steps); 
+  _execute(&motion_turn[dir != LEFT], 0, T, steps);
 }
 
 
@@ -281,7 +418,7 @@ void Zowi::bend (int steps, int T, int dir){
   {
     _moveServos(T2/2,bend1);
     _moveServos(T2/2,bend2);
-    delay(T*0.8);
+    delay((long)T*4/5);
     _moveServos(500,homes);
   }
 
@@ -350,18 +487,15 @@ void Zowi::shakeLeg (int steps,int T,int dir){
 //--    * h: Jump height: SMALL / MEDIUM / BIG 
 //--              (or a number in degrees 0 - 90)
 //---------------------------------------------------------
-void Zowi::updown(float steps, int T, int h){
+void Zowi::updown(ZowiSteps steps, int T, int h){
 
   //-- Both feet are 180 degrees out of phase
   //-- Feet amplitude and offset are the same
   //-- Initial phase for the right foot is -90, so that it starts
   //--   in one extreme position (not in the middle)
-  int A[4]= {0, 0, h, h};
-  int O[4] = {0, 0, h, -h};
-  double phase_diff[4] = {0, 0, DEG2RAD(-90), DEG2RAD(90)};
-  
+
   //-- Let's oscillate the servos!
-  _execute(A, O, T, phase_diff, steps); 
+  _execute(&motion_updown, h, T, steps);
 }
 
 
@@ -372,16 +506,13 @@ void Zowi::updown(float steps, int T, int h){
 //--     T : Period
 //--     h : Amount of swing (from 0 to 50 aprox)
 //---------------------------------------------------------
-void Zowi::swing(float steps, int T, int h){
+void Zowi::swing(ZowiSteps steps, int T, int h){
 
   //-- Both feets are in phase. The offset is half the amplitude
   //-- It causes the robot to swing from side to side
-  int A[4]= {0, 0, h, h};
-  int O[4] = {0, 0, h/2, -h/2};
-  double phase_diff[4] = {0, 0, DEG2RAD(0), DEG2RAD(0)};
-  
+
   //-- Let's oscillate the servos!
-  _execute(A, O, T, phase_diff, steps); 
+  _execute(&motion_swing, h, T, steps);
 }
 
 
@@ -392,16 +523,13 @@ void Zowi::swing(float steps, int T, int h){
 //--     T : Period
 //--     h : Amount of swing (from 0 to 50 aprox)
 //---------------------------------------------------------
-void Zowi::tiptoeSwing(float steps, int T, int h){
+void Zowi::tiptoeSwing(ZowiSteps steps, int T, int h){
 
   //-- Both feets are in phase. The offset is not half the amplitude in order to tiptoe
   //-- It causes the robot to swing from side to side
-  int A[4]= {0, 0, h, h};
-  int O[4] = {0, 0, h, -h};
-  double phase_diff[4] = {0, 0, 0, 0};
-  
+
   //-- Let's oscillate the servos!
-  _execute(A, O, T, phase_diff, steps); 
+  _execute(&motion_tiptoeSwing, h, T, steps);
 }
 
 
@@ -412,20 +540,16 @@ void Zowi::tiptoeSwing(float steps, int T, int h){
 //--    T: Period of one jitter 
 //--    h: height (Values between 5 - 25)   
 //---------------------------------------------------------
-void Zowi::jitter(float steps, int T, int h){
+void Zowi::jitter(ZowiSteps steps, int T, int h){
 
   //-- Both feet are 180 degrees out of phase
   //-- Feet amplitude and offset are the same
   //-- Initial phase for the right foot is -90, so that it starts
   //--   in one extreme position (not in the middle)
-  //-- h is constrained to avoid hit the feets
-  h=min(25,h);
-  int A[4]= {h, h, 0, 0};
-  int O[4] = {0, 0, 0, 0};
-  double phase_diff[4] = {DEG2RAD(-90), DEG2RAD(90), 0, 0};
-  
+  //-- h is constrained to avoid hit the feets (hmax)
+
   //-- Let's oscillate the servos!
-  _execute(A, O, T, phase_diff, steps); 
+  _execute(&motion_jitter, h, T, steps);
 }
 
 
@@ -436,19 +560,15 @@ void Zowi::jitter(float steps, int T, int h){
 //--    T: Period of one bend
 //--    h: height (Values between 5 - 15) 
 //---------------------------------------------------------
-void Zowi::ascendingTurn(float steps, int T, int h){
+void Zowi::ascendingTurn(ZowiSteps steps, int T, int h){
 
   //-- Both feet and legs are 180 degrees out of phase
   //-- Initial phase for the right foot is -90, so that it starts
   //--   in one extreme position (not in the middle)
-  //-- h is constrained to avoid hit the feets
-  h=min(13,h);
-  int A[4]= {h, h, h, h};
-  int O[4] = {0, 0, h+4, -h+4};
-  double phase_diff[4] = {DEG2RAD(-90), DEG2RAD(90), DEG2RAD(-90), DEG2RAD(90)};
-  
+  //-- h is constrained to avoid hit the feets (hmax)
+
   //-- Let's oscillate the servos!
-  _execute(A, O, T, phase_diff, steps); 
+  _execute(&motion_ascendingTurn, h, T, steps);
 }
 
 
@@ -460,7 +580,7 @@ void Zowi::ascendingTurn(float steps, int T, int h){
 //--    h: Height. Typical valures between 15 and 40
 //--    dir: Direction: LEFT / RIGHT
 //---------------------------------------------------------
-void Zowi::moonwalker(float steps, int T, int h, int dir){
+void Zowi::moonwalker(ZowiSteps steps, int T, int h, int dir){
 
   //-- This motion is similar to that of the caterpillar robots: A travelling
   //-- wave moving from one side to another
@@ -471,14 +591,9 @@ void Zowi::moonwalker(float steps, int T, int h, int dir){
   //--  is 60 degrees.
   //--  Both amplitudes are equal. The offset is half the amplitud plus a little bit of
   //-   offset so that the robot tiptoe lightly
- 
-  int A[4]= {0, 0, h, h};
-  int O[4] = {0, 0, h/2+2, -h/2 -2};
-  int phi = -dir * 90;
-  double phase_diff[4] = {0, 0, DEG2RAD(phi), DEG2RAD(-60 * dir + phi)};
-  
+
   //-- Let's oscillate the servos!
-  _execute(A, O, T, phase_diff, steps); 
+  _execute(&motion_moonwalker[dir != LEFT], h, T, steps);
 }
 
 
@@ -490,14 +605,10 @@ void Zowi::moonwalker(float steps, int T, int h, int dir){
 //--     h: height (Values between 20 - 50)
 //--     dir:  Direction: LEFT / RIGHT
 //-----------------------------------------------------------
-void Zowi::crusaito(float steps, int T, int h, int dir){
+void Zowi::crusaito(ZowiSteps steps, int T, int h, int dir){
 
-  int A[4]= {25, 25, h, h};
-  int O[4] = {0, 0, h/2+ 4, -h/2 - 4};
-  double phase_diff[4] = {90, 90, DEG2RAD(0), DEG2RAD(-60 * dir)};
-  
   //-- Let's oscillate the servos!
-  _execute(A, O, T, phase_diff, steps); 
+  _execute(&motion_crusaito[dir != FORWARD], h, T, steps);
 }
 
 
@@ -509,19 +620,101 @@ void Zowi::crusaito(float steps, int T, int h, int dir){
 //--    h: height (Values between 10 - 30)
 //--    dir: direction: FOREWARD, BACKWARD
 //---------------------------------------------------------
-void Zowi::flapping(float steps, int T, int h, int dir){
+void Zowi::flapping(ZowiSteps steps, int T, int h, int dir){
 
-  int A[4]= {12, 12, h, h};
-  int O[4] = {0, 0, h - 10, -h + 10};
-  double phase_diff[4] = {DEG2RAD(0), DEG2RAD(180), DEG2RAD(-90 * dir), DEG2RAD(90 * dir)};
-  
   //-- Let's oscillate the servos!
-  _execute(A, O, T, phase_diff, steps); 
+  _execute(&motion_flapping[dir != FORWARD], h, T, steps);
 }
 
 
+//---------------------------------------------------------
+//-- Zowi gait: Velocity mode (joystick control)
+//--  The walk of Zowi::walk and Zowi::turn, with continuous
+//--  parameters. setVelocity() changes the gait and returns;
+//--  update() must be called in the loop to move the servos.
+//--  A new velocity is applied at the next servo sample, with
+//--  no restart of the gait
+//--  Parameters:
+//--    * v: Forward speed, -100 (backward) to 100
+//--    * w: Turn rate, -100 (RIGHT) to 100 (LEFT)
+//---------------------------------------------------------
+void Zowi::setVelocity(int v, int w){
+
+  v = constrain(v, -100, 100);
+  w = constrain(w, -100, 100);
+
+  //-- Speed: the size of the steps and their rate. At full speed,
+  //--   the walk of Zowi::walk (T = 1000); slower steps are shorter
+  //--   and longer in time, up to T = 2000
+  int s = max(abs(v), abs(w));
+  int T = VELOCITY_TMAX - (long)(VELOCITY_TMAX - VELOCITY_TMIN) * s / 100;
+
+  //-- Turn: the inner hip makes shorter steps, down to 1/3 of the
+  //--   outer one (30 / 10 in Zowi::turn). The feet reach their full
+  //--   amplitude at a quarter of the speed, so that slow steps still
+  //--   lift the feet
+  int outer = 30 * s / 100;
+  int inner = s ? outer - (long)outer * 2 * abs(w) / (3 * s) : 0;
+  int feet = min(s * 4, 100);
+
+  int A[4], O[4];
+  A[0] = w >= 0 ? outer : inner;   //-- Left hip servo
+  A[1] = w >= 0 ? inner : outer;   //-- Right hip servo
+  A[2] = 20 * feet / 100;
+  A[3] = A[2];
+  O[0] = 0;
+  O[1] = 0;
+  O[2] = 4 * feet / 100;
+  O[3] = -O[2];
+
+  //-- Battery governor, as in _execute
+  int scale = getPowerScale();
+  for (int i = 0; i < 4; i++) {
+    A[i] = (long)A[i] * scale >> 8;
+    O[i] = (long)O[i] * scale >> 8;
+  }
+  T = (long)T * 256 / scale;
+
+  //-- Entering the mode, or going the other way: a crossfade (the
+  //--   phase of the feet changes by half a turn)
+  int dir = v < 0 ? BACKWARD : FORWARD;
+  if (!velocity_mode || dir != velocity_dir) {
+    attachServos();
+    if(getRestState()==true){
+        setRestState(false);
+    }
+    servo.Crossfade(transition_time ? transition_time : VELOCITY_FADE);
+    velocity_mode = true;
+    _noiseStart(NOISE_KEY_VELOCITY);
+    velocity_dir = dir;
+  }
+
+  int moving = 0;
+  for (int i = 0; i < 4; i++) {
+    servo.SetA(i, A[i]);
+    servo.SetO(i, O[i]);
+    servo.SetT(i, T);
+    if (A[i] != 0) moving++;
+  }
+  for (int i = 0; i < 4; i++)
+    servo.SetPhase(i, pgm_read_word(&motion_walk[dir == BACKWARD].ph[i]));
+  battery.setLoad(4, moving);
+}
+
 
+//---------------------------------------------------------
+//-- Zowi update: move the servos in velocity mode and run the
+//--  sensor scheduler. It takes a sample when one is due and
+//--  returns at once otherwise
+//---------------------------------------------------------
+void Zowi::update(){
 
+  if (velocity_mode) {
+    servo.refresh(_powerJoints(_powerGroups(getPowerScale())));
+    battery.update();
+  }
+  _sense();
+}
 
 
 ///////////////////////////////////////////////////////////////////
@@ -529,11 +722,36 @@ void Zowi::flapping(float steps, int T, int h, int dir){
 ///////////////////////////////////////////////////////////////////
 
 //---------------------------------------------------------
-//-- Zowi getDistance: return zowi's ultrasonic sensor measure
+//-- Zowi getDistanceCm: return zowi's ultrasonic sensor measure, in cm
+//---------------------------------------------------------
+unsigned int Zowi::getDistanceCm(){
+
+  return us.readCm();
+}
+
+
+//---------------------------------------------------------
+//-- Zowi distanceEdge: call it from a pin-change interrupt on both
+//--  edges of PIN_Echo, e.g.
+//--    enableInterrupt(PIN_Echo, echoEdge, CHANGE);
+//--  with echoEdge() calling zowi.distanceEdge(). The echoes are then
+//--  timed by the interrupt, and a blocking motion or sound does not
+//--  lose them (see US::edge)
 //---------------------------------------------------------
-float Zowi::getDistance(){
+void Zowi::distanceEdge(){
 
-  return us.read();
+  us.edge();
+}
+
+
+//---------------------------------------------------------
+//-- Zowi getDistanceDropped: measures of the sensor scheduler given
+//--  up, with no distance, because the echo was not followed (no
+//--  distanceEdge() and _sense() not called for US_POLL_GAP)
+//---------------------------------------------------------
+unsigned int Zowi::getDistanceDropped(){
+
+  return us.dropped();
 }
 
 
@@ -560,41 +778,690 @@ int Zowi::getNoise(){
 
 
 //---------------------------------------------------------
-//-- Zowi getBatteryLevel: return battery voltage percent
+//-- Zowi senseDistanceAt: ping the ultrasonic sensor every
+//--  SENSE_PING_PERIOD while all the events of the mask hold,
+//--  e.g. PHASE_FEET_FLAT: the beam is level, not on the floor
+//--  or the ceiling. The readings come in getDistanceReading()
+//---------------------------------------------------------
+void Zowi::senseDistanceAt(uint8_t events){
+
+  distance_at = events;
+  sense_distance = true;
+}
+
+
+//---------------------------------------------------------
+//-- Zowi senseNoiseAt: windows of SENSE_NOISE_SAMPLES noise
+//--  samples while all the events of the mask hold, e.g.
+//--  PHASE_QUIET: no servo noise. A window is dropped when an
+//--  event ends before it is full. The mean of each window
+//--  comes in getNoiseReading(), with the servo noise expected
+//--  there. With SENSE_ANY the windows go on while Zowi moves:
+//--  value - expected is what the room made, and the model of
+//--  the servo noise learns from every window
 //---------------------------------------------------------
-double Zowi::getBatteryLevel(){
+void Zowi::senseNoiseAt(uint8_t events){
 
-  //The first read of the batery is often a wrong reading, so we will discard this value. 
-    double batteryLevel = battery.readBatPercent();
-    double batteryReadings = 0;
-    int numReadings = 10;
+  noise_at = events;
+  noise_count = 0;
+  sense_noise = true;
+}
 
-    for(int i=0; i<numReadings; i++){
-        batteryReadings += battery.readBatPercent();
-        delay(1); // delay in between reads for stability
-    }
 
-    batteryLevel = batteryReadings / numReadings;
+void Zowi::stopSensing(){
 
-    return batteryLevel;
+  sense_distance = sense_noise = false;
+  noise_count = 0;
 }
 
 
-double Zowi::getBatteryVoltage(){
+//-- PHASE_* events at the last servo frame
+uint8_t Zowi::getPhaseEvents(){
 
-  //The first read of the batery is often a wrong reading, so we will discard this value. 
-    double batteryLevel = battery.readBatVoltage();
-    double batteryReadings = 0;
-    int numReadings = 10;
+  _sense();
+  return phase_events;
+}
 
-    for(int i=0; i<numReadings; i++){
-        batteryReadings += battery.readBatVoltage();
-        delay(1); // delay in between reads for stability
+
+//---------------------------------------------------------
+//-- Zowi getDistanceReading: the last ultrasonic reading of
+//--  the scheduler and its phase tag. True when it is new
+//--  (once per reading)
+//---------------------------------------------------------
+bool Zowi::getDistanceReading(ZowiReading &reading){
+
+  if (!distance_new) return false;
+  reading = distance_reading;
+  distance_new = false;
+  return true;
+}
+
+
+bool Zowi::getNoiseReading(ZowiReading &reading){
+
+  if (!noise_new) return false;
+  reading = noise_reading;
+  noise_new = false;
+  return true;
+}
+
+
+//---------------------------------------------------------
+//-- Zowi getNoisePeak: the loudest noise reading since the
+//--  last call, servo noise removed (0 with no readings). For
+//--  sounds heard during the motions, e.g. a clap while Zowi
+//--  dances
+//---------------------------------------------------------
+int Zowi::getNoisePeak(){
+
+  _sense();
+  int peak = noise_peak;
+  noise_peak = 0;
+  return peak;
+}
+
+
+//---------------------------------------------------------
+//-- Zowi attachNoiseModel: a servo noise model of the sketch
+//--  (NoiseModel noise; zowi.attachNoiseModel(&noise); after
+//--  zowi.init()). It
+//--  learns the noise of the servos at each motion state and
+//--  phase, and the noise readings (getNoisePeak, the beat and
+//--  the claps) have it removed. 0 detaches it: the readings
+//--  are the raw noise
+//---------------------------------------------------------
+void Zowi::attachNoiseModel(NoiseModel *model){
+
+  noise_model = model;
+}
+
+
+//-- Forget the servo noise learnt, e.g. in a room with other noise
+void Zowi::resetNoiseModel(){
+
+  if (noise_model) noise_model->begin();
+}
+
+
+//---------------------------------------------------------
+//-- Zowi attachBeatTracker: the beat tracker of the sketch
+//--  (BeatTracker beat; zowi.attachBeatTracker(&beat); after
+//--  zowi.init()), for followBeat. 0 detaches it, and the
+//--  beat is not followed any more
+//---------------------------------------------------------
+void Zowi::attachBeatTracker(BeatTracker *tracker){
+
+  beat_tracker = tracker;
+  if (!tracker) beat_follow = false;
+}
+
+
+//---------------------------------------------------------
+//-- Zowi followBeat: track the beat of the music in the
+//--  noise readings (senseNoiseAt(SENSE_ANY) is started if
+//--  the noise is not sensed). While it is followed, the
+//--  gaits take a whole number of beats per cycle and every
+//--  cycle starts on a beat. The tempo takes 1 - 4 s of music.
+//--  Nothing is followed with no tracker attached
+//---------------------------------------------------------
+void Zowi::followBeat(bool follow){
+
+  if (!beat_tracker) return;
+  if (follow && !beat_follow) {
+    beat_tracker->begin();
+    beat_new = false;
+    if (!sense_noise) senseNoiseAt(SENSE_ANY);
+  }
+  beat_follow = follow;
+}
+
+
+unsigned int Zowi::getTempo(){
+
+  _sense();
+  return beat_follow ? beat_tracker->bpm() : 0;
+}
+
+
+//-- True once per beat, while the beat is followed
+bool Zowi::getBeat(){
+
+  _sense();
+  bool beat = beat_new;
+  beat_new = false;
+  return beat;
+}
+
+
+//---------------------------------------------------------
+//-- Zowi attachClapPattern: the clap recogniser of the
+//--  sketch (ClapPattern claps; zowi.attachClapPattern(&claps);
+//--  after zowi.init()), for setClapCommand. 0 detaches it
+//---------------------------------------------------------
+void Zowi::attachClapPattern(ClapPattern *claps){
+
+  clap_pattern = claps;
+}
+
+
+//---------------------------------------------------------
+//-- Zowi setClapCommand: a command (1 - 255) for a rhythm
+//--  of claps, 0 to remove it. The rhythm has an x per clap
+//--  and a - before a long gap, e.g. "xx", "xxx" or "x-xx".
+//--  The claps are heard in the noise readings, also while
+//--  Zowi moves (senseNoiseAt(SENSE_ANY) is started if the
+//--  noise is not sensed). False if the rhythm is not valid,
+//--  there are CLAP_PATTERNS already or no recogniser is
+//--  attached
+//---------------------------------------------------------
+bool Zowi::setClapCommand(const char *rhythm, uint8_t command){
+
+  if (!clap_pattern) return false;
+  if (!sense_noise) senseNoiseAt(SENSE_ANY);
+  return clap_pattern->setPattern(rhythm, command);
+}
+
+
+//-- The command of the last rhythm clapped, once (0 = none)
+uint8_t Zowi::getClapCommand(){
+
+  _sense();
+  uint8_t command = clap_command;
+  clap_command = 0;
+  return command;
+}
+
+
+//---------------------------------------------------------
+//-- Zowi attachHandGesture: the hand gesture recogniser of
+//--  the sketch (HandGesture hand; zowi.attachHandGesture(&hand);
+//--  after zowi.init()), for getHandGesture. 0 detaches it
+//---------------------------------------------------------
+void Zowi::attachHandGesture(HandGesture *hand){
+
+  hand_gesture = hand;
+  hand_event = HAND_NONE;
+  if (hand) hand->begin();
+}
+
+
+//---------------------------------------------------------
+//-- Zowi getHandGesture: the last gesture of a hand in front
+//--  of the ultrasonic sensor, once: HAND_APPROACH,
+//--  HAND_RETREAT, HAND_HOLD or HAND_SWIPE (HAND_NONE = none).
+//--  The hand is followed in the distance readings taken while
+//--  Zowi is still (senseDistanceAt(SENSE_ANY) is started if the
+//--  distance is not sensed); a motion starts it again. Always
+//--  HAND_NONE with no recogniser attached
+//---------------------------------------------------------
+uint8_t Zowi::getHandGesture(){
+
+  if (!hand_gesture) return HAND_NONE;
+  if (!sense_distance) senseDistanceAt(SENSE_ANY);
+  _sense();
+  uint8_t gesture = hand_event;
+  hand_event = HAND_NONE;
+  return gesture;
+}
+
+
+//---------------------------------------------------------
+//-- Zowi getOpenDirection: the most open way in the map of
+//--  the obstacles, in degrees from the heading (LEFT turns
+//--  are positive, up to 180). The map is made of the distance
+//--  readings of the scheduler (senseDistanceAt), by the heading
+//--  of Zowi, dead-reckoned from the cycles of walk() and turn()
+//--  (NAV_*). Zowi turns no more than it needs; a way with no
+//--  readings is worth trying, but less than one seen open.
+//--  0 (ahead) with no map attached
+//---------------------------------------------------------
+int Zowi::getOpenDirection(){
+
+  if (!nav) return 0;
+  _sense();
+  return (long)(int16_t)(nav->map.best(nav->heading) - nav->heading) * 360 >> 16;
+}
+
+
+//-- The distance to the obstacle in a direction (degrees from
+//--  the heading, LEFT positive), cm; 0 when it is unknown
+unsigned int Zowi::getMapDistance(int direction){
+
+  if (!nav) return 0;
+  _sense();
+  return nav->map.distance(nav->heading + (uint16_t)(direction * 65536L / 360));
+}
+
+
+//-- Degrees, since attachMap() or resetMap(); 0 with no map
+unsigned int Zowi::getHeading(){
+
+  return nav ? (unsigned long)nav->heading * 360 >> 16 : 0;
+}
+
+
+//---------------------------------------------------------
+//-- Zowi attachMap: the map of the obstacles of the sketch
+//--  (ZowiMap map; zowi.attachMap(&map); after zowi.init()),
+//--  for getOpenDirection and getMapDistance. It starts empty,
+//--  at heading 0, and the dead reckoning starts with the next
+//--  motion. 0 detaches it
+//---------------------------------------------------------
+void Zowi::attachMap(ZowiMap *map){
+
+  nav = map;
+  if (nav) {
+    nav->turn = nav->walk = 0;
+    resetMap();
+  }
+}
+
+
+//-- Forget the map, e.g. when Zowi is taken to another place
+void Zowi::resetMap(){
+
+  if (!nav) return;
+  nav->map.begin();
+  nav->heading = 0;
+}
+
+
+//-- Dead reckoning: the heading and the walk of the motion
+//--  running, by the time it has run
+void Zowi::_navigate(unsigned long now){
+
+  long dt = now - nav->time;
+  nav->time = now;
+
+  nav->turn_rest += (long)nav->turn * dt;
+  nav->heading += nav->turn_rest / nav->T;
+  nav->turn_rest %= nav->T;
+
+  nav->walk_rest += (long)nav->walk * dt;
+  int cm = nav->walk_rest / ((long)nav->T * POLAR_FINE);
+  if (cm) {
+    nav->map.moved(nav->heading, cm);
+    nav->walk_rest -= (long)cm * nav->T * POLAR_FINE;
+  }
+}
+
+
+//-- Motion state of a gait for the noise model: different gaits,
+//--  periods or heights sound different
+unsigned int Zowi::_noiseKey(const void *gait, int T, int h){
+
+  return 0x8000 | (((uintptr_t)gait ^ ((unsigned int)T << 4) ^ h) & 0x7FFF);
+}
+
+
+//-- A motion starts: its motion state, and no claps heard while
+//--  the servos start
+void Zowi::_noiseStart(unsigned int key){
+
+  noise_key = key;
+  if (clap_pattern) clap_pattern->ignore(millis() + NOISE_START_TIME);
+}
+
+
+//-- Phase events from the positions of the joints, once per servo frame
+void Zowi::_phaseEvents(unsigned long now){
+
+  //-- Speed of all the joints together, 1/OSCILLATOR_FINE degrees
+  unsigned int moved = 0;
+  for (int i = 0; i < 4; i++) {
+    int pos = servo.getPosition(i);
+    moved += abs(pos - phase_pos[i]);
+    phase_pos[i] = pos;
+  }
+  phase_speed = min((unsigned long)moved * 1000 / (OSCILLATOR_FINE * (now - phase_time)), 0x7FFFUL);
+  if (phase_speed > PHASE_QUIET_SPEED) quiet_time = now;
+  phase_time = now;
+  if (nav && (nav->turn || nav->walk)) _navigate(now);
+
+  //-- The feet roll the same way (the servos of RR are reversed):
+  //--  the body is level when the mean roll is zero
+  int roll = (servo.getPosition(2) + servo.getPosition(3)) / 2;
+  phase_events = 0;
+  if (abs(roll) <= PHASE_LEVEL * OSCILLATOR_FINE) phase_events |= PHASE_FEET_FLAT;
+  if (now - quiet_time >= PHASE_QUIET_TIME) phase_events |= PHASE_QUIET;
+}
+
+
+//-- Phase tag of a reading starting now
+void Zowi::_tag(ZowiReading &reading, unsigned long now){
+
+  reading.events = phase_events;
+  reading.phase = (gait_layer.playing() ? gait_layer.getPhase() : servo.getPhase(0)) >> 8;
+  reading.time = now;
+}
+
+
+//---------------------------------------------------------
+//-- Zowi _sense: the sensor scheduler. Called by the motion
+//--  loops and update(): the phase events every servo frame,
+//--  the echo of the ultrasonic sensor (never waited for) and
+//--  one noise sample when one is due
+//---------------------------------------------------------
+void Zowi::_sense(){
+
+  unsigned long now = millis();
+  if (now - phase_time >= OSCILLATOR_FRAME) _phaseEvents(now);
+
+  //-- Ultrasonic sensor
+  if (us.update()) {
+    distance_reading = distance_tag;
+    distance_reading.value = us.cm();
+    distance_new = true;
+
+    //-- The steps of Zowi move the distances too: no hand then
+    if (hand_gesture) {
+      if (distance_reading.events & PHASE_QUIET) {
+        uint8_t gesture = hand_gesture->update(distance_reading.time, distance_reading.value);
+        if (gesture) hand_event = gesture;
+      }
+      else hand_gesture->begin();
     }
+    if (nav) nav->map.reading(nav->heading, distance_reading.value);
+  }
+  if (sense_distance && !us.busy() && (phase_events & distance_at) == distance_at &&
+      now - distance_tag.time >= SENSE_PING_PERIOD && us.ping())
+    _tag(distance_tag, now);
+
+  //-- Noise sensor
+  if (!sense_noise) return;
+  if ((phase_events & noise_at) != noise_at) {
+    noise_count = 0;
+    return;
+  }
+  if (now - noise_time < SENSE_NOISE_PERIOD) return;
+  noise_time = now;
+  if (!noise_count) {
+    _tag(noise_tag, now);
+    noise_sum = 0;
+
+    //-- Motion state of the window: at rest, a gait and its phase, or
+    //--  a motion with no cycle and the speed of the joints
+    noise_state = phase_events & PHASE_QUIET ? NOISE_REST : noise_key;
+    noise_phase = noise_key == NOISE_KEY_MOVE ? min((long)phase_speed * 256 / NOISE_SPEED_MAX, 255L) : noise_tag.phase;
+  }
+  noise_sum += analogRead(pinNoiseSensor);
+  if (++noise_count == SENSE_NOISE_SAMPLES) {
+    noise_reading = noise_tag;
+    noise_reading.value = noise_sum / SENSE_NOISE_SAMPLES;
+    noise_reading.expected = noise_model ? noise_model->update(noise_state, noise_phase, noise_reading.value) : 0;
+    noise_peak = max(noise_peak, noise_reading.value - noise_reading.expected);
+    if (beat_follow && beat_tracker->update(noise_reading.time, noise_reading.value - noise_reading.expected))
+      beat_new = true;
+    if (clap_pattern) {
+      uint8_t command = clap_pattern->update(noise_reading.time, noise_reading.value - noise_reading.expected);
+      if (command) clap_command = command;
+    }
+    noise_new = true;
+    noise_count = 0;
+  }
+}
+
+
+//---------------------------------------------------------
+//-- Zowi getBatteryPercent: return battery voltage percent
+//--  Filtered and compensated for the servo load (see BatReader)
+//---------------------------------------------------------
+unsigned char Zowi::getBatteryPercent(){
+
+  battery.update();
+  return battery.level();
+}
+
+
+//-- In mV
+unsigned int Zowi::getBatteryMillivolts(){
+
+  battery.update();
+  return battery.voltage();
+}
+
+
+//---------------------------------------------------------
+//-- Zowi getBatteryRuntime: minutes left at the current
+//--  discharge rate, BAT_RUNTIME_UNKNOWN during the first minutes
+//---------------------------------------------------------
+unsigned int Zowi::getBatteryRuntime(){
+
+  battery.update();
+  return battery.runtime();
+}
+
+
+///////////////////////////////////////////////////////////////////
+//-- BATTERY GOVERNOR -------------------------------------------//
+///////////////////////////////////////////////////////////////////
+
+//---------------------------------------------------------
+//-- Zowi setPowerPolicy: how the motions are throttled when
+//--  the battery runs low, to avoid brownout resets
+//--    * POWER_OFF: never
+//--    * POWER_BALANCED: from 3.6 V, down to 62% speed and
+//--        size of the motions and two servos at once at 3.3 V
+//--    * POWER_SAVE: from 3.8 V, down to 50% and one servo at 3.4 V
+//---------------------------------------------------------
+void Zowi::setPowerPolicy(int policy){
+
+  switch(policy){
+    case POWER_OFF:
+      setPowerLimits(0, 0, 256, 4);
+    break;
+
+    case POWER_SAVE:
+      setPowerLimits(3800, 3400, 128, 1);
+    break;
+
+    default:
+      setPowerLimits(3600, 3300, 160, 2);
+    break;
+  }
+}
+
+
+//---------------------------------------------------------
+//-- Zowi setPowerLimits: custom policy
+//--  Parameters:
+//--    * fullVoltage: mV, no throttling above
+//--    * lowVoltage: mV, full throttling below
+//--    * minScale: speed and amplitude at lowVoltage (x/256)
+//--    * maxMoving: servos starting at once at lowVoltage (1-4)
+//---------------------------------------------------------
+void Zowi::setPowerLimits(int fullVoltage, int lowVoltage, int minScale, int maxMoving){
+
+  power_full = fullVoltage;
+  power_low = lowVoltage;
+  power_min_scale = constrain(minScale, 16, 256);
+  power_max_moving = constrain(maxMoving, 1, 4);
+}
+
+
+//---------------------------------------------------------
+//-- Zowi getPowerScale: speed and amplitude allowed by the
+//--  battery right now, 256 = no throttling
+//---------------------------------------------------------
+int Zowi::getPowerScale(){
 
-    batteryLevel = batteryReadings / numReadings;
+  if (power_full <= power_low) return 256;
 
-    return batteryLevel;
+  battery.update();
+  int mv = battery.voltage();
+  if (mv >= power_full) return 256;
+  if (mv <= power_low) return power_min_scale;
+  return power_min_scale + (long)(256 - power_min_scale) * (mv - power_low) / (power_full - power_low);
+}
+
+
+//-- Number of servo groups that have to take turns for a power scale
+int Zowi::_powerGroups(int scale){
+
+  if (scale >= 256) return 1;
+  int moving = power_max_moving + (long)(4 - power_max_moving) * (scale - power_min_scale) / (256 - power_min_scale);
+  return (4 + moving - 1) / moving;
+}
+
+
+//-- Servos that move in the current servo frame, when groups of
+//--  servos take turns
+uint8_t Zowi::_powerJoints(int groups){
+
+  if (groups <= 1) return OSCILLATOR_ALL;
+#ifdef OSCILLATOR_SERVO_LIB
+  int slot = (millis() / OSCILLATOR_FRAME) % groups;
+#else
+  int slot = ServoPulse::frames() % groups;
+#endif
+  uint8_t joints = 0;
+  for (int i = 0; i < 4; i++) {
+    if (i % groups == slot) joints |= _BV(i);
+  }
+  return joints;
+}
+
+
+//---------------------------------------------------------
+//-- Zowi setSampling: sampling period of the oscillators (ms)
+//--  Multiples of OSCILLATOR_FRAME (20 ms) are aligned with the
+//--  servo frames. With interpolation the servos are written
+//--  every frame, on a line between samples taken every TS: use
+//--  it with TS = 40 or 60 for smooth motions with less trig
+//---------------------------------------------------------
+void Zowi::setSampling(int TS, bool interpolate){
+
+  sample_time = TS;
+  sample_interpolate = interpolate;
+  servo.SetTS(sample_time);
+  servo.SetInterpolation(sample_interpolate);
+}
+
+
+//---------------------------------------------------------
+//-- Zowi setWaves: waveforms of the oscillators of each servo,
+//--  used by oscillateServos and the predetermined motions. The
+//--  amplitude, offset and phase keep their meaning: with
+//--  wave_triangle a walk moves the legs at constant speed, with
+//--  wave_square the feet stay longer at the ends of the step.
+//--  With no tables (or 0) the servos go back to the sine
+//---------------------------------------------------------
+void Zowi::setWaves(const int *YL, const int *YR, const int *RL, const int *RR){
+
+  servo_wave[0] = YL;
+  servo_wave[1] = YR;
+  servo_wave[2] = RL;
+  servo_wave[3] = RR;
+  for (int i = 0; i < 4; i++) servo.SetWave(i, servo_wave[i]);
+}
+
+
+//---------------------------------------------------------
+//-- Zowi setTransition: each motion starts with a crossfade of
+//--  time ms from the previous one (or from the position of the
+//--  servos), at the new period and keeping the phase, so that
+//--  motions can follow each other without home(). 0 = off
+//---------------------------------------------------------
+void Zowi::setTransition(int time){
+
+  transition_time = time;
+}
+
+
+//---------------------------------------------------------
+//-- Zowi setCPG: smooth transitions between motions. The
+//--  oscillators become coupled phase oscillators: a new motion
+//--  does not restart them, their amplitudes, offsets, periods
+//--  and phase differences move to the new ones with a time
+//--  constant of tau ms (about 3*tau to settle). 0 = off
+//---------------------------------------------------------
+void Zowi::setCPG(int tau){
+
+  servo.SetCPG(tau);
+}
+
+
+//---------------------------------------------------------
+//-- Zowi addLayer: a motion layer (WaveLayer, KeyframeLayer,
+//--  PoseLayer...) adds its offsets to the motions, e.g. a head
+//--  shake on the hips during a walk. The layer runs until it
+//--  ends or is removed; the positions stay within 0 to 180
+//---------------------------------------------------------
+void Zowi::addLayer(MotionLayer *layer){
+
+  servo.addLayer(layer);
+}
+
+void Zowi::removeLayer(MotionLayer *layer){
+
+  servo.removeLayer(layer);
+}
+
+
+//---------------------------------------------------------
+//-- Zowi playLayers: only the layers, from the home position,
+//--  for time ms
+//---------------------------------------------------------
+void Zowi::playLayers(int time){
+
+  attachServos();
+  if(getRestState()==true){
+        setRestState(false);
+  }
+
+  int A[4]={0, 0, 0, 0};
+  int O[4]={0, 0, 0, 0};
+  unsigned int phase[4]={0, 0, 0, 0};
+  oscillateServos(A, O, time, phase);
+}
+
+
+//---------------------------------------------------------
+//-- Zowi playGait: a gait baked by tools/gaitbake, e.g.
+//--  playGait(gait_walk_1000_forward, 4) is walk(4, 1000, FORWARD)
+//--  with no trigonometry: one row of the table per servo frame.
+//--  The battery governor scales the amplitudes (not the period).
+//--  At the end the servos hold the last position, and the next
+//--  motion starts (or crossfades) from there
+//---------------------------------------------------------
+void Zowi::playGait(const unsigned char *gait, ZowiSteps steps){
+
+  //-- Forever is only for gait_layer.start(gait): no steps, no motion
+  if (steps <= 0) return;
+  unsigned long cycles = steps * (unsigned long)GAIT_CYCLE_FINE;
+
+  velocity_mode = false;
+  attachServos();
+  if(getRestState()==true){
+        setRestState(false);
+  }
+
+  //-- The oscillators stay at home, the table moves the joints
+  int scale = getPowerScale();
+  int groups = _powerGroups(scale);
+  for (int i = 0; i < 4; i++) {
+    servo.SetA(i, 0);
+    servo.SetO(i, 0);
+  }
+  gait_layer.SetWeight(scale);
+  gait_layer.startFine(gait, cycles);
+  _noiseStart(_noiseKey(gait, 0, 0));
+  servo.addLayer(&gait_layer);
+  battery.setLoad(4, 4);
+
+  //-- The layer leaves the bank after its last row
+  while (gait_layer.playing()) {
+    servo.refresh(_powerJoints(groups));
+    battery.update();
+    _sense();
+  }
+  battery.setLoad(4, 0);
+  noise_key = NOISE_KEY_MOVE;
+
+  for (int i = 0; i < 4; i++) {
+    int pos = servo.getPosition(i) + 90 * OSCILLATOR_FINE;
+    servo.SetPosition(i, (pos + OSCILLATOR_FINE / 2) / OSCILLATOR_FINE);
+  }
 }
 
 
@@ -699,150 +1566,200 @@ void Zowi::clearMouth(){
 //-- SOUNDS -----------------------------------------------------//
 ///////////////////////////////////////////////////////////////////
 
-void Zowi::_tone (float noteFrequency, long noteDuration, int silentDuration){
+void Zowi::toneFine (unsigned long noteFrequency, long noteDuration, int silentDuration){
 
     // tone(10,261,500);
     // delay(500);
 
       if(silentDuration==0){silentDuration=1;}
 
-      tone(Zowi::pinBuzzer, noteFrequency, noteDuration);
-      delay(noteDuration);       //milliseconds to microseconds
-      //noTone(PIN_Buzzer);
+      buzzer.playFine(noteFrequency, noteDuration);
+      delay(noteDuration);
       delay(silentDuration);     
 }
 
 
-void Zowi::bendTones (float initFrequency, float finalFrequency, float prop, long noteDuration, int silentDuration){
+void Zowi::bendTonesFine (unsigned long initFrequency, unsigned long finalFrequency, unsigned int prop, long noteDuration, int silentDuration){
 
   //Examples:
   //  bendTones (880, 2093, 1.02, 18, 1);
-  //  bendTones (note_A5, note_C7, 1.02, 18, 0);
+  //  bendTonesFine (SYNTH_FREQ(note_A5), SYNTH_FREQ(note_C7), ZOWI_PROP(1.02), 18, 0);
 
   if(silentDuration==0){silentDuration=1;}
 
+  //-- Number of notes of the classic stepped bend (whole Hz), so that
+  //-- the glide lasts exactly the same. At low notes the ratio rounds
+  //-- to no change (30 Hz * 1.02): each note moves by 1 Hz at least
+  int steps=0;
   if(initFrequency < finalFrequency)
   {
-      for (int i=initFrequency; i<finalFrequency; i=i*prop) {
-          _tone(i, noteDuration, silentDuration);
+      for (unsigned long i=initFrequency/SYNTH_FINE; i*SYNTH_FINE<finalFrequency; i=max(i+1, i*prop>>14)) steps++;
+  } else{
+      for (unsigned long i=initFrequency/SYNTH_FINE; i*SYNTH_FINE>finalFrequency; i=min(i-1, (i<<14)/prop)) steps++;
+  }
+
+  if(silentDuration <= noteDuration){
+
+      //-- Short gaps: a continuous sweep generated by the buzzer interrupt,
+      //-- one glide between each two notes of the stepped bend. The pitch
+      //-- changes by the same ratio every step, as it did, not by the same Hz
+      long duration = steps * (noteDuration + silentDuration);
+      unsigned long start = millis();
+      unsigned long frequency = initFrequency;
+      unsigned long note = initFrequency/SYNTH_FINE;
+      for (int i=0; i<steps; i++) {
+          if(initFrequency < finalFrequency) note = max(note+1, note*prop>>14);
+          else note = min(note-1, (note<<14)/prop);
+          unsigned long next = i == steps-1 ? finalFrequency : note*SYNTH_FINE;
+
+          //-- The queue of the voice is short: wait for a free place, but
+          //-- no longer than the sweep (the voices pause during a sample)
+          if(i == 0) buzzer.glideFine(frequency, next, noteDuration + silentDuration);
+          else while (!buzzer.slideFine(0, frequency, next, noteDuration + silentDuration) &&
+                      (long)(millis() - start) < duration) {}
+          frequency = next;
       }
+      long left = duration - (long)(millis() - start);
+      if(left > 0) delay(left);
 
   } else{
 
-      for (int i=initFrequency; i>finalFrequency; i=i/prop) {
-          _tone(i, noteDuration, silentDuration);
+      //-- Long gaps are part of the sound (e.g. S_sad): keep separate notes
+      unsigned long frequency = initFrequency;
+      for (int i=0; i<steps; i++) {
+          toneFine(frequency, noteDuration, silentDuration);
+          if(initFrequency < finalFrequency) frequency = max(frequency+SYNTH_FINE, frequency*prop>>14);
+          else frequency = min(frequency-SYNTH_FINE, (frequency<<14)/prop);
       }
   }
 }
 
 
+//---------------------------------------------------------
+//-- Zowi playSample: start a recorded sound (see tools/wav2sample)
+//--  The sound is streamed in the background, this function
+//--  returns immediately
+//---------------------------------------------------------
+void Zowi::playSample(const unsigned char *sample){
+
+  buzzer.playSample(sample);
+}
+
+
+//---------------------------------------------------------
+//-- Zowi playSong: play a packed song (see tools/songc)
+//--  Parameters:
+//--    * song: note stream stored in PROGMEM
+//--    * wait: block until the song ends
+//---------------------------------------------------------
+void Zowi::playSong(const unsigned char *song, bool wait){
+
+  buzzer.playSong(song);
+  while (wait && buzzer.isPlaying()) {}
+}
+
+
 void Zowi::sing(int songName){
   switch(songName){
 
     case S_connection:
-      _tone(note_E5,50,30);
-      _tone(note_E6,55,25);
-      _tone(note_A6,60,10);
+      playSong(song_connection);
     break;
 
     case S_disconnection:
-      _tone(note_E5,50,30);
-      _tone(note_A6,55,25);
-      _tone(note_E6,50,10);
+      playSong(song_disconnection);
     break;
 
     case S_buttonPushed:
-      bendTones (note_E6, note_G6, 1.03, 20, 2);
+      bendTonesFine (SYNTH_FREQ(note_E6), SYNTH_FREQ(note_G6), ZOWI_PROP(1.03), 20, 2);
       delay(30);
-      bendTones (note_E6, note_D7, 1.04, 10, 2);
+      bendTonesFine (SYNTH_FREQ(note_E6), SYNTH_FREQ(note_D7), ZOWI_PROP(1.04), 10, 2);
     break;
 
     case S_mode1:
-      bendTones (note_E6, note_A6, 1.02, 30, 10);  //1318.51 to 1760
+      bendTonesFine (SYNTH_FREQ(note_E6), SYNTH_FREQ(note_A6), ZOWI_PROP(1.02), 30, 10);  //1318.51 to 1760
     break;
 
     case S_mode2:
-      bendTones (note_G6, note_D7, 1.03, 30, 10);  //1567.98 to 2349.32
+      bendTonesFine (SYNTH_FREQ(note_G6), SYNTH_FREQ(note_D7), ZOWI_PROP(1.03), 30, 10);  //1567.98 to 2349.32
     break;
 
     case S_mode3:
-      _tone(note_E6,50,100); //D6
-      _tone(note_G6,50,80);  //E6
-      _tone(note_D7,300,0);  //G6
+      playSong(song_mode3);
     break;
 
     case S_surprise:
-      bendTones(800, 2150, 1.02, 10, 1);
-      bendTones(2149, 800, 1.03, 7, 1);
+      bendTonesFine(SYNTH_FREQ(800), SYNTH_FREQ(2150), ZOWI_PROP(1.02), 10, 1);
+      bendTonesFine(SYNTH_FREQ(2149), SYNTH_FREQ(800), ZOWI_PROP(1.03), 7, 1);
     break;
 
     case S_OhOoh:
-      bendTones(880, 2000, 1.04, 8, 3); //A5 = 880
+      bendTonesFine(SYNTH_FREQ(880), SYNTH_FREQ(2000), ZOWI_PROP(1.04), 8, 3); //A5 = 880
       delay(200);
 
-      for (int i=880; i<2000; i=i*1.04) {
-           _tone(note_B5,5,10);
+      for (int i=880; i<2000; i=(long)i*104/100) {
+           toneFine(SYNTH_FREQ(note_B5),5,10);
       }
     break;
 
     case S_OhOoh2:
-      bendTones(1880, 3000, 1.03, 8, 3);
+      bendTonesFine(SYNTH_FREQ(1880), SYNTH_FREQ(3000), ZOWI_PROP(1.03), 8, 3);
       delay(200);
 
-      for (int i=1880; i<3000; i=i*1.03) {
-          _tone(note_C6,10,10);
+      for (int i=1880; i<3000; i=(long)i*103/100) {
+          toneFine(SYNTH_FREQ(note_C6),10,10);
       }
     break;
 
     case S_cuddly:
-      bendTones(700, 900, 1.03, 16, 4);
-      bendTones(899, 650, 1.01, 18, 7);
+      bendTonesFine(SYNTH_FREQ(700), SYNTH_FREQ(900), ZOWI_PROP(1.03), 16, 4);
+      bendTonesFine(SYNTH_FREQ(899), SYNTH_FREQ(650), ZOWI_PROP(1.01), 18, 7);
     break;
 
     case S_sleeping:
-      bendTones(100, 500, 1.04, 10, 10);
+      bendTonesFine(SYNTH_FREQ(100), SYNTH_FREQ(500), ZOWI_PROP(1.04), 10, 10);
       delay(500);
-      bendTones(400, 100, 1.04, 10, 1);
+      bendTonesFine(SYNTH_FREQ(400), SYNTH_FREQ(100), ZOWI_PROP(1.04), 10, 1);
     break;
 
     case S_happy:
-      bendTones(1500, 2500, 1.05, 20, 8);
-      bendTones(2499, 1500, 1.05, 25, 8);
+      bendTonesFine(SYNTH_FREQ(1500), SYNTH_FREQ(2500), ZOWI_PROP(1.05), 20, 8);
+      bendTonesFine(SYNTH_FREQ(2499), SYNTH_FREQ(1500), ZOWI_PROP(1.05), 25, 8);
     break;
 
     case S_superHappy:
-      bendTones(2000, 6000, 1.05, 8, 3);
+      bendTonesFine(SYNTH_FREQ(2000), SYNTH_FREQ(6000), ZOWI_PROP(1.05), 8, 3);
       delay(50);
-      bendTones(5999, 2000, 1.05, 13, 2);
+      bendTonesFine(SYNTH_FREQ(5999), SYNTH_FREQ(2000), ZOWI_PROP(1.05), 13, 2);
     break;
 
     case S_happy_short:
-      bendTones(1500, 2000, 1.05, 15, 8);
+      bendTonesFine(SYNTH_FREQ(1500), SYNTH_FREQ(2000), ZOWI_PROP(1.05), 15, 8);
       delay(100);
-      bendTones(1900, 2500, 1.05, 10, 8);
+      bendTonesFine(SYNTH_FREQ(1900), SYNTH_FREQ(2500), ZOWI_PROP(1.05), 10, 8);
     break;
 
     case S_sad:
-      bendTones(880, 669, 1.02, 20, 200);
+      bendTonesFine(SYNTH_FREQ(880), SYNTH_FREQ(669), ZOWI_PROP(1.02), 20, 200);
     break;
 
     case S_confused:
-      bendTones(1000, 1700, 1.03, 8, 2); 
-      bendTones(1699, 500, 1.04, 8, 3);
-      bendTones(1000, 1700, 1.05, 9, 10);
+      bendTonesFine(SYNTH_FREQ(1000), SYNTH_FREQ(1700), ZOWI_PROP(1.03), 8, 2); 
+      bendTonesFine(SYNTH_FREQ(1699), SYNTH_FREQ(500), ZOWI_PROP(1.04), 8, 3);
+      bendTonesFine(SYNTH_FREQ(1000), SYNTH_FREQ(1700), ZOWI_PROP(1.05), 9, 10);
     break;
 
     case S_fart1:
-      bendTones(1600, 3000, 1.02, 2, 15);
+      bendTonesFine(SYNTH_FREQ(1600), SYNTH_FREQ(3000), ZOWI_PROP(1.02), 2, 15);
     break;
 
     case S_fart2:
-      bendTones(2000, 6000, 1.02, 2, 20);
+      bendTonesFine(SYNTH_FREQ(2000), SYNTH_FREQ(6000), ZOWI_PROP(1.02), 2, 20);
     break;
 
     case S_fart3:
-      bendTones(1600, 4000, 1.02, 2, 20);
-      bendTones(4000, 3000, 1.02, 2, 20);
+      bendTonesFine(SYNTH_FREQ(1600), SYNTH_FREQ(4000), ZOWI_PROP(1.02), 2, 20);
+      bendTonesFine(SYNTH_FREQ(4000), SYNTH_FREQ(3000), ZOWI_PROP(1.02), 2, 20);
     break;
 
   }
@@ -874,7 +1791,7 @@ void Zowi::playGesture(int gesture){
   switch(gesture){
 
     case ZowiHappy: 
-        _tone(note_E5,50,30);
+        toneFine(SYNTH_FREQ(note_E5),50,30);
         putMouth(smile);
         sing(S_happy_short);
         swing(1,800,20); 
@@ -903,15 +1820,15 @@ void Zowi::playGesture(int gesture){
     case ZowiSad: 
         putMouth(sad);
         _moveServos(700, sadPos);     
-        bendTones(880, 830, 1.02, 20, 200);
+        bendTonesFine(SYNTH_FREQ(880), SYNTH_FREQ(830), ZOWI_PROP(1.02), 20, 200);
         putMouth(sadClosed);
-        bendTones(830, 790, 1.02, 20, 200);  
+        bendTonesFine(SYNTH_FREQ(830), SYNTH_FREQ(790), ZOWI_PROP(1.02), 20, 200);  
         putMouth(sadOpen);
-        bendTones(790, 740, 1.02, 20, 200);
+        bendTonesFine(SYNTH_FREQ(790), SYNTH_FREQ(740), ZOWI_PROP(1.02), 20, 200);
         putMouth(sadClosed);
-        bendTones(740, 700, 1.02, 20, 200);
+        bendTonesFine(SYNTH_FREQ(740), SYNTH_FREQ(700), ZOWI_PROP(1.02), 20, 200);
         putMouth(sadOpen);
-        bendTones(700, 669, 1.02, 20, 200);
+        bendTonesFine(SYNTH_FREQ(700), SYNTH_FREQ(669), ZOWI_PROP(1.02), 20, 200);
         putMouth(sad);
         delay(500);
 
@@ -926,16 +1843,16 @@ void Zowi::playGesture(int gesture){
 
         for(int i=0; i<4;i++){
           putAnimationMouth(dreamMouth,0);
-          bendTones (100, 200, 1.04, 10, 10);
+          bendTonesFine (SYNTH_FREQ(100), SYNTH_FREQ(200), ZOWI_PROP(1.04), 10, 10);
           putAnimationMouth(dreamMouth,1);
-          bendTones (200, 300, 1.04, 10, 10);  
+          bendTonesFine (SYNTH_FREQ(200), SYNTH_FREQ(300), ZOWI_PROP(1.04), 10, 10);  
           putAnimationMouth(dreamMouth,2);
-          bendTones (300, 500, 1.04, 10, 10);   
+          bendTonesFine (SYNTH_FREQ(300), SYNTH_FREQ(500), ZOWI_PROP(1.04), 10, 10);   
           delay(500);
           putAnimationMouth(dreamMouth,1);
-          bendTones (400, 250, 1.04, 10, 1); 
+          bendTonesFine (SYNTH_FREQ(400), SYNTH_FREQ(250), ZOWI_PROP(1.04), 10, 1); 
           putAnimationMouth(dreamMouth,0);
-          bendTones (250, 100, 1.04, 10, 1); 
+          bendTonesFine (SYNTH_FREQ(250), SYNTH_FREQ(100), ZOWI_PROP(1.04), 10, 1); 
           delay(500);
         } 
 
@@ -999,17 +1916,17 @@ void Zowi::playGesture(int gesture){
         _moveServos(300, angryPos); 
         putMouth(angry);
 
-        _tone(note_A5,100,30);
-        bendTones(note_A5, note_D6, 1.02, 7, 4);
-        bendTones(note_D6, note_G6, 1.02, 10, 1);
-        bendTones(note_G6, note_A5, 1.02, 10, 1);
+        toneFine(SYNTH_FREQ(note_A5),100,30);
+        bendTonesFine(SYNTH_FREQ(note_A5), SYNTH_FREQ(note_D6), ZOWI_PROP(1.02), 7, 4);
+        bendTonesFine(SYNTH_FREQ(note_D6), SYNTH_FREQ(note_G6), ZOWI_PROP(1.02), 10, 1);
+        bendTonesFine(SYNTH_FREQ(note_G6), SYNTH_FREQ(note_A5), ZOWI_PROP(1.02), 10, 1);
         delay(15);
-        bendTones(note_A5, note_E5, 1.02, 20, 4);
+        bendTonesFine(SYNTH_FREQ(note_A5), SYNTH_FREQ(note_E5), ZOWI_PROP(1.02), 20, 4);
         delay(400);
         _moveServos(200, headLeft); 
-        bendTones(note_A5, note_D6, 1.02, 20, 4);
+        bendTonesFine(SYNTH_FREQ(note_A5), SYNTH_FREQ(note_D6), ZOWI_PROP(1.02), 20, 4);
         _moveServos(200, headRight); 
-        bendTones(note_A5, note_E5, 1.02, 20, 4);
+        bendTonesFine(SYNTH_FREQ(note_A5), SYNTH_FREQ(note_E5), ZOWI_PROP(1.02), 20, 4);
 
         home();  
         putMouth(happyOpen);
@@ -1018,8 +1935,8 @@ void Zowi::playGesture(int gesture){
 
     case ZowiFretful: 
         putMouth(angry);
-        bendTones(note_A5, note_D6, 1.02, 20, 4);
-        bendTones(note_A5, note_E5, 1.02, 20, 4);
+        bendTonesFine(SYNTH_FREQ(note_A5), SYNTH_FREQ(note_D6), ZOWI_PROP(1.02), 20, 4);
+        bendTonesFine(SYNTH_FREQ(note_A5), SYNTH_FREQ(note_E5), ZOWI_PROP(1.02), 20, 4);
         delay(300);
         putMouth(lineMouth);
 
@@ -1048,16 +1965,16 @@ void Zowi::playGesture(int gesture){
 
             for(int index = 0; index<6; index++){
               putAnimationMouth(adivinawi,index);
-              bendTones(noteM, noteM+100, 1.04, 10, 10);    //400 -> 1000 
+              bendTonesFine(SYNTH_FREQ(noteM), SYNTH_FREQ(noteM+100), ZOWI_PROP(1.04), 10, 10);    //400 -> 1000 
               noteM+=100;
             }
 
             clearMouth();
-            bendTones(noteM-100, noteM+100, 1.04, 10, 10);  //900 -> 1100
+            bendTonesFine(SYNTH_FREQ(noteM-100), SYNTH_FREQ(noteM+100), ZOWI_PROP(1.04), 10, 10);  //900 -> 1100
 
             for(int index = 0; index<6; index++){
               putAnimationMouth(adivinawi,index);
-              bendTones(noteM, noteM+100, 1.04, 10, 10);    //1000 -> 400 
+              bendTonesFine(SYNTH_FREQ(noteM), SYNTH_FREQ(noteM+100), ZOWI_PROP(1.04), 10, 10);    //1000 -> 400 
               noteM-=100;
             }
         } 
@@ -1076,22 +1993,22 @@ void Zowi::playGesture(int gesture){
 
             for(int index = 0; index<10; index++){
               putAnimationMouth(wave,index);
-              bendTones(noteW, noteW+100, 1.02, 10, 10); 
+              bendTonesFine(SYNTH_FREQ(noteW), SYNTH_FREQ(noteW+100), ZOWI_PROP(1.02), 10, 10); 
               noteW+=101;
             }
             for(int index = 0; index<10; index++){
               putAnimationMouth(wave,index);
-              bendTones(noteW, noteW+100, 1.02, 10, 10); 
+              bendTonesFine(SYNTH_FREQ(noteW), SYNTH_FREQ(noteW+100), ZOWI_PROP(1.02), 10, 10); 
               noteW+=101;
             }
             for(int index = 0; index<10; index++){
               putAnimationMouth(wave,index);
-              bendTones(noteW, noteW-100, 1.02, 10, 10); 
+              bendTonesFine(SYNTH_FREQ(noteW), SYNTH_FREQ(noteW-100), ZOWI_PROP(1.02), 10, 10); 
               noteW-=101;
             }
             for(int index = 0; index<10; index++){
               putAnimationMouth(wave,index);
-              bendTones(noteW, noteW-100, 1.02, 10, 10); 
+              bendTonesFine(SYNTH_FREQ(noteW), SYNTH_FREQ(noteW-100), ZOWI_PROP(1.02), 10, 10); 
               noteW-=101;
             }
         }    
@@ -1108,7 +2025,7 @@ void Zowi::playGesture(int gesture){
         for (int i = 0; i < 60; ++i){
           int pos[]={90,90,90+i,90-i};  
           _moveServos(10,pos);
-          _tone(1600+i*20,15,1);
+          toneFine(SYNTH_FREQ(1600+i*20),15,1);
         }
 
         putMouth(bigSurprise);
@@ -1116,7 +2033,7 @@ void Zowi::playGesture(int gesture){
         for (int i = 0; i < 60; ++i){
           int pos[]={90,90,150-i,30+i};  
           _moveServos(10,pos);
-          _tone(2800+i*20,15,1);
+          toneFine(SYNTH_FREQ(2800+i*20),15,1);
         }
 
         putMouth(happyOpen);
@@ -1138,18 +2055,18 @@ void Zowi::playGesture(int gesture){
 
         putMouth(sadOpen);
         _moveServos(300,bendPos_1);
-        _tone(900,200,1);
+        toneFine(SYNTH_FREQ(900),200,1);
         putMouth(sadClosed);
         _moveServos(300,bendPos_2);
-        _tone(600,200,1);
+        toneFine(SYNTH_FREQ(600),200,1);
         putMouth(confused);
         _moveServos(300,bendPos_3);
-        _tone(300,200,1);
+        toneFine(SYNTH_FREQ(300),200,1);
         _moveServos(300,bendPos_4);
         putMouth(xMouth);
 
         detachServos();
-        _tone(150,2200,1);
+        toneFine(SYNTH_FREQ(150),2200,1);
         
         delay(600);
         clearMouth();
@@ -3,15 +3,26 @@
 
 #include <Servo.h>
 #include <Oscillator.h>
+#include <OscillatorBank.h>
 #include <EEPROM.h>
 
 #include <US.h>
 #include <LedMatrix.h>
 #include <BatReader.h>
+#include <BuzzerSynth.h>
 
 #include "Zowi_mouths.h"
 #include "Zowi_sounds.h"
 #include "Zowi_gestures.h"
+#include "Zowi_gaits.h"
+#include "Zowi_motions.h"
+
+//-- Sensing libraries the sketch can attach (see Zowi::attachNoiseModel...)
+class NoiseModel;
+class BeatTracker;
+class ClapPattern;
+class HandGesture;
+struct ZowiMap;             //-- Zowi_map.h
 
 
 //-- Constants
@@ -28,6 +39,67 @@
 #define PIN_Echo    9
 #define PIN_NoiseSensor A6
 
+//-- Battery governor policies (see Zowi::setPowerPolicy)
+#define POWER_OFF       0
+#define POWER_BALANCED  1
+#define POWER_SAVE      2
+#define POWER_STAGGER   30  //-- ms between the start of each group of servos
+
+//-- Velocity mode (see Zowi::setVelocity)
+#define VELOCITY_TMIN   1000  //-- Period at full speed (ms)
+#define VELOCITY_TMAX   2000  //-- Period at the lowest speed (ms)
+#define VELOCITY_FADE   300   //-- Crossfade when starting or reversing (ms)
+
+//-- Phase events of the motions (see Zowi::getPhaseEvents)
+#define PHASE_FEET_FLAT     0x01  //-- The body is level: feet roll within PHASE_LEVEL
+#define PHASE_QUIET         0x02  //-- The joints slower than PHASE_QUIET_SPEED for PHASE_QUIET_TIME
+#define PHASE_LEVEL         5     //-- Degrees, mean roll of the feet
+#define PHASE_QUIET_SPEED   30    //-- Degrees per second, all the joints together
+#define PHASE_QUIET_TIME    100   //-- ms
+#define SENSE_ANY           0     //-- Sense at any phase
+
+//-- Sensor scheduler (see Zowi::senseDistanceAt)
+#define SENSE_PING_PERIOD   60    //-- ms between ultrasound pings, so that echoes do not mix
+#define SENSE_NOISE_SAMPLES 4     //-- ADC samples of a noise window
+#define SENSE_NOISE_PERIOD  2     //-- ms between them
+
+//-- Servo noise model (see NoiseModel.h): motion states of the motions
+//-- with no cycle, whose phase is the speed of the joints
+#define NOISE_KEY_MOVE      1
+#define NOISE_KEY_VELOCITY  2     //-- Velocity mode, phase of the walk
+#define NOISE_SPEED_MAX     512   //-- Degrees per second at the last phase bin
+#define NOISE_START_TIME    120   //-- ms, the start of a motion is too loud for the claps
+
+//-- Dead reckoning of walk() and turn() for the map of the obstacles (see
+//-- Zowi::getOpenDirection): per cycle at full power. Estimates, to be
+//-- measured on the floor Zowi walks on
+#define NAV_WALK_STEP       4     //-- cm per cycle of walk
+#define NAV_TURN_STEP       20    //-- Degrees per cycle of turn
+#define NAV_TURN_WALK       2     //-- cm per cycle of turn
+
+//-- A reading of the sensor scheduler, tagged with the phase it was taken at
+struct ZowiReading {
+  int value;            //-- cm, or noise level (0 - 1023)
+  uint8_t events;       //-- PHASE_* events at the start of the reading
+  uint8_t phase;        //-- Phase of the gait cycle (256 = one turn)
+  int expected;         //-- Noise readings: servo noise expected at that motion state and phase (0 with no NoiseModel)
+  unsigned long time;   //-- millis() at the start of the reading
+};
+
+//-- Float-free profile: with ZOWI_NO_FLOAT defined in the compiler flags
+//-- (for all the Zowi libraries) the float API is left out and the steps
+//-- of the motions are whole steps. Elsewhere the float functions are
+//-- inline wrappers of the fixed point ones
+#ifdef ZOWI_NO_FLOAT
+  typedef int ZowiSteps;
+#else
+  typedef float ZowiSteps;
+#endif
+#define ZOWI_STEP_FINE  256   //-- Fixed point steps and cycles: 1/256
+
+//-- Ratio between the notes of bendTonesFine, Q14
+#define ZOWI_PROP(p)    ((unsigned int)((p) * 16384 + 0.5))
+
 
 class Zowi
 {
@@ -46,7 +118,10 @@ class Zowi
 
     //-- Predetermined Motion Functions
     void _moveServos(int time, int  servo_target[]);
-    void oscillateServos(int A[4], int O[4], int T, double phase_diff[4], float cycle);
+    void oscillateServos(int A[4], int O[4], int T, const unsigned int phase[4], unsigned long cycle=ZOWI_STEP_FINE);
+#ifndef ZOWI_NO_FLOAT
+    void oscillateServos(int A[4], int O[4], int T, double phase_diff[4], float cycle=1);
+#endif
 
     //-- HOME = Zowi at rest position
     void home();
@@ -54,40 +129,130 @@ class Zowi
     void setRestState(bool state);
     
     //-- Predetermined Motion Functions
-    void jump(float steps=1, int T = 2000);
+    void jump(ZowiSteps steps=1, int T = 2000);
 
-    void walk(float steps=4, int T=1000, int dir = FORWARD);
-    void turn(float steps=4, int T=2000, int dir = LEFT);
+    void walk(ZowiSteps steps=4, int T=1000, int dir = FORWARD);
+    void turn(ZowiSteps steps=4, int T=2000, int dir = LEFT);
     void bend (int steps=1, int T=1400, int dir=LEFT);
     void shakeLeg (int steps=1, int T = 2000, int dir=RIGHT);
 
-    void updown(float steps=1, int T=1000, int h = 20);
-    void swing(float steps=1, int T=1000, int h=20);
-    void tiptoeSwing(float steps=1, int T=900, int h=20);
-    void jitter(float steps=1, int T=500, int h=20);
-    void ascendingTurn(float steps=1, int T=900, int h=20);
+    void updown(ZowiSteps steps=1, int T=1000, int h = 20);
+    void swing(ZowiSteps steps=1, int T=1000, int h=20);
+    void tiptoeSwing(ZowiSteps steps=1, int T=900, int h=20);
+    void jitter(ZowiSteps steps=1, int T=500, int h=20);
+    void ascendingTurn(ZowiSteps steps=1, int T=900, int h=20);
 
-    void moonwalker(float steps=1, int T=900, int h=20, int dir=LEFT);
-    void crusaito(float steps=1, int T=900, int h=20, int dir=FORWARD);
-    void flapping(float steps=1, int T=1000, int h=20, int dir=FORWARD);
+    void moonwalker(ZowiSteps steps=1, int T=900, int h=20, int dir=LEFT);
+    void crusaito(ZowiSteps steps=1, int T=900, int h=20, int dir=FORWARD);
+    void flapping(ZowiSteps steps=1, int T=1000, int h=20, int dir=FORWARD);
+
+    //-- Velocity mode: non-blocking walk, call update() in the loop
+    void setVelocity(int v, int w);
+    void update();
 
     //-- Sensors functions
-    float getDistance(); //US sensor
-    int getNoise();      //Noise Sensor
+    unsigned int getDistanceCm(); //US sensor
+    void distanceEdge();          //From a pin-change interrupt on PIN_Echo
+    unsigned int getDistanceDropped(); //Measures given up by the scheduler
+    int getNoise();               //Noise Sensor
+
+    //-- Sensors synchronised with the motions: the scheduler reads them
+    //--  when all the PHASE_* events of the mask hold, during the motions
+    //--  and in update()
+    void senseDistanceAt(uint8_t events);
+    void senseNoiseAt(uint8_t events);
+    void stopSensing();
+    uint8_t getPhaseEvents();
+    bool getDistanceReading(ZowiReading &reading);  //-- True with a new reading
+    bool getNoiseReading(ZowiReading &reading);
+    int getNoisePeak();           //-- Loudest noise reading since the last call, servo noise removed
+
+    //-- Servo noise model (see NoiseModel.h), owned by the sketch: the
+    //--  noise readings have the servo noise removed. After init(), 0 = none
+    void attachNoiseModel(NoiseModel *model);
+    void resetNoiseModel();
+
+    //-- Beat of the music heard by the noise sensor (see BeatTracker.h),
+    //--  with a tracker owned by the sketch. After init(), 0 = none
+    void attachBeatTracker(BeatTracker *tracker);
+    void followBeat(bool follow);
+    unsigned int getTempo();      //-- BPM, 0 when there is no beat
+    bool getBeat();               //-- True once per beat
+
+    //-- Rhythms of claps heard by the noise sensor (see ClapPattern.h),
+    //--  with a recogniser owned by the sketch. After init(), 0 = none
+    void attachClapPattern(ClapPattern *claps);
+    bool setClapCommand(const char *rhythm, uint8_t command);
+    uint8_t getClapCommand();     //-- Command of the last rhythm clapped, once; 0 = none
+
+    //-- Hand gestures in front of the ultrasonic sensor (see HandGesture.h),
+    //--  with a recogniser owned by the sketch. After init(), 0 = none
+    void attachHandGesture(HandGesture *hand);
+    uint8_t getHandGesture();     //-- HAND_* of the last gesture, once; HAND_NONE = none
+
+    //-- Map of the obstacles around Zowi (see Zowi_map.h, PolarHistogram.h):
+    //--  the distance readings, by the heading dead-reckoned from walk() and
+    //--  turn(). Owned by the sketch; after init(), 0 = none. Directions are
+    //--  degrees from the heading, LEFT turns are positive
+    void attachMap(ZowiMap *map);
+    unsigned int getHeading();    //-- Degrees (0 - 359)
+    unsigned int getMapDistance(int direction);  //-- cm, 0 = unknown
+    int getOpenDirection();       //-- The most open way
+    void resetMap();
 
     //-- Battery
-    double getBatteryLevel();
-    double getBatteryVoltage();
+    unsigned char getBatteryPercent();
+    unsigned int getBatteryMillivolts();
+    unsigned int getBatteryRuntime();
+
+#ifndef ZOWI_NO_FLOAT
+    float getDistance() {return getDistanceCm();};
+    double getBatteryLevel() {return getBatteryPercent();};
+    double getBatteryVoltage() {return getBatteryMillivolts() / 1000.0;};
+#endif
+
+    //-- Battery governor
+    void setPowerPolicy(int policy);
+    void setPowerLimits(int fullVoltage, int lowVoltage, int minScale, int maxMoving);
+    int getPowerScale();
+
+    //-- Oscillator sampling
+    void setSampling(int TS, bool interpolate=false);
+
+    //-- Oscillator waveforms (PROGMEM tables, see OscillatorWaves.h)
+    void setWaves(const int *YL=0, const int *YR=0, const int *RL=0, const int *RR=0);
+
+    //-- Smooth gait transitions (crossfade, or coupled oscillators)
+    void setTransition(int time=300);
+    void setCPG(int tau=300);
+
+    //-- Motion layers, added to the motions (see MotionLayer.h)
+    void addLayer(MotionLayer *layer);
+    void removeLayer(MotionLayer *layer);
+    void playLayers(int time);
+
+    //-- Baked gaits (tools/gaitbake, Zowi_gaits.h)
+    void playGait(const unsigned char *gait, ZowiSteps steps=1);
     
     //-- Mouth & Animations
     void putMouth(unsigned long int mouth, bool predefined = true);
     void putAnimationMouth(unsigned long int anim, int index);
     void clearMouth();
 
-    //-- Sounds
-    void _tone (float noteFrequency, long noteDuration, int silentDuration);
-    void bendTones (float initFrequency, float finalFrequency, float prop, long noteDuration, int silentDuration);
+    //-- Sounds. Fine frequencies are 1/SYNTH_FINE Hz, e.g. SYNTH_FREQ(note_A5)
+    void toneFine (unsigned long noteFrequency, long noteDuration, int silentDuration);
+    void bendTonesFine (unsigned long initFrequency, unsigned long finalFrequency, unsigned int prop, long noteDuration, int silentDuration);
+#ifndef ZOWI_NO_FLOAT
+    void _tone (float noteFrequency, long noteDuration, int silentDuration) {
+      toneFine(SYNTH_FREQ(noteFrequency), noteDuration, silentDuration);
+    };
+    void bendTones (float initFrequency, float finalFrequency, float prop, long noteDuration, int silentDuration) {
+      bendTonesFine(SYNTH_FREQ(initFrequency), SYNTH_FREQ(finalFrequency), ZOWI_PROP(prop), noteDuration, silentDuration);
+    };
+#endif
     void sing(int songName);
+    void playSample(const unsigned char *sample);
+    void playSong(const unsigned char *song, bool wait = true);
 
     //-- Gestures
     void playGesture(int gesture);
@@ -97,7 +262,8 @@ class Zowi
     
     LedMatrix ledmatrix;
     BatReader battery;
-    Oscillator servo[4];
+    BuzzerSynth buzzer;
+    OscillatorBank<4> servo;
     US us;
 
     int servo_pins[4];
@@ -109,13 +275,71 @@ class Zowi
     
     unsigned long final_time;
     unsigned long partial_time;
-    float increment[4];
 
     bool isZowiResting;
 
+    int power_full;         //-- mV, no throttling above
+    int power_low;          //-- mV, full throttling below
+    int power_min_scale;    //-- Speed and amplitude at power_low (x/256)
+    int power_max_moving;   //-- Servos starting at the same time at power_low
+
+    int sample_time;          //-- Oscillator sampling period (ms)
+    bool sample_interpolate;  //-- Oscillator interpolation between samples
+    const int *servo_wave[4]; //-- Oscillator waveforms, 0 = sine
+    int transition_time;      //-- Crossfade between motions (ms)
+
+    bool velocity_mode;       //-- update() moves the servos
+    int velocity_dir;         //-- FORWARD / BACKWARD
+
+    GaitLayer gait_layer;     //-- Player of the baked gaits
+
+    uint8_t phase_events;     //-- PHASE_* events at the last servo frame
+    unsigned long phase_time; //-- ms, of the last servo frame checked
+    unsigned long quiet_time; //-- ms, since the joints are slow
+    int phase_pos[4];         //-- Joint positions at phase_time
+
+    bool sense_distance, sense_noise;
+    uint8_t distance_at, noise_at;  //-- Events the readings wait for
+    ZowiReading distance_reading, noise_reading;
+    bool distance_new, noise_new;
+    ZowiReading distance_tag; //-- Tag of the ultrasonic measure running
+    ZowiReading noise_tag;    //-- Tag of the noise window
+    uint8_t noise_count;      //-- Samples in the noise window
+    long noise_sum;
+    unsigned long noise_time; //-- ms, of the last noise sample
+
+    NoiseModel *noise_model;  //-- Servo noise per motion state and phase, 0 = none
+    unsigned int noise_key;   //-- Motion state of the motion running
+    unsigned int noise_state; //-- Motion state and phase of the noise window
+    uint8_t noise_phase;
+    int noise_peak;
+    int phase_speed;          //-- Degrees per second, all the joints together
+
+    BeatTracker *beat_tracker; //-- Fed with the noise readings, 0 = none
+    bool beat_follow;         //-- The gaits follow the beat
+    bool beat_new;
+
+    ClapPattern *clap_pattern; //-- Fed with the noise readings, 0 = none
+    uint8_t clap_command;     //-- Last rhythm recognised
+
+    HandGesture *hand_gesture; //-- Fed with the distance readings while Zowi is still, 0 = none
+    uint8_t hand_event;       //-- Last gesture recognised
+
+    ZowiMap *nav;             //-- Map and dead reckoning, 0 = none
+
     unsigned long int getMouthShape(int number);
     unsigned long int getAnimShape(int anim, int index);
-    void _execute(int A[4], int O[4], int T, double phase_diff[4], float steps);
+    void _execute(const ZowiGait *gait, int h, int T, ZowiSteps steps);
+    int _powerGroups(int scale);
+    uint8_t _powerJoints(int groups);
+    void _holdServos();
+    void _releaseServos();
+    void _sense();
+    void _phaseEvents(unsigned long now);
+    void _tag(ZowiReading &reading, unsigned long now);
+    void _noiseStart(unsigned int key);
+    void _navigate(unsigned long now);
+    static unsigned int _noiseKey(const void *gait, int T, int h);
 
 };
 
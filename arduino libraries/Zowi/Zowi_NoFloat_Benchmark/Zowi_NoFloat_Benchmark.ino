@@ -0,0 +1,171 @@
+//--------------------------------------------------------------
+//-- Zowi_NoFloat_Benchmark
+//-- Flash and cycles of the float-free profile of the Zowi
+//-- libraries. Build it twice, as it is and with ZOWI_NO_FLOAT
+//-- defined in the compiler flags (all the libraries), and
+//-- compare the reports:
+//--   * flash : bytes of the program. The sketch uses the same
+//--             Zowi functions in both builds: the float API as
+//--             sketches do, or the fixed point one
+//--   * cycles: per operation of the library hot paths, fixed
+//--             point and (in the float build) the float code
+//--             they replace
+//-- Zowi only moves when 'w' is sent on the serial monitor.
+//--------------------------------------------------------------
+#include <Servo.h>
+#include <Oscillator.h>
+#include <OscillatorBank.h>
+#include <EEPROM.h>
+#include <US.h>
+#include <LedMatrix.h>
+#include <BatReader.h>
+#include <BuzzerSynth.h>
+#include <Zowi.h>
+
+#define PIN_YL 2
+#define PIN_YR 3
+#define PIN_RL 4
+#define PIN_RR 5
+
+#define RUNS 256   //-- Operations per measure
+
+extern char __data_load_end[];   //-- End of the program in flash
+
+//-- The float code measured against, in the float build
+#ifdef ZOWI_NO_FLOAT
+  #define FLOAT(f) 0
+#else
+  #define FLOAT(f) f
+#endif
+
+Zowi zowi;
+
+//-- Inputs the compiler cannot fold
+volatile int vA = 30, vO = 4, vK = 17, vFrom = 60, vTo = 120, vTime = 500;
+volatile unsigned int vPhase = 12345;
+volatile unsigned long vFreq = SYNTH_FREQ(1318.51);
+volatile unsigned int vProp = ZOWI_PROP(1.02);
+volatile long sink;
+
+//-- Cycles of one run of op, without the loop
+unsigned long cycles(void (*op)())
+{
+  unsigned long t = micros();
+  for (int i = 0; i < RUNS; i++) op();
+  t = micros() - t;
+
+  unsigned long empty = micros();
+  for (int i = 0; i < RUNS; i++) sink = 0;
+  empty = micros() - empty;
+
+  return (t > empty ? t - empty : 0) * (F_CPU / 1000000L) / RUNS;
+}
+
+//-- Oscillator sample: A sin(phase) + O, 1/16 degrees
+void waveFixed()
+{
+  long sample = (long)vA * OSCILLATOR_FINE * oscillatorWave(wave_sine, vPhase);
+  sink = vO * OSCILLATOR_FINE + (int)((sample + OSCILLATOR_WAVE_ONE / 2) >> 14);
+}
+
+//-- _moveServos: position after k steps of 10 ms
+void moveFixed()
+{
+  long moved = 10L * (vTo - vFrom) * vK;
+  sink = ((long)vFrom * vTime + moved) / vTime;
+}
+
+//-- Buzzer: phase increment of a frequency
+void toneFixed()
+{
+  sink = BuzzerSynth::fineToIncrement(vFreq);
+}
+
+//-- bendTones: next note of a stepped bend
+void bendFixed()
+{
+  sink = vFreq * vProp >> 14;
+}
+
+#ifndef ZOWI_NO_FLOAT
+volatile double vPh = 0.3;
+volatile float vHz = 1318.51, vRatio = 1.02;
+
+void waveFloat()
+{
+  sink = round((vA * sin(vPh) + vO) * OSCILLATOR_FINE);
+}
+
+void moveFloat()
+{
+  float increment = (vTo - vFrom) / (vTime / 10.0);
+  sink = vFrom + (vK * increment);
+}
+
+void toneFloat()
+{
+  sink = (unsigned long)(vHz * (4294967296.0 / SYNTH_RATE));
+}
+
+void bendFloat()
+{
+  sink = vHz * vRatio;
+}
+#endif
+
+void report(const char *name, void (*fixed)(), void (*flt)())
+{
+  Serial.print(name);
+  Serial.print(": fixed ");
+  Serial.print(cycles(fixed));
+  if (flt) {
+    Serial.print(", float ");
+    Serial.print(cycles(flt));
+  }
+  Serial.println(" cycles");
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  zowi.init(PIN_YL, PIN_YR, PIN_RL, PIN_RR, true);
+
+#ifdef ZOWI_NO_FLOAT
+  Serial.println("Profile: fixed point (ZOWI_NO_FLOAT)");
+#else
+  Serial.println("Profile: float");
+#endif
+  Serial.print("Flash: ");
+  Serial.print((uintptr_t)__data_load_end);
+  Serial.println(" bytes");
+
+  report("oscillator sample", waveFixed, FLOAT(waveFloat));
+  report("servo move step", moveFixed, FLOAT(moveFloat));
+  report("tone increment", toneFixed, FLOAT(toneFloat));
+  report("bend note", bendFixed, FLOAT(bendFloat));
+}
+
+//-- The same calls in both builds, with run-time values
+void loop()
+{
+  if (Serial.read() != 'w') return;
+
+  int steps = vK / 8;
+  int T = vTime * 2;
+#ifdef ZOWI_NO_FLOAT
+  zowi.walk(steps, T, FORWARD);
+  zowi.bendTonesFine(vFreq, vFreq * 2, vProp, 10, 1);
+  zowi.toneFine(vFreq, 100, 10);
+  Serial.println(zowi.getDistanceCm());
+  Serial.println(zowi.getBatteryPercent());
+  Serial.println(zowi.getBatteryMillivolts());
+#else
+  zowi.walk(steps, T, FORWARD);
+  zowi.bendTones(vHz, vHz * 2, vRatio, 10, 1);
+  zowi._tone(vHz, 100, 10);
+  Serial.println(zowi.getDistance());
+  Serial.println(zowi.getBatteryLevel());
+  Serial.println(zowi.getBatteryVoltage());
+#endif
+  zowi.home();
+}
@@ -0,0 +1,310 @@
+#ifndef Zowi_gaits_h
+#define Zowi_gaits_h
+
+//***********************************************************************************
+//**********************************BAKED GAITS**************************************
+//***********************************************************************************
+//-- Generated with tools/gaitbake from tools/gaitbake/zowi.gaits
+//-- Played by Zowi::playGait(): the gait functions of Zowi.cpp with
+//-- their default parameters, with no trigonometry at run time
+
+// Generated by gaitbake from walk:1000:0:1
+// 50 rows of 20 ms, period 1000 ms, 210 bytes
+const unsigned char gait_walk_1000_forward[] PROGMEM = {
+  50, 4,
+  128, 0, 0, 128, 0, 0, 128, 0, 255, 128, 128, 254, 60, 60, 3, 3,
+  59, 59, 7, 7, 58, 58, 12, 12, 54, 54, 18, 18, 51, 51, 21, 21,
+  47, 47, 26, 26, 41, 41, 29, 29, 35, 35, 33, 33, 29, 29, 35, 35,
+  23, 23, 37, 37, 14, 14, 39, 39, 8, 8, 40, 40, 0, 0, 40, 40,
+  248, 248, 40, 40, 242, 242, 39, 39, 233, 233, 37, 37, 227, 227, 35, 35,
+  221, 221, 33, 33, 215, 215, 29, 29, 209, 209, 26, 26, 205, 205, 21, 21,
+  202, 202, 18, 18, 198, 198, 12, 12, 197, 197, 7, 7, 196, 196, 3, 3,
+  196, 196, 253, 253, 197, 197, 249, 249, 198, 198, 244, 244, 202, 202, 238, 238,
+  205, 205, 235, 235, 209, 209, 230, 230, 215, 215, 227, 227, 221, 221, 223, 223,
+  227, 227, 221, 221, 233, 233, 219, 219, 242, 242, 217, 217, 248, 248, 216, 216,
+  0, 0, 216, 216, 8, 8, 216, 216, 14, 14, 217, 217, 23, 23, 219, 219,
+  29, 29, 221, 221, 35, 35, 223, 223, 41, 41, 227, 227, 47, 47, 230, 230,
+  51, 51, 235, 235, 54, 54, 238, 238, 58, 58, 244, 244, 59, 59, 249, 249
+};
+
+// Generated by gaitbake from walk:1000:0:-1
+// 50 rows of 20 ms, period 1000 ms, 210 bytes
+const unsigned char gait_walk_1000_backward[] PROGMEM = {
+  50, 4,
+  128, 0, 0, 128, 0, 0, 128, 128, 1, 128, 0, 1, 60, 60, 253, 253,
+  59, 59, 249, 249, 58, 58, 244, 244, 54, 54, 238, 238, 51, 51, 235, 235,
+  47, 47, 230, 230, 41, 41, 227, 227, 35, 35, 223, 223, 29, 29, 221, 221,
+  23, 23, 219, 219, 14, 14, 217, 217, 8, 8, 216, 216, 0, 0, 216, 216,
+  248, 248, 216, 216, 242, 242, 217, 217, 233, 233, 219, 219, 227, 227, 221, 221,
+  221, 221, 223, 223, 215, 215, 227, 227, 209, 209, 230, 230, 205, 205, 235, 235,
+  202, 202, 238, 238, 198, 198, 244, 244, 197, 197, 249, 249, 196, 196, 253, 253,
+  196, 196, 3, 3, 197, 197, 7, 7, 198, 198, 12, 12, 202, 202, 18, 18,
+  205, 205, 21, 21, 209, 209, 26, 26, 215, 215, 29, 29, 221, 221, 33, 33,
+  227, 227, 35, 35, 233, 233, 37, 37, 242, 242, 39, 39, 248, 248, 40, 40,
+  0, 0, 40, 40, 8, 8, 40, 40, 14, 14, 39, 39, 23, 23, 37, 37,
+  29, 29, 35, 35, 35, 35, 33, 33, 41, 41, 29, 29, 47, 47, 26, 26,
+  51, 51, 21, 21, 54, 54, 18, 18, 58, 58, 12, 12, 59, 59, 7, 7
+};
+
+// Generated by gaitbake from turn:2000:0:1
+// 100 rows of 20 ms, period 2000 ms, 410 bytes
+const unsigned char gait_turn_2000_left[] PROGMEM = {
+  100, 4,
+  128, 0, 0, 128, 0, 0, 128, 0, 255, 128, 128, 254, 30, 10, 1, 1,
+  30, 10, 2, 2, 30, 10, 3, 3, 29, 10, 4, 4, 29, 9, 6, 6,
+  29, 10, 6, 6, 27, 9, 8, 8, 27, 9, 10, 10, 26, 9, 10, 10,
+  25, 8, 11, 11, 24, 8, 12, 12, 23, 8, 14, 14, 21, 7, 14, 14,
+  20, 6, 15, 15, 18, 6, 16, 16, 17, 6, 17, 17, 16, 5, 17, 17,
+  13, 5, 18, 18, 12, 4, 18, 18, 11, 3, 19, 19, 8, 3, 19, 19,
+  6, 2, 20, 20, 5, 2, 20, 20, 3, 1, 20, 20, 1, 0, 20, 20,
+  255, 0, 20, 20, 253, 255, 20, 20, 251, 254, 20, 20, 250, 254, 20, 20,
+  248, 253, 19, 19, 245, 253, 19, 19, 244, 252, 18, 18, 243, 251, 18, 18,
+  240, 251, 17, 17, 239, 250, 17, 17, 238, 250, 16, 16, 236, 250, 15, 15,
+  235, 249, 14, 14, 233, 248, 14, 14, 232, 248, 12, 12, 231, 248, 11, 11,
+  230, 247, 10, 10, 229, 247, 10, 10, 229, 247, 8, 8, 227, 246, 6, 6,
+  227, 247, 6, 6, 227, 246, 4, 4, 226, 246, 3, 3, 226, 246, 2, 2,
+  226, 246, 1, 1, 226, 246, 255, 255, 226, 246, 254, 254, 226, 246, 253, 253,
+  227, 246, 252, 252, 227, 247, 250, 250, 227, 246, 250, 250, 229, 247, 248, 248,
+  229, 247, 246, 246, 230, 247, 246, 246, 231, 248, 245, 245, 232, 248, 244, 244,
+  233, 248, 242, 242, 235, 249, 242, 242, 236, 250, 241, 241, 238, 250, 240, 240,
+  239, 250, 239, 239, 240, 251, 239, 239, 243, 251, 238, 238, 244, 252, 238, 238,
+  245, 253, 237, 237, 248, 253, 237, 237, 250, 254, 236, 236, 251, 254, 236, 236,
+  253, 255, 236, 236, 255, 0, 236, 236, 1, 0, 236, 236, 3, 1, 236, 236,
+  5, 2, 236, 236, 6, 2, 236, 236, 8, 3, 237, 237, 11, 3, 237, 237,
+  12, 4, 238, 238, 13, 5, 238, 238, 16, 5, 239, 239, 17, 6, 239, 239,
+  18, 6, 240, 240, 20, 6, 241, 241, 21, 7, 242, 242, 23, 8, 242, 242,
+  24, 8, 244, 244, 25, 8, 245, 245, 26, 9, 246, 246, 27, 9, 246, 246,
+  27, 9, 248, 248, 29, 10, 250, 250, 29, 9, 250, 250, 29, 10, 252, 252,
+  30, 10, 253, 253, 30, 10, 254, 254
+};
+
+// Generated by gaitbake from turn:2000:0:-1
+// 100 rows of 20 ms, period 2000 ms, 410 bytes
+const unsigned char gait_turn_2000_right[] PROGMEM = {
+  100, 4,
+  128, 0, 0, 128, 0, 0, 128, 0, 255, 128, 128, 254, 10, 30, 1, 1,
+  10, 30, 2, 2, 10, 30, 3, 3, 10, 29, 4, 4, 9, 29, 6, 6,
+  10, 29, 6, 6, 9, 27, 8, 8, 9, 27, 10, 10, 9, 26, 10, 10,
+  8, 25, 11, 11, 8, 24, 12, 12, 8, 23, 14, 14, 7, 21, 14, 14,
+  6, 20, 15, 15, 6, 18, 16, 16, 6, 17, 17, 17, 5, 16, 17, 17,
+  5, 13, 18, 18, 4, 12, 18, 18, 3, 11, 19, 19, 3, 8, 19, 19,
+  2, 6, 20, 20, 2, 5, 20, 20, 1, 3, 20, 20, 0, 1, 20, 20,
+  0, 255, 20, 20, 255, 253, 20, 20, 254, 251, 20, 20, 254, 250, 20, 20,
+  253, 248, 19, 19, 253, 245, 19, 19, 252, 244, 18, 18, 251, 243, 18, 18,
+  251, 240, 17, 17, 250, 239, 17, 17, 250, 238, 16, 16, 250, 236, 15, 15,
+  249, 235, 14, 14, 248, 233, 14, 14, 248, 232, 12, 12, 248, 231, 11, 11,
+  247, 230, 10, 10, 247, 229, 10, 10, 247, 229, 8, 8, 246, 227, 6, 6,
+  247, 227, 6, 6, 246, 227, 4, 4, 246, 226, 3, 3, 246, 226, 2, 2,
+  246, 226, 1, 1, 246, 226, 255, 255, 246, 226, 254, 254, 246, 226, 253, 253,
+  246, 227, 252, 252, 247, 227, 250, 250, 246, 227, 250, 250, 247, 229, 248, 248,
+  247, 229, 246, 246, 247, 230, 246, 246, 248, 231, 245, 245, 248, 232, 244, 244,
+  248, 233, 242, 242, 249, 235, 242, 242, 250, 236, 241, 241, 250, 238, 240, 240,
+  250, 239, 239, 239, 251, 240, 239, 239, 251, 243, 238, 238, 252, 244, 238, 238,
+  253, 245, 237, 237, 253, 248, 237, 237, 254, 250, 236, 236, 254, 251, 236, 236,
+  255, 253, 236, 236, 0, 255, 236, 236, 0, 1, 236, 236, 1, 3, 236, 236,
+  2, 5, 236, 236, 2, 6, 236, 236, 3, 8, 237, 237, 3, 11, 237, 237,
+  4, 12, 238, 238, 5, 13, 238, 238, 5, 16, 239, 239, 6, 17, 239, 239,
+  6, 18, 240, 240, 6, 20, 241, 241, 7, 21, 242, 242, 8, 23, 242, 242,
+  8, 24, 244, 244, 8, 25, 245, 245, 9, 26, 246, 246, 9, 27, 246, 246,
+  9, 27, 248, 248, 10, 29, 250, 250, 9, 29, 250, 250, 10, 29, 252, 252,
+  10, 30, 253, 253, 10, 30, 254, 254
+};
+
+// Generated by gaitbake from updown:1000:20
+// 50 rows of 20 ms, period 1000 ms, 210 bytes
+const unsigned char gait_updown_1000_20[] PROGMEM = {
+  50, 4,
+  128, 0, 0, 128, 0, 0, 128, 0, 0, 128, 0, 0, 0, 0, 3, 253,
+  0, 0, 7, 249, 0, 0, 12, 244, 0, 0, 18, 238, 0, 0, 21, 235,
+  0, 0, 26, 230, 0, 0, 29, 227, 0, 0, 33, 223, 0, 0, 35, 221,
+  0, 0, 37, 219, 0, 0, 39, 217, 0, 0, 40, 216, 0, 0, 40, 216,
+  0, 0, 40, 216, 0, 0, 39, 217, 0, 0, 37, 219, 0, 0, 35, 221,
+  0, 0, 33, 223, 0, 0, 29, 227, 0, 0, 26, 230, 0, 0, 21, 235,
+  0, 0, 18, 238, 0, 0, 12, 244, 0, 0, 7, 249, 0, 0, 3, 253,
+  0, 0, 253, 3, 0, 0, 249, 7, 0, 0, 244, 12, 0, 0, 238, 18,
+  0, 0, 235, 21, 0, 0, 230, 26, 0, 0, 227, 29, 0, 0, 223, 33,
+  0, 0, 221, 35, 0, 0, 219, 37, 0, 0, 217, 39, 0, 0, 216, 40,
+  0, 0, 216, 40, 0, 0, 216, 40, 0, 0, 217, 39, 0, 0, 219, 37,
+  0, 0, 221, 35, 0, 0, 223, 33, 0, 0, 227, 29, 0, 0, 230, 26,
+  0, 0, 235, 21, 0, 0, 238, 18, 0, 0, 244, 12, 0, 0, 249, 7
+};
+
+// Generated by gaitbake from swing:1000:20
+// 50 rows of 20 ms, period 1000 ms, 210 bytes
+const unsigned char gait_swing_1000_20[] PROGMEM = {
+  50, 4,
+  128, 0, 0, 128, 0, 0, 128, 160, 0, 128, 96, 255, 0, 0, 40, 40,
+  0, 0, 40, 40, 0, 0, 38, 38, 0, 0, 36, 36, 0, 0, 34, 34,
+  0, 0, 31, 31, 0, 0, 28, 28, 0, 0, 23, 23, 0, 0, 20, 20,
+  0, 0, 14, 14, 0, 0, 10, 10, 0, 0, 5, 5, 0, 0, 0, 0,
+  0, 0, 251, 251, 0, 0, 246, 246, 0, 0, 242, 242, 0, 0, 236, 236,
+  0, 0, 233, 233, 0, 0, 228, 228, 0, 0, 225, 225, 0, 0, 222, 222,
+  0, 0, 220, 220, 0, 0, 218, 218, 0, 0, 216, 216, 0, 0, 216, 216,
+  0, 0, 216, 216, 0, 0, 216, 216, 0, 0, 218, 218, 0, 0, 220, 220,
+  0, 0, 222, 222, 0, 0, 225, 225, 0, 0, 228, 228, 0, 0, 233, 233,
+  0, 0, 236, 236, 0, 0, 242, 242, 0, 0, 246, 246, 0, 0, 251, 251,
+  0, 0, 0, 0, 0, 0, 5, 5, 0, 0, 10, 10, 0, 0, 14, 14,
+  0, 0, 20, 20, 0, 0, 23, 23, 0, 0, 28, 28, 0, 0, 31, 31,
+  0, 0, 34, 34, 0, 0, 36, 36, 0, 0, 38, 38, 0, 0, 40, 40
+};
+
+// Generated by gaitbake from tiptoeSwing:900:20
+// 45 rows of 20 ms, period 900 ms, 190 bytes
+const unsigned char gait_tiptoeSwing_900_20[] PROGMEM = {
+  45, 4,
+  128, 0, 0, 128, 0, 0, 128, 64, 1, 128, 192, 254, 0, 0, 45, 45,
+  0, 0, 43, 43, 0, 0, 42, 42, 0, 0, 40, 40, 0, 0, 36, 36,
+  0, 0, 32, 32, 0, 0, 27, 27, 0, 0, 23, 23, 0, 0, 16, 16,
+  0, 0, 11, 11, 0, 0, 5, 5, 0, 0, 254, 254, 0, 0, 248, 248,
+  0, 0, 243, 243, 0, 0, 236, 236, 0, 0, 231, 231, 0, 0, 226, 226,
+  0, 0, 222, 222, 0, 0, 218, 218, 0, 0, 215, 215, 0, 0, 214, 214,
+  0, 0, 211, 211, 0, 0, 212, 212, 0, 0, 211, 211, 0, 0, 214, 214,
+  0, 0, 215, 215, 0, 0, 218, 218, 0, 0, 222, 222, 0, 0, 226, 226,
+  0, 0, 231, 231, 0, 0, 236, 236, 0, 0, 243, 243, 0, 0, 248, 248,
+  0, 0, 254, 254, 0, 0, 5, 5, 0, 0, 11, 11, 0, 0, 16, 16,
+  0, 0, 23, 23, 0, 0, 27, 27, 0, 0, 32, 32, 0, 0, 36, 36,
+  0, 0, 40, 40, 0, 0, 42, 42, 0, 0, 43, 43
+};
+
+// Generated by gaitbake from jitter:500:20
+// 25 rows of 20 ms, period 500 ms, 110 bytes
+const unsigned char gait_jitter_500_20[] PROGMEM = {
+  25, 4,
+  128, 192, 254, 128, 64, 1, 128, 0, 0, 128, 0, 0, 10, 246, 0, 0,
+  30, 226, 0, 0, 47, 209, 0, 0, 62, 194, 0, 0, 72, 184, 0, 0,
+  79, 177, 0, 0, 80, 176, 0, 0, 76, 180, 0, 0, 68, 188, 0, 0,
+  55, 201, 0, 0, 39, 217, 0, 0, 19, 237, 0, 0, 0, 0, 0, 0,
+  237, 19, 0, 0, 217, 39, 0, 0, 201, 55, 0, 0, 188, 68, 0, 0,
+  180, 76, 0, 0, 176, 80, 0, 0, 177, 79, 0, 0, 184, 72, 0, 0,
+  194, 62, 0, 0, 209, 47, 0, 0, 226, 30, 0, 0
+};
+
+// Generated by gaitbake from ascendingTurn:900:20
+// 45 rows of 20 ms, period 900 ms, 190 bytes
+const unsigned char gait_ascendingTurn_900_20[] PROGMEM = {
+  45, 4,
+  128, 48, 255, 128, 208, 0, 128, 64, 0, 128, 64, 0, 2, 254, 2, 254,
+  6, 250, 6, 250, 10, 246, 10, 246, 14, 242, 14, 242, 17, 239, 17, 239,
+  20, 236, 20, 236, 23, 233, 23, 233, 25, 231, 25, 231, 27, 229, 27, 229,
+  28, 228, 28, 228, 29, 227, 29, 227, 29, 227, 29, 227, 28, 228, 28, 228,
+  28, 228, 28, 228, 26, 230, 26, 230, 24, 232, 24, 232, 22, 234, 22, 234,
+  18, 238, 18, 238, 16, 240, 16, 240, 11, 245, 11, 245, 8, 248, 8, 248,
+  4, 252, 4, 252, 0, 0, 0, 0, 252, 4, 252, 4, 248, 8, 248, 8,
+  245, 11, 245, 11, 240, 16, 240, 16, 238, 18, 238, 18, 234, 22, 234, 22,
+  232, 24, 232, 24, 230, 26, 230, 26, 228, 28, 228, 28, 228, 28, 228, 28,
+  227, 29, 227, 29, 227, 29, 227, 29, 228, 28, 228, 28, 229, 27, 229, 27,
+  231, 25, 231, 25, 233, 23, 233, 23, 236, 20, 236, 20, 239, 17, 239, 17,
+  242, 14, 242, 14, 246, 10, 246, 10, 250, 6, 250, 6
+};
+
+// Generated by gaitbake from moonwalker:900:20:1
+// 45 rows of 20 ms, period 900 ms, 190 bytes
+const unsigned char gait_moonwalker_900_20_left[] PROGMEM = {
+  45, 4,
+  128, 0, 0, 128, 0, 0, 128, 128, 255, 128, 160, 254, 0, 0, 3, 219,
+  0, 0, 9, 223, 0, 0, 16, 227, 0, 0, 21, 232, 0, 0, 26, 238,
+  0, 0, 31, 244, 0, 0, 35, 250, 0, 0, 39, 0, 0, 0, 41, 6,
+  0, 0, 43, 12, 0, 0, 45, 18, 0, 0, 44, 24, 0, 0, 44, 29,
+  0, 0, 43, 33, 0, 0, 40, 37, 0, 0, 37, 40, 0, 0, 33, 43,
+  0, 0, 29, 44, 0, 0, 24, 44, 0, 0, 18, 45, 0, 0, 12, 43,
+  0, 0, 6, 41, 0, 0, 0, 39, 0, 0, 250, 35, 0, 0, 244, 31,
+  0, 0, 238, 26, 0, 0, 232, 21, 0, 0, 227, 16, 0, 0, 223, 9,
+  0, 0, 219, 3, 0, 0, 216, 253, 0, 0, 213, 247, 0, 0, 212, 240,
+  0, 0, 212, 235, 0, 0, 211, 230, 0, 0, 213, 225, 0, 0, 215, 221,
+  0, 0, 217, 217, 0, 0, 221, 215, 0, 0, 225, 213, 0, 0, 230, 211,
+  0, 0, 235, 212, 0, 0, 240, 212, 0, 0, 247, 213
+};
+
+// Generated by gaitbake from moonwalker:900:20:-1
+// 45 rows of 20 ms, period 900 ms, 190 bytes
+const unsigned char gait_moonwalker_900_20_right[] PROGMEM = {
+  45, 4,
+  128, 0, 0, 128, 0, 0, 128, 0, 2, 128, 224, 255, 0, 0, 253, 216,
+  0, 0, 247, 213, 0, 0, 240, 212, 0, 0, 235, 212, 0, 0, 230, 211,
+  0, 0, 225, 213, 0, 0, 221, 215, 0, 0, 217, 217, 0, 0, 215, 221,
+  0, 0, 213, 225, 0, 0, 211, 230, 0, 0, 212, 235, 0, 0, 212, 240,
+  0, 0, 213, 247, 0, 0, 216, 253, 0, 0, 219, 3, 0, 0, 223, 9,
+  0, 0, 227, 16, 0, 0, 232, 21, 0, 0, 238, 26, 0, 0, 244, 31,
+  0, 0, 250, 35, 0, 0, 0, 39, 0, 0, 6, 41, 0, 0, 12, 43,
+  0, 0, 18, 45, 0, 0, 24, 44, 0, 0, 29, 44, 0, 0, 33, 43,
+  0, 0, 37, 40, 0, 0, 40, 37, 0, 0, 43, 33, 0, 0, 44, 29,
+  0, 0, 44, 24, 0, 0, 45, 18, 0, 0, 43, 12, 0, 0, 41, 6,
+  0, 0, 39, 0, 0, 0, 35, 250, 0, 0, 31, 244, 0, 0, 26, 238,
+  0, 0, 21, 232, 0, 0, 16, 227, 0, 0, 9, 223
+};
+
+// Generated by gaitbake from crusaito:900:20:1
+// 45 rows of 20 ms, period 900 ms, 190 bytes
+const unsigned char gait_crusaito_900_20_forward[] PROGMEM = {
+  45, 4,
+  128, 102, 1, 128, 102, 1, 128, 224, 0, 128, 11, 254, 227, 227, 45, 25,
+  221, 221, 43, 30, 216, 216, 42, 34, 210, 210, 40, 38, 207, 207, 36, 41,
+  203, 203, 32, 42, 201, 201, 27, 45, 201, 201, 23, 44, 200, 200, 16, 45,
+  202, 202, 11, 42, 203, 203, 5, 41, 207, 207, 254, 38, 212, 212, 248, 34,
+  216, 216, 243, 30, 222, 222, 236, 25, 229, 229, 231, 20, 235, 235, 226, 13,
+  243, 243, 222, 8, 251, 251, 218, 2, 3, 3, 215, 251, 10, 10, 214, 245,
+  18, 18, 211, 240, 25, 25, 212, 233, 31, 31, 211, 229, 38, 38, 214, 224,
+  43, 43, 215, 220, 48, 48, 218, 216, 51, 51, 222, 214, 54, 54, 226, 213,
+  55, 55, 231, 211, 56, 56, 236, 211, 55, 55, 243, 213, 54, 54, 248, 214,
+  51, 51, 254, 216, 47, 47, 5, 220, 42, 42, 11, 224, 37, 37, 16, 229,
+  31, 31, 23, 233, 23, 23, 27, 240, 17, 17, 32, 245, 9, 9, 36, 251,
+  2, 2, 40, 2, 249, 249, 42, 8, 242, 242, 43, 13
+};
+
+// Generated by gaitbake from crusaito:900:20:-1
+// 45 rows of 20 ms, period 900 ms, 190 bytes
+const unsigned char gait_crusaito_900_20_backward[] PROGMEM = {
+  45, 4,
+  128, 102, 1, 128, 102, 1, 128, 224, 0, 128, 53, 0, 227, 227, 45, 20,
+  221, 221, 43, 13, 216, 216, 42, 8, 210, 210, 40, 2, 207, 207, 36, 251,
+  203, 203, 32, 245, 201, 201, 27, 240, 201, 201, 23, 233, 200, 200, 16, 229,
+  202, 202, 11, 224, 203, 203, 5, 220, 207, 207, 254, 216, 212, 212, 248, 214,
+  216, 216, 243, 213, 222, 222, 236, 211, 229, 229, 231, 211, 235, 235, 226, 213,
+  243, 243, 222, 214, 251, 251, 218, 216, 3, 3, 215, 220, 10, 10, 214, 224,
+  18, 18, 211, 229, 25, 25, 212, 233, 31, 31, 211, 240, 38, 38, 214, 245,
+  43, 43, 215, 251, 48, 48, 218, 2, 51, 51, 222, 8, 54, 54, 226, 13,
+  55, 55, 231, 20, 56, 56, 236, 25, 55, 55, 243, 30, 54, 54, 248, 34,
+  51, 51, 254, 38, 47, 47, 5, 41, 42, 42, 11, 42, 37, 37, 16, 45,
+  31, 31, 23, 44, 23, 23, 27, 45, 17, 17, 32, 42, 9, 9, 36, 41,
+  2, 2, 40, 38, 249, 249, 42, 34, 242, 242, 43, 30
+};
+
+// Generated by gaitbake from flapping:1000:20:1
+// 50 rows of 20 ms, period 1000 ms, 210 bytes
+const unsigned char gait_flapping_1000_20_forward[] PROGMEM = {
+  50, 4,
+  128, 0, 0, 128, 0, 0, 128, 96, 255, 128, 160, 0, 24, 232, 3, 253,
+  24, 232, 7, 249, 23, 233, 12, 244, 21, 235, 18, 238, 21, 235, 21, 235,
+  18, 238, 26, 230, 17, 239, 29, 227, 14, 242, 33, 223, 12, 244, 35, 221,
+  9, 247, 37, 219, 6, 250, 39, 217, 3, 253, 40, 216, 0, 0, 40, 216,
+  253, 3, 40, 216, 250, 6, 39, 217, 247, 9, 37, 219, 244, 12, 35, 221,
+  242, 14, 33, 223, 239, 17, 29, 227, 238, 18, 26, 230, 235, 21, 21, 235,
+  235, 21, 18, 238, 233, 23, 12, 244, 232, 24, 7, 249, 232, 24, 3, 253,
+  232, 24, 253, 3, 232, 24, 249, 7, 233, 23, 244, 12, 235, 21, 238, 18,
+  235, 21, 235, 21, 238, 18, 230, 26, 239, 17, 227, 29, 242, 14, 223, 33,
+  244, 12, 221, 35, 247, 9, 219, 37, 250, 6, 217, 39, 253, 3, 216, 40,
+  0, 0, 216, 40, 3, 253, 216, 40, 6, 250, 217, 39, 9, 247, 219, 37,
+  12, 244, 221, 35, 14, 242, 223, 33, 17, 239, 227, 29, 18, 238, 230, 26,
+  21, 235, 235, 21, 21, 235, 238, 18, 23, 233, 244, 12, 24, 232, 249, 7
+};
+
+// Generated by gaitbake from flapping:1000:20:-1
+// 50 rows of 20 ms, period 1000 ms, 210 bytes
+const unsigned char gait_flapping_1000_20_backward[] PROGMEM = {
+  50, 4,
+  128, 0, 0, 128, 0, 0, 128, 224, 1, 128, 32, 254, 24, 232, 253, 3,
+  24, 232, 249, 7, 23, 233, 244, 12, 21, 235, 238, 18, 21, 235, 235, 21,
+  18, 238, 230, 26, 17, 239, 227, 29, 14, 242, 223, 33, 12, 244, 221, 35,
+  9, 247, 219, 37, 6, 250, 217, 39, 3, 253, 216, 40, 0, 0, 216, 40,
+  253, 3, 216, 40, 250, 6, 217, 39, 247, 9, 219, 37, 244, 12, 221, 35,
+  242, 14, 223, 33, 239, 17, 227, 29, 238, 18, 230, 26, 235, 21, 235, 21,
+  235, 21, 238, 18, 233, 23, 244, 12, 232, 24, 249, 7, 232, 24, 253, 3,
+  232, 24, 3, 253, 232, 24, 7, 249, 233, 23, 12, 244, 235, 21, 18, 238,
+  235, 21, 21, 235, 238, 18, 26, 230, 239, 17, 29, 227, 242, 14, 33, 223,
+  244, 12, 35, 221, 247, 9, 37, 219, 250, 6, 39, 217, 253, 3, 40, 216,
+  0, 0, 40, 216, 3, 253, 40, 216, 6, 250, 39, 217, 9, 247, 37, 219,
+  12, 244, 35, 221, 14, 242, 33, 223, 17, 239, 29, 227, 18, 238, 26, 230,
+  21, 235, 21, 235, 21, 235, 18, 238, 23, 233, 12, 244, 24, 232, 7, 249
+};
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef Zowi_map_h
+#define Zowi_map_h
+
+#include <PolarHistogram.h>
+
+//-- The map of the obstacles around Zowi, and its heading dead-reckoned
+//-- from walk() and turn(). The sketch owns it and attaches it:
+//--    ZowiMap map;
+//--    zowi.attachMap(&map);
+//-- Zowi fills it in; getOpenDirection, getMapDistance and getHeading
+//-- read it.
+struct ZowiMap {
+  PolarHistogram map;       //-- Fed with the distance readings
+  uint16_t heading;         //-- Dead reckoning (65536 = one turn)
+  int turn;                 //-- Heading per cycle of the motion running
+  int walk;                 //-- 1/POLAR_FINE cm per cycle
+  int T;                    //-- ms per cycle
+  long turn_rest, walk_rest;  //-- Not counted yet, x T
+  unsigned long time;       //-- ms, counted up to
+};
+
+#endif
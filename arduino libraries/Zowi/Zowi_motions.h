@@ -0,0 +1,139 @@
+#ifndef Zowi_motions_h
+#define Zowi_motions_h
+
+//***********************************************************************************
+//*********************************GAIT DEFINITIONS**********************************
+//***********************************************************************************
+//-- The oscillators of the gaits of Zowi.cpp, evaluated by the compiler
+//-- into PROGMEM tables. For a height h (the h of updown, moonwalker...):
+//--    amplitude = A + Ah * h / 2,  offset = O + Oh * h / 2  (degrees)
+//-- (integer division, as the h/2 of the gait functions) and the phases
+//-- are 16 bits (65536 = one turn), ready for OscillatorBank::SetPhase.
+//--
+//-- zowiGait() checks the definitions at compile time: a gait that can
+//-- move a servo out of 0 - 180, or have a negative amplitude, at h = 0
+//-- or at its largest height (hmax, or BIG when h is not limited) does
+//-- not build. The error names the check: gait_amplitude_is_negative
+//-- or gait_exceeds_servo_range.
+//--
+//-- Also used by tools/gaitbake (host)
+
+struct ZowiGait {
+  int8_t A[4];        //-- Amplitude (degrees)
+  int8_t Ah[4];       //-- Amplitude per h, in halves
+  int8_t O[4];        //-- Offset (degrees)
+  int8_t Oh[4];       //-- Offset per h, in halves
+  uint16_t ph[4];     //-- Phase (1 turn = 65536)
+  uint8_t hmax;       //-- Largest h, 0 = no limit
+};
+
+//-- Arguments of zowiGait(): one value per joint (YL, YR, RL, RR)
+struct ZowiJoints {
+  int v[4];
+};
+
+struct ZowiPhases {
+  double deg[4];
+};
+
+#define ZOWI_GAIT_HREF  30  //-- h checked when there is no hmax (BIG)
+
+//-- Called only when a check fails: not constexpr, so the gait does not build
+void gait_amplitude_is_negative();
+void gait_exceeds_servo_range();
+
+constexpr uint16_t zowiPhase(double deg) {
+  return (uint16_t)(long)(deg * (65536.0 / 360));
+}
+
+constexpr int zowiScaled(int c, int half, int h) {
+  return c + half * h / 2;
+}
+
+constexpr bool zowiJointValid(int A, int Ah, int O, int Oh, int h) {
+  return zowiScaled(A, Ah, h) >= 0 &&
+         zowiScaled(O, Oh, h) + zowiScaled(A, Ah, h) <= 90 &&
+         zowiScaled(O, Oh, h) - zowiScaled(A, Ah, h) >= -90;
+}
+
+constexpr bool zowiAmplitudesValid(ZowiJoints A, ZowiJoints Ah, int h) {
+  return zowiScaled(A.v[0], Ah.v[0], h) >= 0 && zowiScaled(A.v[1], Ah.v[1], h) >= 0 &&
+         zowiScaled(A.v[2], Ah.v[2], h) >= 0 && zowiScaled(A.v[3], Ah.v[3], h) >= 0;
+}
+
+constexpr bool zowiRangeValid(ZowiJoints A, ZowiJoints Ah, ZowiJoints O, ZowiJoints Oh, int h) {
+  return zowiJointValid(A.v[0], Ah.v[0], O.v[0], Oh.v[0], h) &&
+         zowiJointValid(A.v[1], Ah.v[1], O.v[1], Oh.v[1], h) &&
+         zowiJointValid(A.v[2], Ah.v[2], O.v[2], Oh.v[2], h) &&
+         zowiJointValid(A.v[3], Ah.v[3], O.v[3], Oh.v[3], h);
+}
+
+constexpr ZowiGait zowiGait(ZowiJoints A, ZowiJoints Ah, ZowiJoints O, ZowiJoints Oh, ZowiPhases ph, int hmax = 0) {
+  return !zowiAmplitudesValid(A, Ah, 0) || !zowiAmplitudesValid(A, Ah, hmax ? hmax : ZOWI_GAIT_HREF)
+    ? (gait_amplitude_is_negative(), ZowiGait())
+    : !zowiRangeValid(A, Ah, O, Oh, 0) || !zowiRangeValid(A, Ah, O, Oh, hmax ? hmax : ZOWI_GAIT_HREF)
+    ? (gait_exceeds_servo_range(), ZowiGait())
+    : ZowiGait{
+        {(int8_t)A.v[0], (int8_t)A.v[1], (int8_t)A.v[2], (int8_t)A.v[3]},
+        {(int8_t)Ah.v[0], (int8_t)Ah.v[1], (int8_t)Ah.v[2], (int8_t)Ah.v[3]},
+        {(int8_t)O.v[0], (int8_t)O.v[1], (int8_t)O.v[2], (int8_t)O.v[3]},
+        {(int8_t)Oh.v[0], (int8_t)Oh.v[1], (int8_t)Oh.v[2], (int8_t)Oh.v[3]},
+        {zowiPhase(ph.deg[0]), zowiPhase(ph.deg[1]), zowiPhase(ph.deg[2]), zowiPhase(ph.deg[3])},
+        (uint8_t)hmax};
+}
+
+
+//-- zowiGait(A, Ah, O, Oh, phases in degrees, hmax)
+//-- Variants by direction: [0] = FORWARD / LEFT, [1] = BACKWARD / RIGHT
+
+//-- Hips in phase, feet in phase, hips and feet 90 degrees out of phase
+constexpr ZowiGait motion_walk[2] PROGMEM = {
+  zowiGait({30, 30, 20, 20}, {0, 0, 0, 0}, {0, 0, 4, -4}, {0, 0, 0, 0}, {0, 0, -90, -90}),
+  zowiGait({30, 30, 20, 20}, {0, 0, 0, 0}, {0, 0, 4, -4}, {0, 0, 0, 0}, {0, 0, 90, 90}),
+};
+
+//-- The walk, with a shorter step on the inner hip
+constexpr ZowiGait motion_turn[2] PROGMEM = {
+  zowiGait({30, 10, 20, 20}, {0, 0, 0, 0}, {0, 0, 4, -4}, {0, 0, 0, 0}, {0, 0, -90, -90}),
+  zowiGait({10, 30, 20, 20}, {0, 0, 0, 0}, {0, 0, 4, -4}, {0, 0, 0, 0}, {0, 0, -90, -90}),
+};
+
+//-- Feet 180 degrees out of phase, starting at an extreme
+constexpr ZowiGait motion_updown PROGMEM =
+  zowiGait({0, 0, 0, 0}, {0, 0, 2, 2}, {0, 0, 0, 0}, {0, 0, 2, -2}, {0, 0, -90, 90});
+
+//-- Feet in phase, offset half the amplitude
+constexpr ZowiGait motion_swing PROGMEM =
+  zowiGait({0, 0, 0, 0}, {0, 0, 2, 2}, {0, 0, 0, 0}, {0, 0, 1, -1}, {0, 0, 0, 0});
+
+//-- Feet in phase, offset the amplitude (the heels stay up)
+constexpr ZowiGait motion_tiptoeSwing PROGMEM =
+  zowiGait({0, 0, 0, 0}, {0, 0, 2, 2}, {0, 0, 0, 0}, {0, 0, 2, -2}, {0, 0, 0, 0});
+
+//-- Hips 180 degrees out of phase, h limited so that the feet do not hit
+constexpr ZowiGait motion_jitter PROGMEM =
+  zowiGait({0, 0, 0, 0}, {2, 2, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {-90, 90, 0, 0}, 25);
+
+//-- Jitter while up & down
+constexpr ZowiGait motion_ascendingTurn PROGMEM =
+  zowiGait({0, 0, 0, 0}, {2, 2, 2, 2}, {0, 0, 4, 4}, {0, 0, 2, -2}, {-90, 90, -90, 90}, 13);
+
+//-- Travelling wave on the feet, 60 degrees out of phase
+constexpr ZowiGait motion_moonwalker[2] PROGMEM = {
+  zowiGait({0, 0, 0, 0}, {0, 0, 2, 2}, {0, 0, 2, -2}, {0, 0, 1, -1}, {0, 0, -90, -150}),
+  zowiGait({0, 0, 0, 0}, {0, 0, 2, 2}, {0, 0, 2, -2}, {0, 0, 1, -1}, {0, 0, 90, 150}),
+};
+
+//-- Moonwalker with the hips of the walk. The phase of the hips is
+//-- 90 radians, as it has always been
+constexpr ZowiGait motion_crusaito[2] PROGMEM = {
+  zowiGait({25, 25, 0, 0}, {0, 0, 2, 2}, {0, 0, 4, -4}, {0, 0, 1, -1}, {90 * 180 / M_PI, 90 * 180 / M_PI, 0, -60}),
+  zowiGait({25, 25, 0, 0}, {0, 0, 2, 2}, {0, 0, 4, -4}, {0, 0, 1, -1}, {90 * 180 / M_PI, 90 * 180 / M_PI, 0, 60}),
+};
+
+constexpr ZowiGait motion_flapping[2] PROGMEM = {
+  zowiGait({12, 12, 0, 0}, {0, 0, 2, 2}, {0, 0, -10, 10}, {0, 0, 2, -2}, {0, 180, -90, 90}),
+  zowiGait({12, 12, 0, 0}, {0, 0, 2, 2}, {0, 0, -10, 10}, {0, 0, 2, -2}, {0, 180, 90, -90}),
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef Zowi_songs_h
+#define Zowi_songs_h
+
+//***********************************************************************************
+//**********************************PACKED SONGS*************************************
+//***********************************************************************************
+//-- Generated with tools/songc from tools/songc/zowi/*.notes
+//-- Played by Zowi::playSong(). Included only by Zowi.cpp
+
+// Generated by songc from connection
+// 6 steps, unit 1 ms, 0.23 s, 14 bytes
+const unsigned char song_connection[] PROGMEM = {
+  1,
+  65, 50, 0, 30, 77, 55, 0, 25, 82, 60, 0, 10, 0xFF
+};
+
+// Generated by songc from disconnection
+// 6 steps, unit 1 ms, 0.22 s, 14 bytes
+const unsigned char song_disconnection[] PROGMEM = {
+  1,
+  65, 50, 0, 30, 82, 55, 0, 25, 77, 50, 0, 10, 0xFF
+};
+
+// Generated by songc from mode3
+// 5 steps, unit 2 ms, 0.58 s, 12 bytes
+const unsigned char song_mode3[] PROGMEM = {
+  2,
+  77, 25, 0, 50, 80, 25, 0, 40, 87, 150, 0xFF
+};
+
+#endif
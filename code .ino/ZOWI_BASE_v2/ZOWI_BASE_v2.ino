@@ -18,6 +18,13 @@
 #include <BatReader.h>
 #include <US.h>
 #include <LedMatrix.h>
+#include <BuzzerSynth.h>
+#include <NoiseModel.h>
+#include <BeatTracker.h>
+#include <ClapPattern.h>
+#include <HandGesture.h>
+#include <PolarHistogram.h>
+#include <ServoPulse.h>
 
 //-- Library to manage external interruptions
 #include <EnableInterrupt.h> 
@@ -28,7 +35,13 @@ ZowiSerialCommand SCmd;  //The SerialCommand object
 
 //-- Zowi Library
 #include <Zowi.h>
+#include <Zowi_map.h>
 Zowi zowi;  //This is Zowi!!
+NoiseModel noiseModel;  //The noise of its servos
+BeatTracker beatTracker;  //The beat of the music, for MODE 1
+ClapPattern clapPattern;  //Rhythms of claps, as commands
+HandGesture handGestures;  //Gestures of a hand in front of the sensor, for MODE 0
+ZowiMap obstacleMap;  //The obstacles around, for MODE 2
  
 //---------------------------------------------------------
 //-- Configuration of pins where the servos are attached
@@ -56,6 +69,15 @@ Zowi zowi;  //This is Zowi!!
 #define PIN_SecondButton 6
 #define PIN_ThirdButton 7
 
+//---Clap commands: rhythms clapped to Zowi (but in MODE 4)
+#define CLAP_DANCE 1  //Two claps: MODE 1, as button A
+#define CLAP_WALK  2  //Three claps: MODE 2, walking, as button B
+#define CLAP_STOP  3  //A clap, a pause, two claps: stop, back to MODE 0
+
+//---Obstacle avoidance (MODE 2)
+#define OBSTACLE_CM 20  //Zowi walks ahead while the obstacle ahead is farther (cm)
+#define OPEN_AHEAD  23  //Degrees: the most open way is ahead
+
 
 ///////////////////////////////////////////////////////////////////
 //-- Global Variables -------------------------------------------//
@@ -73,9 +95,9 @@ int moveSize=15;         //Asociated with the height of some movements
 
 //---------------------------------------------------------
 //-- Zowi has 5 modes:
-//--    * MODE = 0: Zowi is awaiting  
-//--    * MODE = 1: Dancing mode!  
-//--    * MODE = 2: Obstacle detector mode  
+//--    * MODE = 0: Zowi is awaiting (and plays with a hand in front of it)
+//--    * MODE = 1: Dancing mode! (to the beat of the music heard)
+//--    * MODE = 2: Obstacle avoidance mode  
 //--    * MODE = 3: Noise detector mode   
 //--    * MODE = 4: ZowiPAD or any Teleoperation mode (listening SerialPort). 
 //---------------------------------------------------------
@@ -106,6 +128,24 @@ void setup(){
   
   //Set the servo pins
   zowi.init(PIN_YL,PIN_YR,PIN_RL,PIN_RR,true);
+
+  //Crossfade between consecutive movements (ZowiPAD commands, dances)
+  zowi.setTransition(300);
+
+  //Distance with the feet flat (the sensor looks ahead, not at the floor),
+  //noise all the time, with the noise of the servos removed
+  zowi.senseDistanceAt(PHASE_FEET_FLAT);
+  zowi.senseNoiseAt(SENSE_ANY);
+  zowi.attachNoiseModel(&noiseModel);
+  zowi.attachBeatTracker(&beatTracker);
+  zowi.attachHandGesture(&handGestures);
+  zowi.attachMap(&obstacleMap);
+
+  //Rhythms of claps, heard even while Zowi moves
+  zowi.attachClapPattern(&clapPattern);
+  zowi.setClapCommand("xx", CLAP_DANCE);
+  zowi.setClapCommand("xxx", CLAP_WALK);
+  zowi.setClapCommand("x-xx", CLAP_STOP);
  
   //Uncomment this to set the servo trims manually and save on EEPROM 
     //zowi.setTrims(TRIM_YL, TRIM_YR, TRIM_RL, TRIM_RR);
@@ -117,12 +157,14 @@ void setup(){
   //Interrumptions
   enableInterrupt(PIN_SecondButton, secondButtonPushed, RISING);
   enableInterrupt(PIN_ThirdButton, thirdButtonPushed, RISING);
+  enableInterrupt(PIN_Echo, echoEdge, CHANGE); //Echoes timed even during the motions
 
   //Setup callbacks for SerialCommand commands 
   SCmd.addCommand("S", receiveStop);      //  sendAck & sendFinalAck
   SCmd.addCommand("L", receiveLED);       //  sendAck & sendFinalAck
   SCmd.addCommand("T", recieveBuzzer);    //  sendAck & sendFinalAck
   SCmd.addCommand("M", receiveMovement);  //  sendAck & sendFinalAck
+  SCmd.addCommand("V", receiveVelocity);  //  No ack (joystick rate)
   SCmd.addCommand("H", receiveGesture);   //  sendAck & sendFinalAck
   SCmd.addCommand("K", receiveSing);      //  sendAck & sendFinalAck
   SCmd.addCommand("C", receiveTrims);     //  sendAck & sendFinalAck
@@ -230,6 +272,7 @@ void loop() {
 
     MODE=4;
     zowi.putMouth(happyOpen);
+    zowi.followBeat(false); //ZowiPAD sets the tempo
 
     //Disable Pin Interruptions
     disableInterrupt(PIN_SecondButton);
@@ -238,6 +281,8 @@ void loop() {
     buttonPushed=false;
   }
 
+  if (MODE!=4 && !buttonPushed) clapCommand(zowi.getClapCommand());
+
 
   //First attemp to initial software
   if (buttonPushed){  
@@ -262,6 +307,12 @@ void loop() {
     }
      
     zowi.putMouth(happyOpen);
+    zowi.getNoisePeak(); //Forget the noise heard in the last mode
+    zowi.followBeat(MODE==1); //Dance to the beat of the music heard, if any
+    if (MODE==2){ //A new map of the obstacles around
+      zowi.resetMap();
+      obstacleDetected=false;
+    }
 
     buttonPushed=false;
     buttonAPushed=false;
@@ -274,6 +325,8 @@ void loop() {
       //-- MODE 0 - Zowi is awaiting
       //---------------------------------------------------------
       case 0:
+
+        handGesture(zowi.getHandGesture());
       
         //Every 80 seconds in this mode, Zowi falls asleep 
         if (millis()-previousMillis>=80000){
@@ -307,75 +360,19 @@ void loop() {
         break;
 
 
-      //-- MODE 2 - Obstacle detector mode
+      //-- MODE 2 - Obstacle avoidance mode
       //---------------------------------------------------------
       case 2:
 
-        if(obstacleDetected){
-
-            if(!buttonPushed){
-              zowi.putMouth(bigSurprise);
-              zowi.sing(S_surprise);
-              zowi.jump(5, 500);
-            }  
-
-            if(!buttonPushed){
-              zowi.putMouth(confused);
-              zowi.sing(S_cuddly);
-            }  
-
-            //Zowi takes two steps back
-            for(int i=0;i<3;i++){ 
-              if(buttonPushed){break;}
-              zowi.walk(1,1300,-1);
-            }
-
-            delay(100);
-            obstacleDetector();
-            delay(100);
-
-
-           //If there are no obstacles and no button is pressed, Zowi shows a smile
-           if((obstacleDetected==true)||(buttonPushed==true)){break;}            
-           else{
-              zowi.putMouth(smile);
-              delay(50);
-              obstacleDetector();
-           } 
-            
-           
-           //If there are no obstacles and no button is pressed, Zowi shows turns left
-           for(int i=0; i<3; i++){
-              if((obstacleDetected==true)||(buttonPushed==true)){break;}            
-              else{ 
-                  zowi.turn(1,1000,1); 
-                  obstacleDetector();
-              } 
-           }
-            
-            //If there are no obstacles and no button is pressed, Zowi is happy
-            if((obstacleDetected==true)||(buttonPushed==true)){break;}           
-            else{
-                zowi.home();
-                zowi.putMouth(happyOpen);
-                zowi.sing(S_happy_short);
-                delay(200);
-            }     
-        
-
-        }else{
-
-            zowi.walk(1,1000,1); //Zowi walk straight
-            obstacleDetector();
-        }   
-
+        obstacleAvoider();
         break;
 
 
       //-- MODE 3 - Noise detector mode
       //---------------------------------------------------------  
       case 3:
-        if (zowi.getNoise()>=650){ //740
+        zowi.update(); //Noise readings
+        if (zowi.getNoisePeak()>=650){ //740. Also heard during the last dance
           
           delay(50);  //Wait for the possible 'lag' of the button interruptions. 
                       //Sometimes, the noise sensor detect the button before the interruption takes efect 
@@ -390,7 +387,6 @@ void loop() {
             randomDance=random(5,21);
             move(randomDance);
             zowi.home();
-            delay(500); //Wait for possible noise of the servos while get home
           }
           
           if(!buttonPushed){zowi.putMouth(happyOpen);}
@@ -427,6 +423,69 @@ void loop() {
 //-- Functions --------------------------------------------------//
 ///////////////////////////////////////////////////////////////////
 
+//-- Function to run the clap commands: the modes are changed as with the buttons
+void clapCommand(int command){
+
+    switch (command) {
+      case CLAP_DANCE:
+        buttonAPushed=true;
+        buttonPushed=true;
+        break;
+
+      case CLAP_WALK:
+        buttonBPushed=true;
+        buttonPushed=true;
+        break;
+
+      case CLAP_STOP:
+        if (MODE!=0) {
+          MODE=0;
+          zowi.followBeat(false);
+          zowi.home();
+          zowi.sing(S_buttonPushed);
+          zowi.putMouth(happyOpen);
+          previousMillis=millis();
+        }
+        break;
+    }
+}
+
+//-- Function to play with the hand in MODE 0: Zowi steps back from a hand that
+//-- comes, follows a hand that goes, smiles at a hand that stays and turns when
+//-- a hand swipes in front of it
+void handGesture(int gesture){
+
+    switch (gesture) {
+      case HAND_APPROACH:
+        zowi.walk(1,1300,BACKWARD);
+        break;
+
+      case HAND_RETREAT:
+        zowi.walk(1,1300,FORWARD);
+        break;
+
+      case HAND_HOLD:
+        zowi.putMouth(smile);
+        zowi.sing(S_happy_short);
+        zowi.putMouth(happyOpen);
+        break;
+
+      case HAND_SWIPE:
+        zowi.turn(1,1000,LEFT);
+        break;
+
+      default:
+        return;
+    }
+    previousMillis=millis(); //Zowi does not fall asleep while it plays
+}
+
+//-- Function executed on both edges of the ultrasonic echo
+void echoEdge(){
+
+    zowi.distanceEdge();
+}
+
 //-- Function executed when second button is pushed
 void secondButtonPushed(){ 
 
@@ -450,16 +509,35 @@ void thirdButtonPushed(){
 }
 
 
-//-- Function to read distance sensor & to actualize obstacleDetected variable
-void obstacleDetector(){
+//-- Function to walk avoiding the obstacles (MODE 2): Zowi walks while the way ahead is
+//-- open. At an obstacle it turns, a step at a time, to the most open way of its map of
+//-- the distances around (see Zowi::getOpenDirection), or walks back when there is none
+void obstacleAvoider(){
 
-   int distance = zowi.getDistance();
+   unsigned int distance = zowi.getMapDistance(0); //0: nothing seen ahead yet
 
-        if(distance<15){
-          obstacleDetected = true;
-        }else{
-          obstacleDetected = false;
-        }
+   if(distance==0 || distance>=OBSTACLE_CM){
+      if(obstacleDetected){
+        zowi.putMouth(happyOpen);
+        obstacleDetected = false;
+      }
+      zowi.walk(1,1000,FORWARD);
+      return;
+   }
+
+   if(!obstacleDetected){
+      zowi.putMouth(bigSurprise);
+      zowi.sing(S_surprise);
+      zowi.putMouth(confused);
+      obstacleDetected = true;
+   }
+
+   int direction = zowi.getOpenDirection();
+   if(abs(direction)<OPEN_AHEAD){
+      zowi.walk(1,1000,BACKWARD); //No way out around
+   }else{
+      zowi.turn(1,1000,direction>0 ? LEFT : RIGHT);
+   }
 }
 
 
@@ -668,6 +746,30 @@ void receiveMovement(){
 }
 
 
+//-- Function to receive velocity commands (joystick). They are not
+//-- acknowledged, so that they can be sent at the rate of the joystick;
+//-- the gait changes at the next servo sample, without restarting
+void receiveVelocity(){
+
+    //Definition of Velocity Bluetooth command
+    //V  speed  turn   (-100 to 100, turn > 0 = left)
+    //Example of receiveVelocity Bluetooth commands
+    //V 80 -20
+    int v, w;
+    char *arg;
+    arg = SCmd.next();
+    if (arg != NULL) {v=atoi(arg);}
+    else {v=0;}
+
+    arg = SCmd.next();
+    if (arg != NULL) {w=atoi(arg);}
+    else {w=0;}
+
+    zowi.setVelocity(v, w);
+    moveId = 40;
+}
+
+
 //-- Function to execute the right movement according the movement command received.
 void move(int moveId){
 
@@ -737,6 +839,10 @@ void move(int moveId){
     case 20: //M 20 500 15
       zowi.ascendingTurn(1,T,moveSize);
       break;
+    case 40: //V 80 -20
+      zowi.update();
+      manualMode = true;
+      break;
     default:
         manualMode = true;
       break;
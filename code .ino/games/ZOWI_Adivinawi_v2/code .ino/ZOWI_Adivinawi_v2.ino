@@ -15,6 +15,8 @@
 #include <BatReader.h>
 #include <US.h>
 #include <LedMatrix.h>
+#include <BuzzerSynth.h>
+#include <ServoPulse.h>
 
 //-- Library to manage external interruptions
 #include <EnableInterrupt.h> 
@@ -15,6 +15,9 @@
 #include <BatReader.h>
 #include <US.h>
 #include <LedMatrix.h>
+#include <BuzzerSynth.h>
+#include <NoiseModel.h>
+#include <ServoPulse.h>
 
 //-- Library to manage external interruptions
 #include <EnableInterrupt.h> 
@@ -26,6 +29,7 @@ ZowiSerialCommand SCmd;  //The SerialCommand object
 //-- Zowi Library
 #include <Zowi.h>
 Zowi zowi;  //This is Zowi!!
+NoiseModel noiseModel;  //The noise of its servos
 
 //---------------------------------------------------------
 //-- Configuration of pins where the servos are attached
@@ -111,6 +115,10 @@ void setup() {
   
   //Set the servo pins
   zowi.init(PIN_YL,PIN_YR,PIN_RL,PIN_RR,true);
+
+  //Noise readings all the time, with the noise of the servos removed
+  zowi.senseNoiseAt(SENSE_ANY);
+  zowi.attachNoiseModel(&noiseModel);
  
   //Uncomment this to set the servo trims manually and save on EEPROM 
     //zowi.setTrims(TRIM_YL, TRIM_YR, TRIM_RL, TRIM_RR);
@@ -257,10 +265,10 @@ void loop() {
 
         }else{
 
-          delay(100);
           int obstacleDistance = zowi.getDistance();
-          int noise = zowi.getNoise();
-          delay(100);
+          unsigned long start=millis();
+          while(millis()-start<200) zowi.update(); //Noise readings
+          int noise = zowi.getNoisePeak(); //Loudest since the last check (also while moving), servo noise removed
         
           //ALARM!!!!
           if ((noise>=680)||(obstacleDistance < initDistance)){
@@ -298,10 +306,10 @@ void loop() {
 
         }else{
 
-          delay(100);
           int obstacleDistance = zowi.getDistance();
-          int noise = zowi.getNoise();
-          delay(100);
+          unsigned long start=millis();
+          while(millis()-start<200) zowi.update(); //Noise readings
+          int noise = zowi.getNoisePeak(); //Loudest since the last check (also while moving), servo noise removed
         
           //ALARM!!!!
           if ((noise>=680)||(obstacleDistance < initDistance)){
@@ -589,6 +597,7 @@ void ZowiArmingAlarmSystem(){
 
     if(!buttonPushed){
       alarmActivated = true;
+      zowi.getNoisePeak(); //Forget the noise heard while arming
       delay(100);
       initDistance = zowi.getDistance();
       delay(100);
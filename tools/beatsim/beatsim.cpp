@@ -0,0 +1,289 @@
+//--------------------------------------------------------------
+//-- beatsim
+//-- Runs the BeatTracker library on recorded (or synthetic)
+//-- music, as the noise sensor of Zowi would hear it, and reports
+//-- the tempo found, how long it takes and the host time per
+//-- update
+//--------------------------------------------------------------
+//-- Build (host):  g++ -O2 -I../host -o beatsim beatsim.cpp
+//-- Usage:        beatsim [-t bpm] [-o ms] [-g gain] [-v] file.wav
+//--               beatsim [-v] [-w out.wav] -s bpm:seconds[,bpm:seconds...]
+//--    -t : the tempo of the file, to measure the latency and the
+//--         beat error
+//--    -o : time of the first beat of the file (ms), to measure the
+//--         beat error
+//--    -g : gain of the sensor after normalizing the peak (default 1)
+//--    -s : synthetic drums (kick, snare, hi-hats and noise) at these
+//--         tempos, one after another. -t and -o are implied
+//--    -v : print the tempo every second and the beats
+//--    -w : write the synthetic drums to a WAV file (8000 Hz, 8 bit,
+//--         mono), to try them as a file
+//--
+//-- Example: zowi112.wav is beatsim -w zowi112.wav -s 112:12, and
+//--    beatsim -t 112 zowi112.wav
+//--    zowi112.wav is synthetic, not a recording: the tracker has not
+//--    been measured on real music here. A clip of real music goes
+//--    the same way, e.g. converted with
+//--    sox song.mp3 -r 8000 -b 8 -c 1 clip.wav trim 0 15
+//--
+//-- Input: PCM WAV, 8 or 16 bits, mono or stereo, any sample rate.
+//-- The sensor is modelled as a peak detector (1 ms attack, 20 ms
+//-- release) on a 300 level floor, read as Zowi::senseNoiseAt
+//-- does: windows of SENSE_NOISE_SAMPLES reads, SENSE_NOISE_PERIOD
+//-- ms apart, averaged. The latency is the time until the tempo
+//-- stays within 4% of the right one (or of a tempo change); the
+//-- beat error is measured after that.
+//--------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#define ARDUINO 100
+#include "../../arduino libraries/BeatTracker/BeatTracker.cpp"
+#undef min
+#undef max
+
+//-- Must match Zowi.h
+#define SENSE_NOISE_SAMPLES 4
+#define SENSE_NOISE_PERIOD 2
+
+#define FLOOR 300
+
+static unsigned int le16(const unsigned char *p) { return p[0] | (p[1] << 8); }
+static unsigned long le32(const unsigned char *p) { return le16(p) | ((unsigned long)le16(p + 2) << 16); }
+
+static void fail(const char *msg, const char *arg = "") {
+  fprintf(stderr, "beatsim: %s%s\n", msg, arg);
+  exit(1);
+}
+
+//-- Read a WAV file as mono samples in [-1, 1] (as tools/wav2sample)
+static std::vector<double> readWav(const char *path, int &rate) {
+  FILE *f = fopen(path, "rb");
+  if (!f) fail("cannot open ", path);
+  std::vector<unsigned char> file;
+  unsigned char buffer[4096];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) file.insert(file.end(), buffer, buffer + n);
+  fclose(f);
+
+  if (file.size() < 12 || memcmp(&file[0], "RIFF", 4) || memcmp(&file[8], "WAVE", 4))
+    fail("not a WAV file: ", path);
+
+  int format = 0, channels = 0, bits = 0;
+  const unsigned char *data = 0;
+  unsigned long dataSize = 0;
+
+  for (size_t pos = 12; pos + 8 <= file.size();) {
+    unsigned long size = le32(&file[pos + 4]);
+    const unsigned char *chunk = &file[pos + 8];
+    if (pos + 8 + size > file.size()) size = file.size() - pos - 8;
+
+    if (!memcmp(&file[pos], "fmt ", 4) && size >= 16) {
+      format = le16(chunk);
+      channels = le16(chunk + 2);
+      rate = le32(chunk + 4);
+      bits = le16(chunk + 14);
+    }
+    else if (!memcmp(&file[pos], "data", 4)) {
+      data = chunk;
+      dataSize = size;
+    }
+    pos += 8 + size + (size & 1);
+  }
+
+  if (format != 1) fail("only PCM WAV files are supported");
+  if (bits != 8 && bits != 16) fail("only 8 or 16 bit WAV files are supported");
+  if (channels < 1 || !data) fail("no audio data in ", path);
+
+  int frameSize = channels * bits / 8;
+  std::vector<double> out(dataSize / frameSize);
+  for (size_t i = 0; i < out.size(); i++) {
+    double sum = 0;
+    for (int c = 0; c < channels; c++) {
+      const unsigned char *s = data + i * frameSize + c * bits / 8;
+      if (bits == 8) sum += (s[0] - 128) / 128.0;
+      else sum += (short)le16(s) / 32768.0;
+    }
+    out[i] = sum / channels;
+  }
+  return out;
+}
+
+struct Segment {
+  double bpm, seconds;
+};
+
+//-- Drums at 8 kHz: kick on the beats, snare on 2 and 4, hi-hats
+//-- on the eighths, with some swing in the levels, and noise
+static std::vector<double> synth(const std::vector<Segment> &segments, int rate) {
+  std::vector<double> out;
+  srand(1);
+  for (size_t s = 0; s < segments.size(); s++) {
+    double beat = 60.0 / segments[s].bpm;
+    size_t start = out.size();
+    out.resize(start + (size_t)(segments[s].seconds * rate), 0.0);
+    for (int k = 0; k * beat / 2 < segments[s].seconds; k++) {
+      size_t at = start + (size_t)(k * beat / 2 * rate);
+      double velocity = 0.8 + 0.2 * rand() / RAND_MAX;
+      for (size_t i = 0; at + i < out.size() && i < (size_t)(0.15 * rate); i++) {
+        double t = (double)i / rate;
+        if (k % 2 == 0) out[at + i] += 0.6 * velocity * sin(2 * M_PI * 60 * t) * exp(-t / 0.05);
+        if (k % 4 == 2) out[at + i] += 0.4 * velocity * (2.0 * rand() / RAND_MAX - 1) * exp(-t / 0.03);
+        out[at + i] += 0.15 * velocity * (2.0 * rand() / RAND_MAX - 1) * exp(-t / 0.01);
+      }
+    }
+  }
+  for (size_t i = 0; i < out.size(); i++) out[i] += 0.02 * (2.0 * rand() / RAND_MAX - 1);
+  return out;
+}
+
+static void put16(FILE *f, unsigned int v) { fputc(v & 0xFF, f); fputc(v >> 8, f); }
+static void put32(FILE *f, unsigned long v) { put16(f, v & 0xFFFF); put16(f, v >> 16); }
+
+//-- Write the samples as an 8 bit mono PCM WAV file
+static void writeWav(const char *path, const std::vector<double> &sound, int rate) {
+  FILE *f = fopen(path, "wb");
+  if (!f) fail("cannot write ", path);
+  fwrite("RIFF", 1, 4, f);
+  put32(f, 36 + sound.size() + (sound.size() & 1));
+  fwrite("WAVEfmt ", 1, 8, f);
+  put32(f, 16);
+  put16(f, 1);
+  put16(f, 1);
+  put32(f, rate);
+  put32(f, rate);
+  put16(f, 1);
+  put16(f, 8);
+  fwrite("data", 1, 4, f);
+  put32(f, sound.size());
+  for (size_t i = 0; i < sound.size(); i++)
+    fputc(std::max(0, std::min(255, (int)lround(128 + 127 * sound[i]))), f);
+  if (sound.size() & 1) fputc(0, f);
+  fclose(f);
+}
+
+int main(int argc, char *argv[]) {
+  double tempo = 0, offset = 0, gain = 1;
+  bool verbose = false;
+  const char *path = 0, *out = 0;
+  std::vector<Segment> segments;
+  const char *usage = "usage: beatsim [-t bpm] [-o ms] [-g gain] [-v] file.wav | [-w out.wav] -s bpm:seconds,...";
+
+  for (int i = 1; i < argc; i++) {
+    std::string a(argv[i]);
+    if (a == "-v") verbose = true;
+    else if (a == "-t" && i + 1 < argc) tempo = atof(argv[++i]);
+    else if (a == "-o" && i + 1 < argc) offset = atof(argv[++i]);
+    else if (a == "-g" && i + 1 < argc) gain = atof(argv[++i]);
+    else if (a == "-w" && i + 1 < argc) out = argv[++i];
+    else if (a == "-s" && i + 1 < argc) {
+      for (char *p = strtok(argv[++i], ","); p; p = strtok(0, ",")) {
+        Segment s = {atof(p), 20};
+        if (strchr(p, ':')) s.seconds = atof(strchr(p, ':') + 1);
+        if (s.bpm < 30 || s.seconds <= 0) fail("bad segment ", p);
+        segments.push_back(s);
+      }
+    }
+    else if (a[0] == '-') fail(usage);
+    else path = argv[i];
+  }
+  if (!path == segments.empty() || (out && path)) fail(usage);
+
+  int rate = 8000;
+  std::vector<double> sound = path ? readWav(path, rate) : synth(segments, rate);
+  if (path) segments.push_back({tempo, (double)sound.size() / rate});
+  else if (out) writeWav(out, sound, rate);
+
+  //-- The sensor: peak detector, normalized to the ADC range
+  std::vector<double> env(sound.size());
+  double e = 0, peak = 1e-9;
+  double attack = 1 - exp(-1.0 / (0.001 * rate)), release = 1 - exp(-1.0 / (0.020 * rate));
+  for (size_t i = 0; i < sound.size(); i++) {
+    double x = fabs(sound[i]);
+    e += (x - e) * (x > e ? attack : release);
+    env[i] = e;
+    peak = std::max(peak, e);
+  }
+
+  //-- The true beats, to measure against
+  std::vector<double> beats;
+  std::vector<double> changes;
+  double t0 = offset / 1000;
+  for (size_t s = 0; s < segments.size(); s++) {
+    changes.push_back(t0);
+    if (segments[s].bpm > 0)
+      for (double t = t0; t < t0 + segments[s].seconds - 1e-9; t += 60.0 / segments[s].bpm) beats.push_back(t);
+    t0 += segments[s].seconds;
+  }
+
+  BeatTracker tracker;
+  double busy = 0, worst = 0;
+  long updates = 0;
+  unsigned long duration = (unsigned long)(sound.size() * 1000.0 / rate);
+  std::vector<double> heard;
+  std::vector<double> lockedAt(segments.size(), -1);
+  std::vector<int> beatsIn(segments.size(), 0);
+  std::vector<double> errorIn(segments.size(), 0);
+  std::vector<unsigned int> lastIn(segments.size(), 0);
+
+  for (unsigned long ms = 0; ms + SENSE_NOISE_SAMPLES * SENSE_NOISE_PERIOD <= duration;
+       ms += SENSE_NOISE_SAMPLES * SENSE_NOISE_PERIOD) {
+    long sum = 0;
+    for (int k = 0; k < SENSE_NOISE_SAMPLES; k++) {
+      size_t i = (size_t)((ms + k * SENSE_NOISE_PERIOD) * rate / 1000);
+      sum += std::min(1023, (int)(FLOOR + gain * env[i] / peak * (1023 - FLOOR)));
+    }
+
+    auto a = std::chrono::steady_clock::now();
+    bool beat = tracker.update(ms, sum / SENSE_NOISE_SAMPLES);
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - a).count();
+    busy += ns;
+    worst = std::max(worst, ns);
+    updates++;
+
+    //-- Segment of this time, and whether its tempo is right
+    double now = ms / 1000.0;
+    size_t s = 0;
+    while (s + 1 < changes.size() && now >= changes[s + 1]) s++;
+    double right = segments[s].bpm;
+    bool ok = right > 0 && tracker.bpm() && fabs(tracker.bpm() - right) <= 0.04 * right;
+    lastIn[s] = tracker.bpm();
+    if (!ok) lockedAt[s] = -1;
+    else if (lockedAt[s] < 0) lockedAt[s] = now;
+
+    if (beat) {
+      heard.push_back(now);
+      if (verbose) printf("%8.3f beat\n", now);
+      if (ok && lockedAt[s] >= 0 && !beats.empty()) {
+        double nearest = *std::min_element(beats.begin(), beats.end(), [now](double x, double y) {
+          return fabs(x - now) < fabs(y - now);
+        });
+        errorIn[s] += fabs(nearest - now);
+        beatsIn[s]++;
+      }
+    }
+    if (verbose && ms % 1000 == 0)
+      printf("%8.3f %3u BPM, confidence %u\n", now, tracker.bpm(), tracker.confidence());
+  }
+
+  for (size_t s = 0; s < segments.size(); s++) {
+    printf("segment %zu: %.1f s", s + 1, segments[s].seconds);
+    if (segments[s].bpm > 0) {
+      printf(", %.1f BPM: ", segments[s].bpm);
+      if (lockedAt[s] < 0) printf("not found");
+      else printf("found after %.2f s", lockedAt[s] - changes[s]);
+      if (lockedAt[s] < 0) printf(" (%u BPM at the end)", lastIn[s]);
+      if (beatsIn[s]) printf(", beat error %.0f ms", 1000 * errorIn[s] / beatsIn[s]);
+    }
+    printf("\n");
+  }
+  printf("final tempo %u BPM, confidence %u, %zu beats\n", tracker.bpm(), tracker.confidence(), heard.size());
+  printf("host time per update: mean %.0f ns, worst %.0f ns (%ld updates)\n", busy / updates, worst, updates);
+  return 0;
+}
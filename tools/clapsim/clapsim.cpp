@@ -0,0 +1,173 @@
+//--------------------------------------------------------------
+//-- clapsim
+//-- Runs the ClapPattern library on lists of clap times, as the
+//-- noise sensor of Zowi would hear them, and reports the
+//-- commands recognised against the rhythms clapped and the host
+//-- time per update
+//--------------------------------------------------------------
+//-- Build (host):  g++ -O2 -I../host -o clapsim clapsim.cpp
+//-- Usage:        clapsim [-j ms] [-k scale] [-n level] [-r runs]
+//--                       [-v] file.claps
+//--    -j : random error of each clap time, up to +- ms
+//--    -k : times scaled by this (e.g. 1.5 = clapped slower)
+//--    -n : noise of the levels, up to +- level (default 20)
+//--    -r : runs of the file, each with other random errors
+//--    -v : print every sequence
+//--
+//-- Input: one sequence per line, the rhythm clapped and the clap
+//-- times in ms, e.g. "x-xx 0 620 860" (# comments). The rhythms
+//-- xx, xxx and x-xx get the commands 1, 2 and 3, as in
+//-- ZOWI_BASE; any other rhythm (e.g. "x" or "xxxx") should get
+//-- none. The sequences are 3 s apart.
+//-- Each clap is a rise of 300 to 700 over a background of 300,
+//-- falling in 30 ms. The levels are read as Zowi::senseNoiseAt
+//-- does: windows of SENSE_NOISE_SAMPLES reads, SENSE_NOISE_PERIOD
+//-- ms apart, averaged.
+//--------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#define ARDUINO 100
+#include "../../arduino libraries/ClapPattern/ClapPattern.cpp"
+#undef min
+#undef max
+
+//-- Must match Zowi.h
+#define SENSE_NOISE_SAMPLES 4
+#define SENSE_NOISE_PERIOD 2
+
+#define BACKGROUND 300
+#define SPACING 3000   //-- ms between sequences
+
+struct Sequence {
+  std::string rhythm;
+  std::vector<double> times;
+  int line;
+};
+
+static void fail(const char *msg, const char *arg) {
+  fprintf(stderr, "clapsim: %s%s\n", msg, arg);
+  exit(1);
+}
+
+static std::vector<Sequence> readClaps(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (!f) fail("cannot open ", path);
+  std::vector<Sequence> out;
+  char line[512];
+  for (int n = 1; fgets(line, sizeof(line), f); n++) {
+    char *hash = strchr(line, '#');
+    if (hash) *hash = 0;
+    char *word = strtok(line, " \t\r\n");
+    if (!word) continue;
+    Sequence s;
+    s.rhythm = word;
+    s.line = n;
+    while ((word = strtok(0, " \t\r\n"))) s.times.push_back(atof(word));
+    if (s.times.empty()) fail("no clap times in ", s.rhythm.c_str());
+    out.push_back(s);
+  }
+  fclose(f);
+  return out;
+}
+
+static double uniform() {
+  return 2.0 * rand() / RAND_MAX - 1;
+}
+
+int main(int argc, char *argv[]) {
+  double jitter = 0, scale = 1, noise = 20;
+  int runs = 1;
+  bool verbose = false;
+  const char *path = 0;
+
+  for (int i = 1; i < argc; i++) {
+    std::string a(argv[i]);
+    if (a == "-v") verbose = true;
+    else if (a == "-j" && i + 1 < argc) jitter = atof(argv[++i]);
+    else if (a == "-k" && i + 1 < argc) scale = atof(argv[++i]);
+    else if (a == "-n" && i + 1 < argc) noise = atof(argv[++i]);
+    else if (a == "-r" && i + 1 < argc) runs = atoi(argv[++i]);
+    else if (a[0] == '-') fail("usage: clapsim [-j ms] [-k scale] [-n level] [-r runs] [-v] file.claps", "");
+    else path = argv[i];
+  }
+  if (!path) fail("usage: clapsim [-j ms] [-k scale] [-n level] [-r runs] [-v] file.claps", "");
+
+  std::vector<Sequence> seqs = readClaps(path);
+  const char *rhythms[] = {"xx", "xxx", "x-xx"};
+
+  ClapPattern claps;
+  for (int c = 0; c < 3; c++) claps.setPattern(rhythms[c], c + 1);
+
+  int right = 0, wrong = 0, missed = 0, extra = 0, rejected = 0, others = 0;
+  double busy = 0, worst = 0;
+  long updates = 0;
+  srand(1);
+
+  for (int r = 0; r < runs; r++) {
+    for (size_t q = 0; q < seqs.size(); q++) {
+      const Sequence &s = seqs[q];
+      int expected = 0;
+      for (int c = 0; c < 3; c++)
+        if (s.rhythm == rhythms[c]) expected = c + 1;
+
+      //-- The claps of this sequence, 500 ms after its start
+      std::vector<double> at, peak;
+      for (size_t i = 0; i < s.times.size(); i++) {
+        at.push_back(500 + (s.times[i] - s.times[0]) * scale + jitter * uniform());
+        peak.push_back(500 + 200 * uniform());
+      }
+
+      std::vector<int> heard;
+      unsigned long t0 = (unsigned long)(r * seqs.size() + q) * SPACING;
+      for (unsigned long ms = 0; ms < SPACING; ms += SENSE_NOISE_SAMPLES * SENSE_NOISE_PERIOD) {
+        long sum = 0;
+        for (int k = 0; k < SENSE_NOISE_SAMPLES; k++) {
+          double t = ms + k * SENSE_NOISE_PERIOD, level = BACKGROUND + noise * uniform();
+          for (size_t i = 0; i < at.size(); i++)
+            if (t >= at[i]) level += peak[i] * exp(-(t - at[i]) / 30);
+          sum += std::min(1023, (int)level);
+        }
+
+        auto a = std::chrono::steady_clock::now();
+        unsigned char command = claps.update(t0 + ms, sum / SENSE_NOISE_SAMPLES);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - a).count();
+        busy += ns;
+        worst = std::max(worst, ns);
+        updates++;
+        if (command) heard.push_back(command);
+      }
+
+      bool ok = expected ? heard.size() == 1 && heard[0] == expected : heard.empty();
+      if (expected) {
+        if (ok) right++;
+        else if (heard.empty()) missed++;
+        else wrong++;
+      }
+      else {
+        others++;
+        if (ok) rejected++;
+        else extra++;
+      }
+      if (verbose || !ok) {
+        printf("line %d, %-6s:", s.line, s.rhythm.c_str());
+        for (size_t i = 0; i < at.size(); i++) printf(" %.0f", at[i] - at[0]);
+        printf(" ->");
+        if (heard.empty()) printf(" none");
+        for (size_t i = 0; i < heard.size(); i++) printf(" %s", rhythms[heard[i] - 1]);
+        printf("%s\n", ok ? "" : "  (wrong)");
+      }
+    }
+  }
+
+  printf("rhythms with a command: %d right, %d wrong, %d missed\n", right, wrong, missed);
+  printf("other rhythms: %d with no command, %d with one\n", rejected, extra);
+  printf("host time per update: mean %.0f ns, worst %.0f ns (%ld updates)\n", busy / updates, worst, updates);
+  return 0;
+}
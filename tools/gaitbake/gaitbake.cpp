@@ -0,0 +1,247 @@
+//--------------------------------------------------------------
+//-- gaitbake
+//-- Bakes the oscillating gaits of Zowi into delta-encoded
+//-- PROGMEM tables, one row per servo frame, that are played
+//-- with GaitLayer (MotionLayer.h) / Zowi::playGait()
+//--------------------------------------------------------------
+//-- Build (host):  g++ -O2 -std=gnu++11 -I../host -o gaitbake gaitbake.cpp
+//-- Usage:        gaitbake [-w] gait... > gaits.h
+//--    gait : name:T[:h[:dir]], e.g. walk:1000:0:-1 or
+//--           moonwalker:900:20:1. h and dir default as in Zowi.h.
+//--           A file ending in .gaits has one gait per line
+//--           (# comments)
+//--    -w   : print on stderr, for each table, its flash bytes and
+//--           error, and the host time per servo frame of
+//--           OscillatorBank<4> playing it with GaitLayer, as
+//--           Zowi::playGait, against the oscillators computing the
+//--           same gait, as Zowi::_execute (ratio: oscillators /
+//--           baked). Then the bytes of all the tables
+//--
+//-- The gaits are the tables of Zowi_motions.h, as Zowi::_execute
+//-- uses them with no battery throttling: the table is one cycle
+//-- of the oscillators, from phase 0, sampled every
+//-- OSCILLATOR_FRAME. T is rounded to a whole number of frames.
+//--
+//-- Output: rows, joints, then the rows of one cycle. Each row has
+//-- one entry per joint: a position change (signed byte), or
+//-- GAIT_ABSOLUTE and the position (16 bits, little endian). The
+//-- first row is absolute. Positions are 1/OSCILLATOR_FINE degrees
+//-- from home (90).
+//--------------------------------------------------------------
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <vector>
+
+//-- The oscillators and the player of the firmware, for -w
+#define ARDUINO 100
+#include "../../arduino libraries/Oscillator/OscillatorWaves.cpp"
+#include "../../arduino libraries/Oscillator/MotionLayer.cpp"
+#include "../../arduino libraries/Oscillator/OscillatorBank.h"
+unsigned long simMicros;
+unsigned long ServoPulse::frame;
+int ServoPulse::position[SERVOPULSE_CHANNELS];
+#undef min
+#undef max
+
+//-- The gait tables of the firmware
+#include "../../arduino libraries/Zowi/Zowi_motions.h"
+
+#define TIMED_FRAMES 200000
+
+struct Gait {
+  const char *name;
+  int T, h, dir;             //-- Defaults of Zowi.h
+  const char *fwd, *back;    //-- Names of dir = 1 / -1
+  const ZowiGait *gait;      //-- [0] = dir 1, [1] = dir -1
+};
+
+static const Gait gaits[] = {
+  {"walk", 1000, 0, 1, "forward", "backward", motion_walk},
+  {"turn", 2000, 0, 1, "left", "right", motion_turn},
+  {"updown", 1000, 20, 0, 0, 0, &motion_updown},
+  {"swing", 1000, 20, 0, 0, 0, &motion_swing},
+  {"tiptoeSwing", 900, 20, 0, 0, 0, &motion_tiptoeSwing},
+  {"jitter", 500, 20, 0, 0, 0, &motion_jitter},
+  {"ascendingTurn", 900, 20, 0, 0, 0, &motion_ascendingTurn},
+  {"moonwalker", 900, 20, 1, "left", "right", motion_moonwalker},
+  {"crusaito", 900, 20, 1, "forward", "backward", motion_crusaito},
+  {"flapping", 1000, 20, 1, "forward", "backward", motion_flapping},
+};
+
+
+static void fail(const std::string &msg) {
+  fprintf(stderr, "gaitbake: %s\n", msg.c_str());
+  exit(1);
+}
+
+struct Baked {
+  std::string spec, name;
+  int rows;
+  std::vector<unsigned char> bytes;
+  int absolutes;
+  double error;   //-- Largest error of the positions (degrees)
+  int A[4], O[4], T;
+  unsigned int ph[4];
+};
+
+static Baked bake(const std::string &spec) {
+  //-- name:T[:h[:dir]]
+  std::vector<std::string> f;
+  size_t start = 0;
+  for (;;) {
+    size_t end = spec.find(':', start);
+    f.push_back(spec.substr(start, end - start));
+    if (end == std::string::npos) break;
+    start = end + 1;
+  }
+
+  const Gait *g = 0;
+  for (size_t i = 0; i < sizeof(gaits) / sizeof(gaits[0]); i++)
+    if (f[0] == gaits[i].name) g = &gaits[i];
+  if (!g) fail("unknown gait " + f[0]);
+
+  int T = f.size() > 1 && !f[1].empty() ? atoi(f[1].c_str()) : g->T;
+  int h = f.size() > 2 && !f[2].empty() ? atoi(f[2].c_str()) : g->h;
+  int dir = f.size() > 3 && !f[3].empty() ? atoi(f[3].c_str()) : g->dir;
+  if (g->fwd && dir != 1 && dir != -1) fail(spec + ": dir must be 1 or -1");
+
+  Baked b;
+  b.spec = spec;
+  b.rows = (T + OSCILLATOR_FRAME / 2) / OSCILLATOR_FRAME;
+  if (b.rows < 2 || b.rows > 255) fail(spec + ": T must be 40 to 5100 ms");
+
+  b.name = std::string("gait_") + g->name + "_" + std::to_string(T);
+  if (g->h) b.name += "_" + std::to_string(h);
+  if (g->fwd) b.name += std::string("_") + (dir == 1 ? g->fwd : g->back);
+
+  //-- One cycle, phase 2 pi k / rows at row k
+  const ZowiGait &z = g->gait[g->fwd && dir == -1];
+  if (z.hmax) h = std::min(h, (int)z.hmax);
+  b.bytes.push_back(b.rows);
+  b.bytes.push_back(4);
+  b.absolutes = 0;
+  b.error = 0;
+  int last[4];
+  b.T = b.rows * OSCILLATOR_FRAME;
+  for (int i = 0; i < 4; i++) {
+    b.A[i] = z.A[i] + z.Ah[i] * h / 2;
+    b.O[i] = z.O[i] + z.Oh[i] * h / 2;
+    b.ph[i] = z.ph[i];
+  }
+  for (int k = 0; k < b.rows; k++) {
+    for (int i = 0; i < 4; i++) {
+      int A = b.A[i];
+      int O = b.O[i];
+      double deg = O + A * sin(2 * M_PI * ((double)k / b.rows + z.ph[i] / 65536.0));
+      int pos = (int)lround(deg * OSCILLATOR_FINE);
+      b.error = std::max(b.error, fabs(pos / (double)OSCILLATOR_FINE - deg));
+
+      int delta = pos - last[i];
+      if (k == 0 || delta < -127 || delta > 127) {
+        b.bytes.push_back(GAIT_ABSOLUTE);
+        b.bytes.push_back(pos & 0xFF);
+        b.bytes.push_back((pos >> 8) & 0xFF);
+        if (k) b.absolutes++;
+      }
+      else {
+        b.bytes.push_back(delta & 0xFF);
+      }
+      last[i] = pos;
+    }
+  }
+  return b;
+}
+
+//-- Host time per servo frame (ns) of OscillatorBank<4>, with a sample
+//-- every frame: the table played by GaitLayer, or the oscillators
+static double frameTime(const Baked &b, bool baked) {
+  static int pins = 0;
+  OscillatorBank<4> bank;
+  GaitLayer layer;
+  for (uint8_t i = 0; i < 4; i++) {
+    bank.attach(i, pins++ % SERVOPULSE_CHANNELS);
+    bank.SetT(i, b.T);
+    bank.SetA(i, baked ? 0 : b.A[i]);
+    bank.SetO(i, baked ? 0 : b.O[i]);
+    bank.SetPhase(i, b.ph[i]);
+  }
+  bank.SetTS(OSCILLATOR_FRAME);
+  if (baked) {
+    layer.start(&b.bytes[0]);
+    bank.addLayer(&layer);
+  }
+
+  //-- The best of a few runs: the others had the host busy
+  double best = 1e9;
+  for (int run = 0; run < 5; run++) {
+    auto start = std::chrono::steady_clock::now();
+    for (long k = 0; k < TIMED_FRAMES; k++) {
+      simMicros += OSCILLATOR_FRAME * 1000;
+      ServoPulse::frame = simMicros;
+      bank.refresh();
+    }
+    auto end = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count() / TIMED_FRAMES);
+  }
+  return best;
+}
+
+static void readSpecs(const char *path, std::vector<std::string> &specs) {
+  FILE *f = fopen(path, "r");
+  if (!f) fail(std::string("cannot open ") + path);
+  char line[256];
+  while (fgets(line, sizeof(line), f)) {
+    char *hash = strchr(line, '#');
+    if (hash) *hash = 0;
+    char *word = strtok(line, " \t\r\n");
+    if (word) specs.push_back(word);
+  }
+  fclose(f);
+}
+
+int main(int argc, char *argv[]) {
+  bool report = false;
+  std::vector<std::string> specs;
+
+  for (int i = 1; i < argc; i++) {
+    std::string a(argv[i]);
+    if (a == "-w") report = true;
+    else if (a[0] == '-') fail("usage: gaitbake [-w] gait...");
+    else if (a.size() > 6 && a.compare(a.size() - 6, 6, ".gaits") == 0) readSpecs(argv[i], specs);
+    else specs.push_back(a);
+  }
+  if (specs.empty()) fail("usage: gaitbake [-w] gait...");
+
+  if (report)
+    fprintf(stderr, "%-32s %4s %6s %8s %6s %9s %9s %6s\n", "table", "rows", "bytes", "absolute", "error",
+            "baked ns", "osc ns", "ratio");
+  unsigned int total = 0;
+  for (size_t s = 0; s < specs.size(); s++) {
+    Baked b = bake(specs[s]);
+    if (s) printf("\n");
+    printf("// Generated by gaitbake from %s\n", b.spec.c_str());
+    printf("// %d rows of %d ms, period %d ms, %u bytes\n", b.rows, OSCILLATOR_FRAME, b.rows * OSCILLATOR_FRAME,
+           (unsigned int)b.bytes.size());
+    printf("const unsigned char %s[] PROGMEM = {\n  %d, %d,", b.name.c_str(), b.bytes[0], b.bytes[1]);
+    for (size_t i = 2; i < b.bytes.size(); i++) {
+      if ((i - 2) % 16 == 0) printf("\n ");
+      printf(" %d%s", b.bytes[i], i + 1 < b.bytes.size() ? "," : "");
+    }
+    printf("\n};\n");
+
+    total += b.bytes.size();
+    if (report) {
+      double oscillators = frameTime(b, false), baked = frameTime(b, true);
+      fprintf(stderr, "%-32s %4d %6u %8d %6.3f %9.1f %9.1f %5.2fx\n", b.name.c_str(), b.rows,
+              (unsigned int)b.bytes.size(), b.absolutes, b.error, baked, oscillators, oscillators / baked);
+    }
+  }
+  if (report) fprintf(stderr, "%-32s %4s %6u\n", "all", "", total);
+  return 0;
+}
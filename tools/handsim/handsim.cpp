@@ -0,0 +1,185 @@
+//--------------------------------------------------------------
+//-- handsim
+//-- Runs the HandGesture library on a simulated hand in front of
+//-- the ultrasonic sensor, as Zowi at rest pings it, and reports
+//-- the gestures recognised against the ones made and the host
+//-- time per update
+//--------------------------------------------------------------
+//-- Build (host):  g++ -O2 -I../host -o handsim handsim.cpp
+//-- Usage:        handsim [-r runs] [-p ms:ms] [-n cm] [-d %] [-x %] [-v]
+//--    -r : runs of each gesture (default 200)
+//--    -p : time between two readings and its random error, up to
+//--         +- ms (default 60:10, SENSE_PING_PERIOD)
+//--    -n : noise of the readings, up to +- cm (default 1)
+//--    -d : readings with no echo, % (default 5)
+//--    -x : stray echoes, at 5 - 200 cm, % (default 2)
+//--    -v : print the gestures of every run
+//--
+//-- Each run is 1 s with nothing in range, the gesture, and 1.5 s
+//-- with nothing in range. The gestures, with random distances
+//-- and speeds:
+//--    approach : in at 35 - 45 cm, 300 ms still, to 10 - 20 cm at
+//--               30 - 60 cm/s, 400 ms still, out
+//--    retreat  : the same, the other way
+//--    hold     : in at 10 - 40 cm, 1500 ms still, out
+//--    swipe    : in at 15 - 40 cm for 150 - 300 ms, out
+//--    empty    : nothing in range for 4 s
+//--    wall     : a wall at 40 cm from the start, for 4 s
+//-- A run is right with the gesture made and no other one (none
+//-- for empty and wall).
+//--------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#define ARDUINO 100
+#include "../../arduino libraries/HandGesture/HandGesture.cpp"
+#undef min
+#undef max
+
+//-- Must match US.h
+#define US_NO_ECHO 999
+
+enum { APPROACH, RETREAT, HOLD, SWIPE, EMPTY, WALL, SCENES };
+static const char *sceneNames[] = {"approach", "retreat", "hold", "swipe", "empty", "wall"};
+static const unsigned char expected[] = {HAND_APPROACH, HAND_RETREAT, HAND_HOLD, HAND_SWIPE, HAND_NONE, HAND_NONE};
+static const char *gestureNames[] = {"none", "approach", "retreat", "hold", "swipe"};
+
+static void fail(const char *msg, const char *arg = "") {
+  fprintf(stderr, "handsim: %s%s\n", msg, arg);
+  exit(1);
+}
+
+static double uniform() { return 2.0 * rand() / RAND_MAX - 1; }
+static double between(double a, double b) { return a + (b - a) * rand() / RAND_MAX; }
+
+//-- A path of the hand: distances (cm, 0 = nothing in range) from
+//-- a time (ms), on a line to the next point
+struct Path {
+  std::vector<double> t, cm;
+
+  void add(double at, double d) {
+    t.push_back(at);
+    cm.push_back(d);
+  }
+  double at(double now) const {
+    for (size_t i = 0; i + 1 < t.size(); i++)
+      if (now < t[i + 1]) {
+        if (!cm[i] || !cm[i + 1]) return cm[i];
+        return cm[i] + (cm[i + 1] - cm[i]) * (now - t[i]) / (t[i + 1] - t[i]);
+      }
+    return cm.back();
+  }
+  double end() const { return t.back(); }
+};
+
+static Path scene(int s) {
+  Path p;
+  double in, to, speed;
+  switch (s) {
+    case APPROACH:
+    case RETREAT:
+      in = between(35, 45);
+      to = between(10, 20);
+      if (s == RETREAT) std::swap(in, to);
+      speed = between(30, 60);
+      p.add(0, 0);
+      p.add(1000, in);
+      p.add(1300, in);
+      p.add(1300 + std::abs(in - to) / speed * 1000, to);
+      p.add(p.end() + 400, 0);
+      break;
+    case HOLD:
+      p.add(0, 0);
+      p.add(1000, between(10, 40));
+      p.add(2500, 0);
+      break;
+    case SWIPE:
+      p.add(0, 0);
+      p.add(1000, between(15, 40));
+      p.add(1000 + between(150, 300), 0);
+      break;
+    case EMPTY:
+      p.add(0, 0);
+      p.add(2500, 0);
+      break;
+    case WALL:
+      p.add(0, 40);
+      p.add(2500, 40);
+      p.add(4000, 40);
+      break;
+  }
+  p.add(p.end() + 1500, p.cm.back());
+  return p;
+}
+
+int main(int argc, char *argv[]) {
+  int runs = 200;
+  double period = 60, jitter = 10, noise = 1, dropouts = 5, strays = 2;
+  bool verbose = false;
+  const char *usage = "usage: handsim [-r runs] [-p ms:ms] [-n cm] [-d %] [-x %] [-v]";
+
+  for (int i = 1; i < argc; i++) {
+    std::string a(argv[i]);
+    if (a == "-v") verbose = true;
+    else if (a == "-r" && i + 1 < argc) runs = atoi(argv[++i]);
+    else if (a == "-p" && i + 1 < argc) {
+      if (sscanf(argv[++i], "%lf:%lf", &period, &jitter) != 2) fail(usage);
+    }
+    else if (a == "-n" && i + 1 < argc) noise = atof(argv[++i]);
+    else if (a == "-d" && i + 1 < argc) dropouts = atof(argv[++i]);
+    else if (a == "-x" && i + 1 < argc) strays = atof(argv[++i]);
+    else fail(usage);
+  }
+  if (runs <= 0 || period <= 0 || jitter < 0 || jitter >= period || noise < 0 ||
+      dropouts < 0 || strays < 0 || dropouts + strays > 100) fail(usage);
+
+  HandGesture hand;
+  double busy = 0, worst = 0;
+  long updates = 0;
+  unsigned long clock = 0;
+  srand(1);
+
+  printf("%-9s %6s %6s %6s\n", "gesture", "right", "wrong", "missed");
+  for (int s = 0; s < SCENES; s++) {
+    int right = 0, wrong = 0, missed = 0;
+    for (int r = 0; r < runs; r++) {
+      Path p = scene(s);
+      hand.begin();
+      std::vector<unsigned char> heard;
+      for (double t = 0; t < p.end(); t += period + jitter * uniform()) {
+        double d = p.at(t), x = between(0, 100);
+        unsigned int reading = d ? (unsigned int)std::max(1L, lround(d + noise * uniform())) : US_NO_ECHO;
+        if (x < dropouts) reading = US_NO_ECHO;
+        else if (x < dropouts + strays) reading = (unsigned int)between(5, 200);
+
+        auto a = std::chrono::steady_clock::now();
+        unsigned char gesture = hand.update(clock + (unsigned long)t, reading);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - a).count();
+        busy += ns;
+        worst = std::max(worst, ns);
+        updates++;
+        if (gesture) heard.push_back(gesture);
+      }
+      clock += (unsigned long)p.end();
+
+      bool ok = expected[s] ? heard.size() == 1 && heard[0] == expected[s] : heard.empty();
+      if (ok) right++;
+      else if (expected[s] && std::find(heard.begin(), heard.end(), expected[s]) == heard.end()) missed++;
+      else wrong++;
+      if (verbose) {
+        printf("%s %d ->", sceneNames[s], r + 1);
+        if (heard.empty()) printf(" none");
+        for (size_t i = 0; i < heard.size(); i++) printf(" %s", gestureNames[heard[i]]);
+        printf("%s\n", ok ? "" : "  (wrong)");
+      }
+    }
+    printf("%-9s %6d %6d %6d\n", sceneNames[s], right, wrong, missed);
+  }
+  printf("host time per update: mean %.0f ns, worst %.0f ns (%ld updates)\n", busy / updates, worst, updates);
+  return 0;
+}
@@ -0,0 +1,26 @@
+//--------------------------------------------------------------
+//-- The part of Arduino.h used by the libraries that the host
+//-- tools build (g++ -I../host). micros() and millis() are the
+//-- clock of the simulations: the tool that calls them defines
+//-- simMicros
+//--------------------------------------------------------------
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#define constrain(x, a, b) ((x) < (a) ? (a) : (x) > (b) ? (b) : (x))
+#ifndef _BV
+  #define _BV(bit) (1 << (bit))
+#endif
+
+extern unsigned long simMicros;
+inline unsigned long micros() { return simMicros; }
+inline unsigned long millis() { return simMicros / 1000; }
+
+#endif
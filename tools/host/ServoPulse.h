@@ -0,0 +1,32 @@
+//--------------------------------------------------------------
+//-- The ServoPulse engine for the host tools: the positions
+//-- written are kept in position[], and the tool moves the frames
+//--------------------------------------------------------------
+#ifndef __SERVOPULSE_H__
+#define __SERVOPULSE_H__
+
+#define SERVOPULSE_CHANNELS 8
+#define SERVOPULSE_FRAME 20000		// us between frame starts
+#define SERVOPULSE_FINE 16			// writeFine() steps per degree
+
+class ServoPulse
+{
+public:
+	ServoPulse() : pin(-1) {}
+	unsigned char attach(int p) { pin = p; return p; }
+	void detach(void) { pin = -1; }
+	bool attached(void) { return pin >= 0; }
+	void write(int value) { writeFine(value * SERVOPULSE_FINE); }
+	void writeFine(int fine) { position[pin] = fine; }
+	static void hold(void) {}
+	static void release(void) {}
+	static unsigned long nextFrame(void) { return frame + SERVOPULSE_FRAME; }
+
+	static unsigned long frame;						// us, start of the last frame
+	static int position[SERVOPULSE_CHANNELS];		// Last written, by pin
+
+private:
+	int pin;
+};
+
+#endif
@@ -0,0 +1,15 @@
+//--------------------------------------------------------------
+//-- avr/pgmspace.h for the host tools: the tables are in RAM on the host
+//--------------------------------------------------------------
+#ifndef PGMSPACE_H
+#define PGMSPACE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define memcpy_P memcpy
+
+#endif
@@ -0,0 +1,354 @@
+//--------------------------------------------------------------
+//-- navsim
+//-- Runs the obstacle avoidance of ZOWI_BASE (MODE 2) in virtual
+//-- rooms: the fixed script of the old firmware, and the polar
+//-- histogram (PolarHistogram library) with the dead reckoning of
+//-- Zowi. Reports the motions per obstacle, the bumps and how far
+//-- Zowi walked, for each room and for both
+//--------------------------------------------------------------
+//-- Build (host):  g++ -O2 -I../host -o navsim navsim.cpp
+//-- Usage:        navsim [-m motions] [-r runs] [-e error] [-v]
+//--                      file.rooms
+//--    -m : motions per run (default 300)
+//--    -r : runs per room, from random places (default 20)
+//--    -e : error of the turns, up to +- this part of a turn
+//--         (default 0.2); the walks have half of it
+//--    -v : print the motions of the first run of each room
+//--
+//-- Input: rooms, boxes and walls in cm (see zowi.rooms).
+//-- Zowi is a circle of ROBOT_RADIUS cm with the ultrasonic
+//-- sensor at its front. A cycle of walk moves it NAV_WALK_STEP
+//-- cm, one of turn NAV_TURN_STEP degrees and NAV_TURN_WALK cm,
+//-- all with random errors; the dead reckoning only knows the
+//-- cycles. A motion into a wall slides along it, unless it is
+//-- nearly straight into it: then Zowi stops there, a bump. The
+//-- sensor hears the nearest echo within a cone of
+//-- US_CONE degrees, from surfaces seen within US_SPECULAR
+//-- degrees of square (a wall seen at a sharper angle sends the
+//-- sound away), with 1 cm noise and 5% missing echoes. It is
+//-- pinged every SENSE_PING_PERIOD ms while the feet are flat,
+//-- as Zowi::senseDistanceAt(PHASE_FEET_FLAT).
+//-- An obstacle is met when Zowi stops walking ahead because of
+//-- it; the motions per obstacle are the motions until it walks
+//-- ahead again.
+//--------------------------------------------------------------
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#define ARDUINO 100
+#include "../../arduino libraries/PolarHistogram/PolarHistogram.cpp"
+#undef min
+#undef max
+
+//-- Must match Zowi.h
+#define NAV_WALK_STEP 4
+#define NAV_TURN_STEP 20
+#define NAV_TURN_WALK 2
+#define SENSE_PING_PERIOD 60
+
+//-- Must match ZOWI_BASE_v2
+#define OBSTACLE_OLD 15     //-- cm, obstacleDetector() of the old script
+#define OBSTACLE_CM 20      //-- cm of clearance ahead, MODE 2
+#define OPEN_AHEAD 23       //-- degrees, the open way is ahead
+
+#define ROBOT_RADIUS 6
+#define US_CONE 15          //-- degrees each side
+#define US_SPECULAR 50
+#define US_RANGE 300
+#define CYCLE 1000          //-- ms of a motion
+#define FEET_FLAT 0.04      //-- part of the cycle around each flat point
+
+struct Wall {
+  double x1, y1, x2, y2;
+};
+
+struct Room {
+  std::string name;
+  double w, h;
+  std::vector<Wall> walls;
+  std::vector<Wall> boxes;  //-- x, y, width, depth: for the start places
+};
+
+struct Pose {
+  double x, y, a;           //-- cm, radians (counterclockwise, LEFT)
+};
+
+static double U() { return rand() / (double)RAND_MAX; }
+static double error = 0.2;
+
+static void fail(const char *msg, const char *arg = "") {
+  fprintf(stderr, "navsim: %s%s\n", msg, arg);
+  exit(1);
+}
+
+static std::vector<Room> readRooms(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (!f) fail("cannot open ", path);
+  std::vector<Room> rooms;
+  char line[256];
+  while (fgets(line, sizeof(line), f)) {
+    char *hash = strchr(line, '#');
+    if (hash) *hash = 0;
+    char word[32], name[64];
+    double a, b, c, d;
+    if (sscanf(line, "%31s", word) != 1) continue;
+    if (!strcmp(word, "room") && sscanf(line, "%*s %63s %lf %lf", name, &a, &b) == 3) {
+      Room r = {name, a, b, {{0, 0, a, 0}, {a, 0, a, b}, {a, b, 0, b}, {0, b, 0, 0}}, {}};
+      rooms.push_back(r);
+    }
+    else if (rooms.empty()) fail("no room before ", line);
+    else if (!strcmp(word, "box") && sscanf(line, "%*s %lf %lf %lf %lf", &a, &b, &c, &d) == 4) {
+      std::vector<Wall> &w = rooms.back().walls;
+      w.push_back({a, b, a + c, b});
+      w.push_back({a + c, b, a + c, b + d});
+      w.push_back({a + c, b + d, a, b + d});
+      w.push_back({a, b + d, a, b});
+      rooms.back().boxes.push_back({a, b, c, d});
+    }
+    else if (!strcmp(word, "wall") && sscanf(line, "%*s %lf %lf %lf %lf", &a, &b, &c, &d) == 4)
+      rooms.back().walls.push_back({a, b, c, d});
+    else fail("bad line: ", line);
+  }
+  fclose(f);
+  return rooms;
+}
+
+//-- Distance from a point to a wall
+static double toWall(double x, double y, const Wall &w) {
+  double dx = w.x2 - w.x1, dy = w.y2 - w.y1;
+  double l = dx * dx + dy * dy;
+  double t = l ? std::max(0.0, std::min(1.0, ((x - w.x1) * dx + (y - w.y1) * dy) / l)) : 0;
+  return hypot(x - w.x1 - t * dx, y - w.y1 - t * dy);
+}
+
+static bool fits(const Room &r, double x, double y) {
+  for (size_t i = 0; i < r.walls.size(); i++)
+    if (toWall(x, y, r.walls[i]) < ROBOT_RADIUS) return false;
+  for (size_t i = 0; i < r.boxes.size(); i++) {
+    const Wall &b = r.boxes[i];
+    if (x > b.x1 && x < b.x1 + b.x2 && y > b.y1 && y < b.y1 + b.y2) return false;
+  }
+  return x > 0 && y > 0 && x < r.w && y < r.h;
+}
+
+//-- The ultrasonic sensor: cm, 0 for no echo
+static int sonar(const Room &r, const Pose &p) {
+  double sx = p.x + ROBOT_RADIUS * cos(p.a), sy = p.y + ROBOT_RADIUS * sin(p.a);
+  double nearest = 1e9;
+  for (int k = -US_CONE; k <= US_CONE; k += 3) {
+    double a = p.a + k * M_PI / 180, dx = cos(a), dy = sin(a);
+    for (size_t i = 0; i < r.walls.size(); i++) {
+      const Wall &w = r.walls[i];
+      double ex = w.x2 - w.x1, ey = w.y2 - w.y1;
+      double den = dx * ey - dy * ex;
+      if (fabs(den) < 1e-9) continue;
+      double t = ((w.x1 - sx) * ey - (w.y1 - sy) * ex) / den;
+      double u = ((w.x1 - sx) * dy - (w.y1 - sy) * dx) / den;
+      if (t <= 0 || u < 0 || u > 1) continue;
+      double square = fabs(dx * ex + dy * ey) / hypot(ex, ey);   //-- sin of the angle from square
+      if (square > sin(US_SPECULAR * M_PI / 180)) continue;
+      nearest = std::min(nearest, t);
+    }
+  }
+  if (nearest > US_RANGE || U() < 0.05) return 0;
+  return std::max(2, (int)lround(nearest + 2 * U() - 1));
+}
+
+//-- Zowi, as the sketch sees it
+struct Zowi {
+  const Room *room;
+  Pose pose;
+  PolarHistogram map;
+  bool useMap;
+  double heading;           //-- Dead reckoning, radians
+  double walkedRest;        //-- cm not given to the map yet
+  int last;                 //-- Last reading, cm
+  double lastTime, now;     //-- ms
+  int motions, bumps;
+  double walked;            //-- cm ahead, really
+  bool verbose;
+
+  uint16_t heading16() { return (uint16_t)(long)lround(heading * 32768 / M_PI); }
+
+  void sense(const Pose &p) {
+    if (now - lastTime < SENSE_PING_PERIOD) return;
+    lastTime = now;
+    last = sonar(*room, p);
+    if (useMap) map.reading(heading16(), last);
+  }
+
+  //-- One cycle: cm ahead, degrees to the left; readings while the feet are flat
+  void motion(const char *name, double cm, double deg) {
+    double realCm = cm * (1 + (2 * U() - 1) * error / 2);
+    double realDeg = deg * (1 + (2 * U() - 1) * error) + (2 * U() - 1) * 2;
+    Pose from = pose;
+    double h0 = heading;
+    bool bump = false;
+    for (int ms = 0; ms <= CYCLE; ms += 20) {
+      double f = (double)ms / CYCLE;
+      Pose p = from;
+      p.a = from.a + realDeg * M_PI / 180 * f;
+      p.x = from.x + realCm * f * cos(p.a);
+      p.y = from.y + realCm * f * sin(p.a);
+      if (!fits(*room, p.x, p.y)) {
+        //-- Along the wall, if the motion is not straight into it
+        Pose sx = p, sy = p;
+        sx.y = pose.y;
+        sy.x = pose.x;
+        if (fits(*room, sx.x, sx.y) && fabs(sx.x - pose.x) > 0.3 * fabs(p.x - pose.x)) p = sx;
+        else if (fits(*room, sy.x, sy.y) && fabs(sy.y - pose.y) > 0.3 * fabs(p.y - pose.y)) p = sy;
+        else {
+          bump = true;
+          break;
+        }
+      }
+      pose = p;
+
+      //-- The dead reckoning of Zowi: by time, the cycles of walk and turn
+      double step = cm / (CYCLE / 20);
+      if (ms) {
+        heading = h0 + deg * M_PI / 180 * f;
+        walkedRest += step;
+        if (useMap && fabs(walkedRest) >= 1) {
+          map.moved(heading16(), (int)walkedRest);
+          walkedRest -= (int)walkedRest;
+        }
+      }
+      double phase = fmod(f, 0.5);
+      if (phase < FEET_FLAT || phase > 0.5 - FEET_FLAT) sense(p);
+      now += 20;
+    }
+    heading = h0 + deg * M_PI / 180;
+    motions++;
+    if (bump) bumps++;
+    if (deg == 0 && cm > 0) walked += hypot(pose.x - from.x, pose.y - from.y);
+    if (verbose)
+      printf("  %-8s at %5.1f %5.1f %4.0f deg, sensor %3d cm%s\n", name, pose.x, pose.y,
+             fmod(pose.a * 180 / M_PI + 720, 360), last, bump ? ", bump" : "");
+  }
+
+  void walk(int dir) { motion(dir > 0 ? "walk" : "back", dir * NAV_WALK_STEP, 0); }
+  void turn(int dir) { motion(dir > 0 ? "left" : "right", NAV_TURN_WALK, dir * NAV_TURN_STEP); }
+  void jump() { motion("jump", 0, 0); }
+
+  //-- obstacleDetector(): the last reading, or one now
+  bool obstacle() {
+    if (now - lastTime > CYCLE) {
+      last = sonar(*room, pose);
+      lastTime = now;
+    }
+    return last && last < OBSTACLE_OLD;
+  }
+};
+
+struct Result {
+  int motions, bumps, obstacles, avoiding;
+  double walked;
+};
+
+//-- The old MODE 2: a fixed script after each obstacle
+static void runScript(Zowi &z, int motions, Result &res) {
+  bool detected = false, avoiding = false;
+  while (z.motions < motions) {
+    if (detected) {
+      if (!avoiding) res.obstacles++;
+      avoiding = true;
+      int start = z.motions;
+      z.jump();
+      for (int i = 0; i < 3; i++) z.walk(-1);
+      detected = z.obstacle();
+      if (!detected) {
+        detected = z.obstacle();
+        for (int i = 0; i < 3 && !detected; i++) {
+          z.turn(1);
+          detected = z.obstacle();
+        }
+      }
+      res.avoiding += z.motions - start;
+    }
+    else {
+      z.walk(1);
+      avoiding = false;
+      detected = z.obstacle();
+    }
+  }
+}
+
+//-- The new MODE 2: walk while the way ahead is open, else turn
+//-- towards the most open way, a cycle at a time
+static void runMap(Zowi &z, int motions, Result &res) {
+  bool avoiding = false;
+  while (z.motions < motions) {
+    uint16_t h = z.heading16();
+    unsigned int ahead = z.map.distance(h);
+    if (!ahead || ahead >= OBSTACLE_CM) {
+      z.walk(1);
+      avoiding = false;
+      continue;
+    }
+    if (!avoiding) res.obstacles++;
+    avoiding = true;
+    int direction = (int16_t)(z.map.best(h) - h) * 180L / 32768;
+    if (abs(direction) < OPEN_AHEAD) z.walk(-1);
+    else z.turn(direction > 0 ? 1 : -1);
+    res.avoiding++;
+  }
+}
+
+int main(int argc, char *argv[]) {
+  int motions = 300, runs = 20;
+  bool verbose = false;
+  const char *path = 0;
+  for (int i = 1; i < argc; i++) {
+    std::string a(argv[i]);
+    if (a == "-v") verbose = true;
+    else if (a == "-m" && i + 1 < argc) motions = atoi(argv[++i]);
+    else if (a == "-r" && i + 1 < argc) runs = atoi(argv[++i]);
+    else if (a == "-e" && i + 1 < argc) error = atof(argv[++i]);
+    else if (a[0] == '-') fail("usage: navsim [-m motions] [-r runs] [-e error] [-v] file.rooms");
+    else path = argv[i];
+  }
+  if (!path) fail("usage: navsim [-m motions] [-r runs] [-e error] [-v] file.rooms");
+  std::vector<Room> rooms = readRooms(path);
+
+  printf("%-10s %-7s %9s %10s %8s %8s\n", "room", "mode", "obstacles", "motions/ob", "bumps", "walked");
+  Result all[2] = {};
+  for (size_t r = 0; r < rooms.size(); r++) {
+    for (int useMap = 0; useMap < 2; useMap++) {
+      Result res = {};
+      srand(1 + r);   //-- The same places for both
+      for (int run = 0; run < runs; run++) {
+        Zowi z = {};
+        z.room = &rooms[r];
+        do {
+          z.pose = {U() * rooms[r].w, U() * rooms[r].h, U() * 2 * M_PI};
+        } while (!fits(rooms[r], z.pose.x, z.pose.y));
+        z.useMap = useMap;
+        z.map.begin();
+        z.lastTime = -1e9;
+        z.verbose = verbose && run == 0;
+        if (z.verbose) printf("%s, %s:\n", rooms[r].name.c_str(), useMap ? "map" : "script");
+        if (useMap) runMap(z, motions, res);
+        else runScript(z, motions, res);
+        res.motions += z.motions;
+        res.bumps += z.bumps;
+        res.walked += z.walked;
+      }
+      printf("%-10s %-7s %9d %10.1f %8d %6.0f cm\n", rooms[r].name.c_str(), useMap ? "map" : "script",
+             res.obstacles, res.obstacles ? (double)res.avoiding / res.obstacles : 0, res.bumps, res.walked / runs);
+      all[useMap].obstacles += res.obstacles;
+      all[useMap].avoiding += res.avoiding;
+      all[useMap].bumps += res.bumps;
+      all[useMap].walked += res.walked / runs / rooms.size();
+    }
+  }
+  for (int m = 0; m < 2; m++)
+    printf("%-10s %-7s %9d %10.1f %8d %6.0f cm\n", "all", m ? "map" : "script", all[m].obstacles,
+           all[m].obstacles ? (double)all[m].avoiding / all[m].obstacles : 0, all[m].bumps, all[m].walked);
+  return 0;
+}
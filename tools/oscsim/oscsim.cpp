@@ -0,0 +1,210 @@
+//--------------------------------------------------------------
+//-- oscsim
+//-- Runs the Oscillator library (or OscillatorBank, as Zowi
+//-- drives its joints) on the host, with a simulated micros() and
+//-- servo frames, and measures the period of the oscillation the
+//-- servo gets over thousands of cycles
+//--------------------------------------------------------------
+//-- Build (host):  g++ -O2 -I../host -o oscsim oscsim.cpp
+//-- Usage:        oscsim [-T ms] [-s ms] [-c cycles] [-l min:max]
+//--                      [-p loops:ms] [-i minutes] [-n] [-b]
+//--    -T : period of the oscillation (default 1000)
+//--    -s : sampling period (default OSCILLATOR_TS)
+//--    -c : cycles (default 3000)
+//--    -l : time of one loop, random between min and max ms
+//--         (default 0.2:3.2), between two calls to refresh()
+//--    -p : a stall of ms every so many loops (default 500:60)
+//--    -i : minutes with no refresh() halfway through, as Zowi
+//--         idle between two motions; reports how long the
+//--         first sample takes after it
+//--    -n : interpolation between the samples
+//--    -b : OscillatorBank<4>, four joints a quarter of a turn
+//--         apart; the first one is measured
+//--
+//-- The clock starts 10 s before micros() wraps around. The
+//-- servo gets the positions at the frame starts; the period is
+//-- the time between the rising crossings of the offset, found
+//-- on the line between two frames. The error over all the
+//-- cycles is how far the last crossing is from where it should
+//-- be, from the first one (with -i, the cycle of the idle time
+//-- is left out).
+//--------------------------------------------------------------
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+//-- long is 32 bits, as on the AVR, so that micros() wraps around
+//-- as it does there
+#define long int
+#define ARDUINO 100
+#include "../../arduino libraries/Oscillator/OscillatorWaves.cpp"
+#include "../../arduino libraries/Oscillator/Oscillator.cpp"
+#include "../../arduino libraries/Oscillator/OscillatorBank.h"
+unsigned long simMicros;
+unsigned long ServoPulse::frame;
+int ServoPulse::position[SERVOPULSE_CHANNELS];
+#undef long
+#undef min
+#undef max
+
+#define PIN 2
+
+static void fail(const char *msg, const char *arg = "") {
+  fprintf(stderr, "oscsim: %s%s\n", msg, arg);
+  exit(1);
+}
+
+static double U() { return rand() / (double)RAND_MAX; }
+
+static uint64_t clock64;    //-- us since the start, with no wrap around
+
+//-- The rising crossings of the offset, in the positions the servo gets
+struct Meter {
+  bool have;
+  int last;
+  std::vector<double> crossings;    //-- us
+
+  void frame(int pos) {
+    if (have && last < 0 && pos >= 0)
+      crossings.push_back(clock64 - SERVOPULSE_FRAME + (double)-last / (pos - last) * SERVOPULSE_FRAME);
+    last = pos;
+    have = true;
+  }
+};
+
+static Meter meter;
+
+//-- The oscillators
+static Oscillator osc;
+static OscillatorBank<4> bank;
+static bool useBank;
+
+static void refresh() {
+  if (useBank) bank.refresh();
+  else osc.refresh();
+}
+
+//-- Time goes by; the frames send the positions written before them
+static void advance(uint32_t us) {
+  while (us) {
+    uint32_t toFrame = ServoPulse::frame + SERVOPULSE_FRAME - simMicros;
+    if (toFrame > us) {
+      simMicros += us;
+      clock64 += us;
+      return;
+    }
+    simMicros += toFrame;
+    clock64 += toFrame;
+    us -= toFrame;
+    ServoPulse::frame = simMicros;
+    meter.frame(ServoPulse::position[PIN] - 90 * SERVOPULSE_FINE);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  int T = 1000, TS = OSCILLATOR_TS, cycles = 3000, every = 500, stall = 60;
+  double lmin = 0.2, lmax = 3.2, idle = 0;
+  bool interpolate = false;
+  const char *usage = "usage: oscsim [-T ms] [-s ms] [-c cycles] [-l min:max] [-p loops:ms] [-i minutes] [-n] [-b]";
+  for (int i = 1; i < argc; i++) {
+    std::string a(argv[i]);
+    if (a == "-n") interpolate = true;
+    else if (a == "-b") useBank = true;
+    else if (a == "-T" && i + 1 < argc) T = atoi(argv[++i]);
+    else if (a == "-s" && i + 1 < argc) TS = atoi(argv[++i]);
+    else if (a == "-c" && i + 1 < argc) cycles = atoi(argv[++i]);
+    else if (a == "-l" && i + 1 < argc) {
+      if (sscanf(argv[++i], "%lf:%lf", &lmin, &lmax) != 2) fail(usage);
+    }
+    else if (a == "-p" && i + 1 < argc) {
+      if (sscanf(argv[++i], "%d:%d", &every, &stall) != 2) fail(usage);
+    }
+    else if (a == "-i" && i + 1 < argc) idle = atof(argv[++i]);
+    else fail(usage);
+  }
+  if (T <= 0 || TS <= 0 || cycles < 2 || every <= 0 || lmin < 0 || lmax < lmin) fail(usage);
+
+  srand(1);
+  simMicros = 0xFFFFFFFFU - 10000000;
+  ServoPulse::frame = simMicros - 5000;
+
+  if (useBank) {
+    for (uint8_t i = 0; i < 4; i++) {
+      bank.attach(i, PIN + i);
+      bank.SetT(i, T);
+      bank.SetA(i, 30);
+      bank.SetO(i, 0);
+      bank.SetPhase(i, i * 16384U);
+    }
+    bank.SetTS(TS);
+    bank.SetInterpolation(interpolate);
+    for (uint8_t i = 0; i < 4; i++) bank.Reset(i);
+  }
+  else {
+    osc.attach(PIN);
+    osc.SetT(T);
+    osc.SetTS(TS);
+    osc.SetInterpolation(interpolate);
+    osc.SetA(30);
+    osc.SetO(0);
+    osc.Reset();
+  }
+
+  unsigned long loops = 0;
+  uint64_t half = clock64 + (uint64_t)cycles / 2 * T * 1000;
+  uint64_t end = clock64 + (uint64_t)cycles * T * 1000;
+  double wait = -1;
+  size_t before = 0;
+  while (clock64 < end) {
+    uint32_t step = (lmin + U() * (lmax - lmin)) * 1000;
+    if (++loops % every == 0) step += stall * 1000;
+    advance(step);
+
+    //-- Idle halfway: no refresh(), then how long until a sample
+    if (idle && clock64 >= half && wait < 0) {
+      advance(idle * 60e6);
+      end += idle * 60e6;
+      before = meter.crossings.size();
+      int pos = ServoPulse::position[PIN];
+      uint64_t resumed = clock64;
+      ServoPulse::position[PIN] = 0x7FFF;
+      while (ServoPulse::position[PIN] == 0x7FFF) {
+        advance((lmin + U() * (lmax - lmin)) * 1000);
+        refresh();
+        if (clock64 - resumed > 3600e6) {
+          ServoPulse::position[PIN] = pos;
+          break;
+        }
+      }
+      wait = (clock64 - resumed) / 1000.0;
+      meter.have = false;
+    }
+    refresh();
+  }
+
+  //-- The periods, but the one with the idle time
+  std::vector<double> &c = meter.crossings;
+  std::vector<double> periods;
+  for (size_t i = 1; i < c.size(); i++)
+    if (i != before) periods.push_back(c[i] - c[i - 1]);
+  if (periods.empty()) fail("no cycles");
+  double sum = 0, worst = 0;
+  for (size_t i = 0; i < periods.size(); i++) {
+    sum += periods[i];
+    worst = std::max(worst, fabs(periods[i] - T * 1000.0));
+  }
+  double mean = sum / periods.size();
+  double drift = sum - periods.size() * T * 1000.0;
+
+  printf("%s, T = %d ms, TS = %d ms, %s, loops of %.1f - %.1f ms, %d ms stall every %d loops\n",
+         useBank ? "OscillatorBank<4>" : "Oscillator", T, TS, interpolate ? "interpolation" : "no interpolation", lmin, lmax, stall, every);
+  printf("%zu cycles: mean period %.3f ms (%+.0f ppm), worst cycle %+.3f ms, error over all %+.3f ms\n",
+         periods.size(), mean / 1000, (mean / (T * 1000.0) - 1) * 1e6, worst / 1000, drift / 1000);
+  if (idle) printf("idle %.1f min: first sample %.1f ms after it\n", idle, wait);
+  return 0;
+}
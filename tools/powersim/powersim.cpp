@@ -0,0 +1,296 @@
+//--------------------------------------------------------------
+//-- powersim
+//-- Simulates the battery sag of the built-in Zowi motions with
+//-- and without the battery governor (Zowi::setPowerPolicy)
+//--------------------------------------------------------------
+//-- Build (host):  g++ -O2 -o powersim powersim.cpp
+//-- Usage:        powersim [-v mV] [-r ohms] [-p policy] [-s]
+//--    -v : open circuit battery voltage (default 3350)
+//--    -r : battery + switch + wiring resistance (default 0.35)
+//--    -p : 1 = POWER_BALANCED (default), 2 = POWER_SAVE
+//--    -s : include the first 150 ms, when the servos jump from home
+//--         to the first position of the gait
+//--
+//-- The motions are generated as in Zowi.cpp: Oscillator samples
+//-- every 20 ms, 2 ms before each frame, _moveServos steps every
+//-- 10 ms, ServoPulse starts all the pulses together every 20 ms
+//-- (with the governor, the groups take turns, a frame each). Each servo is
+//-- a DC motor (SG90 class) behind a proportional controller, and
+//-- the battery is an ideal source behind a resistance.
+//-- The figures are a model: use them to compare, not as absolutes.
+//--------------------------------------------------------------
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+//-- Must match Zowi.h / Zowi.cpp
+#define POWER_STAGGER 30
+#define OSCILLATOR_TS 20
+#define OSCILLATOR_FRAME 20
+#define OSCILLATOR_LEAD 2
+
+struct Policy {
+  int full, low, minScale, maxMoving;
+};
+
+static const Policy policies[3] = {
+  {0, 0, 256, 4},
+  {3600, 3300, 160, 2},
+  {3800, 3400, 128, 1},
+};
+
+static int powerScale(const Policy &p, int mv) {
+  if (p.full <= p.low || mv >= p.full) return 256;
+  if (mv <= p.low) return p.minScale;
+  return p.minScale + (long)(256 - p.minScale) * (mv - p.low) / (p.full - p.low);
+}
+
+static int powerGroups(const Policy &p, int scale) {
+  if (scale >= 256) return 1;
+  int moving = p.maxMoving + (long)(4 - p.maxMoving) * (scale - p.minScale) / (256 - p.minScale);
+  return (4 + moving - 1) / moving;
+}
+
+
+//--------------------------------------------------------------
+//-- Servo and battery model
+//--------------------------------------------------------------
+struct Servo {
+  double angle;      //-- rad
+  double speed;      //-- rad/s
+  double command;    //-- rad, latched from the pulses
+};
+
+static const double Rm = 5.5;        //-- Winding resistance (ohm)
+static const double Ke = 0.457;      //-- V s/rad at the output shaft (600 deg/s at 4.8 V)
+static const double J = 7.6e-4;      //-- Inertia at the output shaft (20 ms mechanical constant)
+static const double B = 0.01;        //-- Friction
+static const double Kp = 1 / 0.09;   //-- Full drive from 5 degrees of error
+static const double Idle = 0.008;    //-- Electronics of each servo (A)
+
+struct Result {
+  double peak, minVolts, charge, seconds;
+};
+
+class Robot {
+  public:
+    Robot(double ocv, double r) : ocv(ocv), r(r), t(0), measureFrom(0), vbus(ocv) {
+      for (int i = 0; i < 4; i++) servo[i] = Servo{M_PI / 2, 0, M_PI / 2};
+      target[0] = target[1] = target[2] = target[3] = 90;
+      result = Result{0, ocv, 0, 0};
+    }
+
+    //-- 1 ms of simulation
+    void step() {
+      //-- ServoPulse: the pulses of all the servos at the frame start
+      if (t % OSCILLATOR_FRAME == 0) {
+        for (int i = 0; i < 4; i++) servo[i].command = target[i] * M_PI / 180;
+      }
+
+      double current = 0;
+      for (int i = 0; i < 4; i++) {
+        Servo &s = servo[i];
+        double duty = std::max(-1.0, std::min(1.0, Kp * (s.command - s.angle)));
+        double motor = (duty * vbus - Ke * s.speed) / Rm;
+        double torque = Ke * motor - B * s.speed;
+        s.speed += torque / J * 0.001;
+        s.angle += s.speed * 0.001;
+        current += Idle + std::max(0.0, duty * motor);
+      }
+      vbus = ocv - r * current;
+      if (t >= measureFrom) {
+        result.peak = std::max(result.peak, current);
+        result.minVolts = std::min(result.minVolts, vbus);
+      }
+      result.charge += current * 0.001;
+      result.seconds += 0.001;
+      t++;
+    }
+
+    void wait(long ms) { while (ms-- > 0) step(); }
+
+    double ocv, r;
+    long t, measureFrom;
+    double vbus;
+    Servo servo[4];
+    int target[4];
+    Result result;
+};
+
+
+//--------------------------------------------------------------
+//-- Zowi motions
+//--------------------------------------------------------------
+struct Oscillator {
+  int A, O, T;
+  double phase0;
+  long t0;
+  void set(int a, int o, int t, double ph) {
+    A = a; O = o; T = t; phase0 = ph;
+  }
+};
+
+struct Governor {
+  const Policy *policy;
+  int scale, groups;
+};
+
+static void oscillate(Robot &robot, Oscillator osc[4], int T, float cycle, int groups) {
+  long ref = robot.t;
+  while (robot.t <= T * cycle + ref) {
+    long sample = robot.t + OSCILLATOR_LEAD;
+    int slot = (sample / OSCILLATOR_FRAME) % groups;
+    if (sample % OSCILLATOR_TS == 0) {
+      for (int i = 0; i < 4; i++) {
+        if (i % groups != slot) continue;
+        double phase = 2 * M_PI * ((robot.t - osc[i].t0) % T) / T;
+        robot.target[i] = lround(osc[i].A * sin(phase + osc[i].phase0) + osc[i].O) + 90;
+      }
+    }
+    robot.step();
+  }
+}
+
+static void execute(Robot &robot, Oscillator osc[4], const int A[4], const int O[4], int T, const double ph[4],
+                    float steps, const Governor &g) {
+  T = (long)T * 256 / g.scale;
+  for (int i = 0; i < 4; i++) osc[i].set((long)A[i] * g.scale >> 8, (long)O[i] * g.scale >> 8, T, ph[i]);
+  int cycles = (int)steps;
+  for (int i = 0; i < cycles; i++) oscillate(robot, osc, T, 1, g.groups);
+  oscillate(robot, osc, T, steps - cycles, g.groups);
+}
+
+static void moveServos(Robot &robot, int position[4], int time, const int target[4], const Governor &g) {
+  time = (long)time * 256 / g.scale;
+  if (time > 10) {
+    float increment[4];
+    for (int i = 0; i < 4; i++) increment[i] = (target[i] - position[i]) / (time / 10.0);
+    long final = robot.t + time + (g.groups - 1) * POWER_STAGGER;
+    for (int iteration = 1; robot.t < final; iteration++) {
+      for (int i = 0; i < 4; i++) {
+        int k = std::max(0, std::min(time / 10, iteration - (i % g.groups) * (POWER_STAGGER / 10)));
+        robot.target[i] = position[i] + (int)(k * increment[i]);
+      }
+      robot.wait(10);
+    }
+  }
+  for (int i = 0; i < 4; i++) robot.target[i] = position[i] = target[i];
+}
+
+#define D(g) ((g) * M_PI / 180)
+
+static bool startup = false;
+
+static Result run(const std::string &name, double ocv, double r, const Governor &g) {
+  Robot robot(ocv, r);
+  Oscillator osc[4] = {};
+  int home[4] = {90, 90, 90, 90};
+  int position[4] = {90, 90, 90, 90};
+  robot.wait(100);
+  robot.result = Result{0, ocv, 0, 0};
+  //-- The jump from wherever the servos were to the first sample is not
+  //-- part of the gait
+  if (!startup) robot.measureFrom = robot.t + 150;
+
+  if (name == "jump" || name == "jump T=500") {
+    int T = name == "jump" ? 2000 : 500;
+    int up[4] = {90, 90, 150, 30};
+    moveServos(robot, position, T, up, g);
+    moveServos(robot, position, T, home, g);
+  }
+  else if (name == "walk") {
+    int A[4] = {30, 30, 20, 20}, O[4] = {0, 0, 4, -4};
+    double ph[4] = {0, 0, D(-90), D(-90)};
+    execute(robot, osc, A, O, 1000, ph, 4, g);
+  }
+  else if (name == "turn") {
+    int A[4] = {30, 10, 20, 20}, O[4] = {0, 0, 4, -4};
+    double ph[4] = {0, 0, D(-90), D(-90)};
+    execute(robot, osc, A, O, 2000, ph, 4, g);
+  }
+  else if (name == "updown") {
+    int A[4] = {0, 0, 20, 20}, O[4] = {0, 0, 20, -20};
+    double ph[4] = {0, 0, D(-90), D(90)};
+    execute(robot, osc, A, O, 1000, ph, 1, g);
+  }
+  else if (name == "swing") {
+    int A[4] = {0, 0, 20, 20}, O[4] = {0, 0, 10, -10};
+    double ph[4] = {0, 0, 0, 0};
+    execute(robot, osc, A, O, 1000, ph, 1, g);
+  }
+  else if (name == "tiptoeSwing") {
+    int A[4] = {0, 0, 20, 20}, O[4] = {0, 0, 20, -20};
+    double ph[4] = {0, 0, 0, 0};
+    execute(robot, osc, A, O, 900, ph, 1, g);
+  }
+  else if (name == "jitter") {
+    int A[4] = {20, 20, 0, 0}, O[4] = {0, 0, 0, 0};
+    double ph[4] = {D(-90), D(90), 0, 0};
+    execute(robot, osc, A, O, 500, ph, 1, g);
+  }
+  else if (name == "ascendingTurn") {
+    int A[4] = {13, 13, 13, 13}, O[4] = {0, 0, 17, -9};
+    double ph[4] = {D(-90), D(90), D(-90), D(90)};
+    execute(robot, osc, A, O, 900, ph, 1, g);
+  }
+  else if (name == "moonwalker") {
+    int A[4] = {0, 0, 20, 20}, O[4] = {0, 0, 12, -12};
+    double ph[4] = {0, 0, D(-90), D(-60 - 90)};
+    execute(robot, osc, A, O, 900, ph, 1, g);
+  }
+  else if (name == "crusaito" || name == "crusaito h=50") {
+    int h = name == "crusaito" ? 20 : 50;
+    int A[4] = {25, 25, h, h}, O[4] = {0, 0, h / 2 + 4, -h / 2 - 4};
+    double ph[4] = {90, 90, 0, D(-60)};
+    execute(robot, osc, A, O, name == "crusaito" ? 900 : 700, ph, 1, g);
+  }
+  else if (name == "flapping" || name == "flapping h=30") {
+    int h = name == "flapping" ? 20 : 30;
+    int A[4] = {12, 12, h, h}, O[4] = {0, 0, h - 10, -h + 10};
+    double ph[4] = {0, D(180), D(-90), D(90)};
+    execute(robot, osc, A, O, name == "flapping" ? 1000 : 600, ph, 1, g);
+  }
+  return robot.result;
+}
+
+
+int main(int argc, char *argv[]) {
+  int mv = 3350, policy = 1;
+  double r = 0.35;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-v") && i + 1 < argc) mv = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "-r") && i + 1 < argc) r = atof(argv[++i]);
+    else if (!strcmp(argv[i], "-p") && i + 1 < argc) policy = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "-s")) startup = true;
+    else {
+      fprintf(stderr, "usage: powersim [-v mV] [-r ohms] [-p policy] [-s]\n");
+      return 1;
+    }
+  }
+  if (policy < 1 || policy > 2) policy = 1;
+
+  Governor off = {&policies[0], 256, 1};
+  Governor on = {&policies[policy], powerScale(policies[policy], mv), 1};
+  on.groups = powerGroups(policies[policy], on.scale);
+
+  printf("Battery %d mV, %.2f ohm, %s: scale %d/256, %d servo group(s)\n\n", mv, r,
+         policy == 1 ? "POWER_BALANCED" : "POWER_SAVE", on.scale, on.groups);
+  printf("%-16s %21s %21s %10s\n", "", "peak current (A)", "minimum voltage (V)", "sag");
+  printf("%-16s %10s %10s %10s %10s %10s\n", "motion", "off", "governed", "off", "governed", "reduction");
+
+  const char *names[] = {"walk", "turn", "updown", "swing", "tiptoeSwing", "jitter", "ascendingTurn",
+                         "moonwalker", "crusaito", "crusaito h=50", "flapping", "flapping h=30", "jump",
+                         "jump T=500"};
+  for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+    Result a = run(names[i], mv / 1000.0, r, off);
+    Result b = run(names[i], mv / 1000.0, r, on);
+    double sagA = mv / 1000.0 - a.minVolts, sagB = mv / 1000.0 - b.minVolts;
+    printf("%-16s %10.2f %10.2f %10.3f %10.3f %9.0f%%\n", names[i], a.peak, b.peak, a.minVolts, b.minVolts,
+           sagA > 0 ? 100 * (sagA - sagB) / sagA : 0);
+  }
+  return 0;
+}
@@ -0,0 +1,442 @@
+//--------------------------------------------------------------
+//-- songc
+//-- Compiles songs into packed PROGMEM note streams that can be
+//-- played with BuzzerSynth::playSong() / Zowi::playSong()
+//--------------------------------------------------------------
+//-- Build (host):  g++ -O2 -o songc songc.cpp
+//-- Usage:        songc [-n name] [-u unit] [-g gap] [-t semitones] song > song.h
+//--    -n : name of the array (default: file name)
+//--    -u : duration unit in ms (default: the one giving the smallest song)
+//--    -g : silence in ms added at the end of every note (RTTTL and MIDI)
+//--    -t : transpose, in semitones
+//--
+//-- Input formats (by file extension):
+//--    .mid / .midi : standard MIDI file, format 0 or 1. The highest
+//--                   sounding note is kept (drums are ignored)
+//--    .notes       : one note per line "E5 50 30" (note, ms, silence ms),
+//--                   "P 100" is a rest. Same arguments as Zowi::_tone()
+//--    anything else: RTTTL, e.g. "zowi:d=8,o=5,b=120:e,g,4c6,p,c6"
+//--
+//-- Output: unit byte, then (note, duration) byte pairs, then 0xFF.
+//-- Notes are 1 + semitones from C0 (note_C0 = 1 ... note_Eb8 = 100)
+//--------------------------------------------------------------
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+//-- Must match BuzzerSynth.h
+#define SONG_REST 0
+#define SONG_END 0xFF
+#define SONG_NOTES 100
+
+struct Segment {
+  int note;      //-- Semitones from C0, -1 = rest
+  double ms;
+};
+
+
+static void fail(const std::string &msg) {
+  fprintf(stderr, "songc: %s\n", msg.c_str());
+  exit(1);
+}
+
+static std::string readFile(const char *path) {
+  FILE *f = fopen(path, "rb");
+  if (!f) fail(std::string("cannot open ") + path);
+  std::string data;
+  char buffer[4096];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) data.append(buffer, n);
+  fclose(f);
+  return data;
+}
+
+static bool endsWith(const std::string &s, const char *suffix) {
+  size_t n = strlen(suffix);
+  if (s.size() < n) return false;
+  for (size_t i = 0; i < n; i++) {
+    if (tolower((unsigned char)s[s.size() - n + i]) != suffix[i]) return false;
+  }
+  return true;
+}
+
+//-- Semitone of a note letter, -1 if it is not a note
+static int letterSemitone(char c) {
+  switch (tolower((unsigned char)c)) {
+    case 'c': return 0;
+    case 'd': return 2;
+    case 'e': return 4;
+    case 'f': return 5;
+    case 'g': return 7;
+    case 'a': return 9;
+    case 'b': case 'h': return 11;
+  }
+  return -1;
+}
+
+
+//--------------------------------------------------------------
+//-- RTTTL
+//--------------------------------------------------------------
+static std::vector<Segment> parseRtttl(const std::string &text, double gap) {
+  std::string s;
+  for (size_t i = 0; i < text.size(); i++) {
+    if (!isspace((unsigned char)text[i])) s += tolower((unsigned char)text[i]);
+  }
+
+  //-- name:defaults:notes (the name is optional)
+  size_t c2 = s.rfind(':');
+  if (c2 == std::string::npos) fail("RTTTL: missing ':'");
+  size_t c1 = s.rfind(':', c2 - 1);
+  std::string defaults = s.substr(c1 == std::string::npos ? 0 : c1 + 1, c2 - (c1 == std::string::npos ? 0 : c1 + 1));
+  std::string notes = s.substr(c2 + 1);
+
+  int defDuration = 4, defOctave = 6, bpm = 63;
+  size_t pos = 0;
+  while (pos < defaults.size()) {
+    size_t end = defaults.find(',', pos);
+    if (end == std::string::npos) end = defaults.size();
+    std::string item = defaults.substr(pos, end - pos);
+    if (item.size() > 2 && item[1] == '=') {
+      int value = atoi(item.c_str() + 2);
+      if (item[0] == 'd') defDuration = value;
+      else if (item[0] == 'o') defOctave = value;
+      else if (item[0] == 'b') bpm = value;
+    }
+    pos = end + 1;
+  }
+  if (defDuration <= 0 || bpm <= 0) fail("RTTTL: bad defaults");
+
+  double whole = 240000.0 / bpm;
+  std::vector<Segment> song;
+  pos = 0;
+  while (pos < notes.size()) {
+    size_t end = notes.find(',', pos);
+    if (end == std::string::npos) end = notes.size();
+    std::string item = notes.substr(pos, end - pos);
+    pos = end + 1;
+    if (item.empty()) continue;
+
+    size_t i = 0;
+    int duration = 0;
+    while (i < item.size() && isdigit((unsigned char)item[i])) duration = duration * 10 + (item[i++] - '0');
+    if (duration == 0) duration = defDuration;
+    if (i >= item.size()) fail("RTTTL: bad note '" + item + "'");
+
+    char letter = item[i++];
+    int semitone = letterSemitone(letter);
+    if (semitone < 0 && letter != 'p') fail("RTTTL: bad note '" + item + "'");
+    if (i < item.size() && item[i] == '#') { semitone++; i++; }
+
+    bool dotted = false;
+    if (i < item.size() && item[i] == '.') { dotted = true; i++; }
+    int octave = defOctave;
+    if (i < item.size() && isdigit((unsigned char)item[i])) octave = item[i++] - '0';
+    if (i < item.size() && item[i] == '.') { dotted = true; i++; }
+
+    double ms = whole / duration * (dotted ? 1.5 : 1.0);
+    if (letter == 'p') {
+      song.push_back(Segment{-1, ms});
+    }
+    else {
+      double g = std::min(gap, ms / 2);
+      song.push_back(Segment{octave * 12 + semitone, ms - g});
+      if (g > 0) song.push_back(Segment{-1, g});
+    }
+  }
+  return song;
+}
+
+
+//--------------------------------------------------------------
+//-- Note lists (.notes)
+//--------------------------------------------------------------
+static int parseNoteName(const std::string &name) {
+  if (name == "p" || name == "P" || name == "r" || name == "R") return -1;
+  size_t i = 0;
+  int semitone = name.empty() ? -1 : letterSemitone(name[i++]);
+  if (semitone < 0) fail("bad note name '" + name + "'");
+  if (i < name.size() && name[i] == '#') { semitone++; i++; }
+  else if (i < name.size() && name[i] == 'b') { semitone--; i++; }
+  if (i >= name.size() || !isdigit((unsigned char)name[i])) fail("bad note name '" + name + "'");
+  return atoi(name.c_str() + i) * 12 + semitone;
+}
+
+static std::vector<Segment> parseNotes(const std::string &text) {
+  std::vector<Segment> song;
+  size_t pos = 0;
+  while (pos < text.size()) {
+    size_t end = text.find('\n', pos);
+    if (end == std::string::npos) end = text.size();
+    std::string line = text.substr(pos, end - pos);
+    pos = end + 1;
+
+    size_t comment = std::min(line.find('#'), line.find("//"));
+    if (comment != std::string::npos) line = line.substr(0, comment);
+
+    char name[16];
+    double ms = 0, gap = 0;
+    int fields = sscanf(line.c_str(), "%15s %lf %lf", name, &ms, &gap);
+    if (fields <= 0) continue;
+    if (fields < 2) fail(std::string("missing duration for ") + name);
+
+    song.push_back(Segment{parseNoteName(name), ms});
+    if (gap > 0) song.push_back(Segment{-1, gap});
+  }
+  return song;
+}
+
+
+//--------------------------------------------------------------
+//-- Standard MIDI files
+//--------------------------------------------------------------
+struct MidiEvent {
+  unsigned long tick;
+  int order;       //-- Offs before ons at the same tick
+  int note;
+  bool on;
+};
+
+static unsigned long readVlq(const std::string &d, size_t &pos, size_t end) {
+  unsigned long value = 0;
+  while (pos < end) {
+    unsigned char b = d[pos++];
+    value = (value << 7) | (b & 0x7F);
+    if (!(b & 0x80)) break;
+  }
+  return value;
+}
+
+static unsigned long be(const std::string &d, size_t pos, int bytes) {
+  unsigned long value = 0;
+  for (int i = 0; i < bytes; i++) value = (value << 8) | (unsigned char)d[pos + i];
+  return value;
+}
+
+static std::vector<Segment> parseMidi(const std::string &d, double gap) {
+  if (d.size() < 14 || d.compare(0, 4, "MThd")) fail("not a MIDI file");
+  unsigned long headerLength = be(d, 4, 4);
+  int tracks = be(d, 10, 2);
+  unsigned int division = be(d, 12, 2);
+
+  std::vector<MidiEvent> events;
+  std::map<unsigned long, double> tempos;    //-- tick -> us per quarter note
+  tempos[0] = 500000;
+
+  size_t pos = 8 + headerLength;
+  for (int t = 0; t < tracks && pos + 8 <= d.size(); t++) {
+    unsigned long length = be(d, pos + 4, 4);
+    bool isTrack = !d.compare(pos, 4, "MTrk");
+    size_t p = pos + 8, end = std::min(d.size(), (size_t)(pos + 8 + length));
+    pos = end;
+    if (!isTrack) { t--; continue; }
+
+    unsigned long tick = 0;
+    unsigned char status = 0;
+    while (p < end) {
+      tick += readVlq(d, p, end);
+      if (p >= end) break;
+      unsigned char b = d[p];
+      if (b & 0x80) { status = b; p++; }
+      if (status == 0xFF) {
+        unsigned char type = d[p++];
+        unsigned long len = readVlq(d, p, end);
+        if (type == 0x51 && len == 3) tempos[tick] = be(d, p, 3);
+        p += len;
+        status = 0;
+      }
+      else if (status == 0xF0 || status == 0xF7) {
+        p += readVlq(d, p, end);
+        status = 0;
+      }
+      else if (status >= 0x80) {
+        int kind = status & 0xF0, channel = status & 0x0F;
+        int size = (kind == 0xC0 || kind == 0xD0) ? 1 : 2;
+        if (p + size > end) break;
+        int note = (unsigned char)d[p], velocity = size > 1 ? (unsigned char)d[p + 1] : 0;
+        p += size;
+        if (channel == 9) continue;
+        if (kind == 0x90 && velocity > 0) events.push_back(MidiEvent{tick, 1, note, true});
+        else if (kind == 0x80 || kind == 0x90) events.push_back(MidiEvent{tick, 0, note, false});
+      }
+      else {
+        fail("corrupt MIDI track");
+      }
+    }
+  }
+
+  std::sort(events.begin(), events.end(), [](const MidiEvent &a, const MidiEvent &b) {
+    return a.tick != b.tick ? a.tick < b.tick : a.order < b.order;
+  });
+
+  //-- Tick to ms, following the tempo changes
+  auto toMs = [&](unsigned long tick) {
+    if (division & 0x8000) {
+      int fps = -(signed char)(division >> 8);
+      return tick * 1000.0 / (fps * (division & 0xFF));
+    }
+    double ms = 0;
+    unsigned long last = 0;
+    double tempo = 500000;
+    for (std::map<unsigned long, double>::iterator it = tempos.begin(); it != tempos.end() && it->first < tick; ++it) {
+      ms += (it->first - last) * tempo / division / 1000.0;
+      last = it->first;
+      tempo = it->second;
+    }
+    return ms + (tick - last) * tempo / division / 1000.0;
+  };
+
+  //-- Skyline: the highest note sounding in each interval
+  std::vector<Segment> song;
+  std::multiset<int> sounding;
+  double startMs = 0;
+  int current = -1;
+  for (size_t i = 0; i < events.size();) {
+    unsigned long tick = events[i].tick;
+    for (; i < events.size() && events[i].tick == tick; i++) {
+      if (events[i].on) sounding.insert(events[i].note);
+      else if (sounding.count(events[i].note)) sounding.erase(sounding.find(events[i].note));
+    }
+    int top = sounding.empty() ? -1 : *sounding.rbegin() - 12;    //-- MIDI 12 = C0
+    double now = toMs(tick);
+    if (top != current || i == events.size()) {
+      if (now > startMs && !(song.empty() && current < 0)) {
+        double ms = now - startMs;
+        double g = current < 0 ? 0 : std::min(gap, ms / 2);
+        song.push_back(Segment{current, ms - g});
+        if (g > 0) song.push_back(Segment{-1, g});
+      }
+      current = top;
+      startMs = now;
+    }
+  }
+  return song;
+}
+
+
+//--------------------------------------------------------------
+//-- Packing
+//--------------------------------------------------------------
+static std::vector<unsigned char> pack(std::vector<Segment> song, int unit, int transpose) {
+  //-- Notes out of range are moved by octaves
+  for (size_t i = 0; i < song.size(); i++) {
+    if (song[i].note < 0) continue;
+    int n = song[i].note + transpose;
+    while (n < 0) n += 12;
+    while (n >= SONG_NOTES) n -= 12;
+    song[i].note = n;
+  }
+
+  std::vector<unsigned char> out;
+  out.push_back(unit);
+  double error = 0;    //-- Carried rounding error, so the tempo does not drift
+  for (size_t i = 0; i < song.size(); i++) {
+    double exact = song[i].ms / unit + error;
+    long units = lround(exact);
+    if (units == 0 && song[i].note >= 0 && song[i].ms > 0) units = 1;
+    error = exact - units;
+
+    unsigned char note = song[i].note < 0 ? SONG_REST : song[i].note + 1;
+    //-- Merge consecutive rests
+    if (note == SONG_REST && out.size() > 1 && out[out.size() - 2] == SONG_REST && out.back() < 255) {
+      long room = 255 - out.back();
+      long add = std::min(room, units);
+      out.back() += add;
+      units -= add;
+    }
+    while (units > 0) {
+      long chunk = std::min(units, 255L);
+      out.push_back(note);
+      out.push_back(chunk);
+      units -= chunk;
+    }
+  }
+  out.push_back(SONG_END);
+  return out;
+}
+
+//-- The unit that packs the song in fewest bytes while every step stays
+//-- within 5 % (or 1 ms) of its length
+static int autoUnit(const std::vector<Segment> &song, int transpose) {
+  int best = 1;
+  size_t bestSize = pack(song, 1, transpose).size();
+  for (int unit = 2; unit <= 255; unit++) {
+    bool fits = true;
+    for (size_t i = 0; i < song.size() && fits; i++) {
+      double error = fabs(lround(song[i].ms / unit) * unit - song[i].ms);
+      fits = error <= std::max(1.0, song[i].ms * 0.05);
+    }
+    if (!fits) continue;
+    size_t size = pack(song, unit, transpose).size();
+    if (size < bestSize) {
+      best = unit;
+      bestSize = size;
+    }
+  }
+  return best;
+}
+
+static std::string baseName(const char *path) {
+  std::string name(path);
+  size_t slash = name.find_last_of("/\\");
+  if (slash != std::string::npos) name = name.substr(slash + 1);
+  size_t dot = name.find('.');
+  if (dot != std::string::npos) name = name.substr(0, dot);
+  for (size_t i = 0; i < name.size(); i++) {
+    if (!isalnum((unsigned char)name[i])) name[i] = '_';
+  }
+  if (name.empty() || isdigit((unsigned char)name[0])) name = "song_" + name;
+  return name;
+}
+
+
+int main(int argc, char *argv[]) {
+  std::string name;
+  int unit = 0, transpose = 0;
+  double gap = 0;
+  const char *path = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-n") && i + 1 < argc) name = argv[++i];
+    else if (!strcmp(argv[i], "-u") && i + 1 < argc) unit = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "-g") && i + 1 < argc) gap = atof(argv[++i]);
+    else if (!strcmp(argv[i], "-t") && i + 1 < argc) transpose = atoi(argv[++i]);
+    else if (argv[i][0] != '-' && !path) path = argv[i];
+    else fail("usage: songc [-n name] [-u unit] [-g gap] [-t semitones] song");
+  }
+  if (!path) fail("usage: songc [-n name] [-u unit] [-g gap] [-t semitones] song");
+  if (unit < 0 || unit > 255) fail("the unit must be between 1 and 255 ms");
+  if (name.empty()) name = baseName(path);
+
+  std::string data = readFile(path);
+  std::string p(path);
+  std::vector<Segment> song;
+  if (endsWith(p, ".mid") || endsWith(p, ".midi")) song = parseMidi(data, gap);
+  else if (endsWith(p, ".notes")) song = parseNotes(data);
+  else song = parseRtttl(data, gap);
+  if (song.empty()) fail("the song has no notes");
+
+  if (unit == 0) unit = autoUnit(song, transpose);
+  std::vector<unsigned char> bytes = pack(song, unit, transpose);
+
+  double total = 0;
+  for (size_t i = 0; i < song.size(); i++) total += song[i].ms;
+  printf("// Generated by songc from %s\n", baseName(path).c_str());
+  printf("// %u steps, unit %d ms, %.2f s, %u bytes\n", (unsigned int)(bytes.size() - 2) / 2, unit, total / 1000,
+         (unsigned int)bytes.size());
+  printf("const unsigned char %s[] PROGMEM = {\n  %d,", name.c_str(), unit);
+  for (size_t i = 1; i < bytes.size(); i += 2) {
+    if ((i - 1) % 16 == 0) printf("\n ");
+    if (i + 1 < bytes.size()) printf(" %d, %d,", bytes[i], bytes[i + 1]);
+    else printf(" 0x%02X", bytes[i]);
+  }
+  printf("\n};\n");
+  return 0;
+}
@@ -0,0 +1,231 @@
+//--------------------------------------------------------------
+//-- wav2sample
+//-- Converts a WAV file into a PROGMEM table that can be played
+//-- with BuzzerSynth::playSample() / Zowi::playSample()
+//--------------------------------------------------------------
+//-- Build (host):  g++ -O2 -o wav2sample wav2sample.cpp
+//-- Usage:        wav2sample [-a] [-n name] [-g gain] file.wav > file.h
+//--    -a : 4 bit IMA ADPCM (half the flash of 8 bit PCM)
+//--    -n : name of the array (default: file name)
+//--    -g : gain applied after normalizing the peak to full scale
+//--
+//-- Input: PCM WAV, 8 or 16 bits, mono or stereo, any sample rate.
+//-- The sound is mixed to mono, normalized and resampled to 8064 Hz,
+//-- the rate BuzzerSynth plays (the table does not store a rate).
+//-- The resampling is linear, with no anti-alias filter: filter
+//-- the input below 4 kHz first, or what is above folds back.
+//--------------------------------------------------------------
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+//-- Must match BuzzerSynth.h
+#define SYNTH_PCM8 0
+#define SYNTH_ADPCM4 1
+#define SYNTH_PCM_RATE 8064
+#define MAX_SAMPLES 65535
+
+static const int adpcmSteps[89] = {
+  7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+  50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+  253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+  1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+  3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+  11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+  32767
+};
+
+static const int adpcmIndexes[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+
+static unsigned int le16(const unsigned char *p) { return p[0] | (p[1] << 8); }
+static unsigned long le32(const unsigned char *p) { return le16(p) | ((unsigned long)le16(p + 2) << 16); }
+
+static void fail(const char *msg, const char *arg = "") {
+  fprintf(stderr, "wav2sample: %s%s\n", msg, arg);
+  exit(1);
+}
+
+
+//-- Read a WAV file as mono samples in [-1, 1]
+static std::vector<double> readWav(const char *path, int &rate) {
+  FILE *f = fopen(path, "rb");
+  if (!f) fail("cannot open ", path);
+  std::vector<unsigned char> file;
+  unsigned char buffer[4096];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) file.insert(file.end(), buffer, buffer + n);
+  fclose(f);
+
+  if (file.size() < 12 || memcmp(&file[0], "RIFF", 4) || memcmp(&file[8], "WAVE", 4))
+    fail("not a WAV file: ", path);
+
+  int format = 0, channels = 0, bits = 0;
+  const unsigned char *data = 0;
+  unsigned long dataSize = 0;
+
+  for (size_t pos = 12; pos + 8 <= file.size();) {
+    unsigned long size = le32(&file[pos + 4]);
+    const unsigned char *chunk = &file[pos + 8];
+    if (pos + 8 + size > file.size()) size = file.size() - pos - 8;
+
+    if (!memcmp(&file[pos], "fmt ", 4) && size >= 16) {
+      format = le16(chunk);
+      channels = le16(chunk + 2);
+      rate = le32(chunk + 4);
+      bits = le16(chunk + 14);
+    }
+    else if (!memcmp(&file[pos], "data", 4)) {
+      data = chunk;
+      dataSize = size;
+    }
+    pos += 8 + size + (size & 1);
+  }
+
+  if (format != 1) fail("only PCM WAV files are supported");
+  if (bits != 8 && bits != 16) fail("only 8 or 16 bit WAV files are supported");
+  if (channels < 1 || !data) fail("no audio data in ", path);
+
+  int frameSize = channels * bits / 8;
+  std::vector<double> out(dataSize / frameSize);
+  for (size_t i = 0; i < out.size(); i++) {
+    double sum = 0;
+    for (int c = 0; c < channels; c++) {
+      const unsigned char *s = data + i * frameSize + c * bits / 8;
+      if (bits == 8) sum += (s[0] - 128) / 128.0;
+      else sum += (short)le16(s) / 32768.0;
+    }
+    out[i] = sum / channels;
+  }
+  return out;
+}
+
+
+//-- Linear interpolation resampler
+static std::vector<double> resample(const std::vector<double> &in, int from, int to) {
+  if (in.empty() || from == to) return in;
+  size_t length = (size_t)((double)in.size() * to / from);
+  std::vector<double> out(length);
+  for (size_t i = 0; i < length; i++) {
+    double x = (double)i * from / to;
+    size_t j = (size_t)x;
+    double frac = x - j;
+    double a = in[j];
+    double b = j + 1 < in.size() ? in[j + 1] : a;
+    out[i] = a + (b - a) * frac;
+  }
+  return out;
+}
+
+
+//-- IMA ADPCM encoder. It tracks the decoder state so that the firmware
+//-- (BuzzerSynth synthAdpcm) reconstructs exactly the same signal
+static std::vector<unsigned char> encodeAdpcm(const std::vector<double> &in) {
+  std::vector<unsigned char> out((in.size() + 1) / 2);
+  int predictor = 0, index = 0;
+
+  for (size_t i = 0; i < in.size(); i++) {
+    int sample = (int)lround(in[i] * 32767);
+    int step = adpcmSteps[index];
+    int diff = sample - predictor;
+    int code = 0;
+    if (diff < 0) { code = 8; diff = -diff; }
+    if (diff >= step) { code |= 4; diff -= step; }
+    if (diff >= step / 2) { code |= 2; diff -= step / 2; }
+    if (diff >= step / 4) code |= 1;
+
+    //-- Same arithmetic as the decoder
+    int delta = step >> 3;
+    if (code & 4) delta += step;
+    if (code & 2) delta += step >> 1;
+    if (code & 1) delta += step >> 2;
+    predictor += (code & 8) ? -delta : delta;
+    if (predictor > 32767) predictor = 32767;
+    if (predictor < -32768) predictor = -32768;
+    index += adpcmIndexes[code & 7];
+    if (index < 0) index = 0;
+    if (index > 88) index = 88;
+
+    if (i & 1) out[i / 2] |= code << 4;
+    else out[i / 2] = code;
+  }
+  return out;
+}
+
+
+static std::string baseName(const char *path) {
+  std::string name(path);
+  size_t slash = name.find_last_of("/\\");
+  if (slash != std::string::npos) name = name.substr(slash + 1);
+  size_t dot = name.find('.');
+  if (dot != std::string::npos) name = name.substr(0, dot);
+  for (size_t i = 0; i < name.size(); i++) {
+    if (!isalnum((unsigned char)name[i])) name[i] = '_';
+  }
+  if (name.empty() || isdigit((unsigned char)name[0])) name = "s_" + name;
+  return name;
+}
+
+
+int main(int argc, char *argv[]) {
+  bool adpcm = false;
+  std::string name;
+  const int rate = SYNTH_PCM_RATE;
+  double gain = 1.0;
+  const char *path = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-a")) adpcm = true;
+    else if (!strcmp(argv[i], "-n") && i + 1 < argc) name = argv[++i];
+    else if (!strcmp(argv[i], "-g") && i + 1 < argc) gain = atof(argv[++i]);
+    else if (argv[i][0] != '-' && !path) path = argv[i];
+    else fail("usage: wav2sample [-a] [-n name] [-g gain] file.wav");
+  }
+  if (!path) fail("usage: wav2sample [-a] [-n name] [-g gain] file.wav");
+  if (name.empty()) name = baseName(path);
+
+  int inRate = 0;
+  std::vector<double> sound = readWav(path, inRate);
+  sound = resample(sound, inRate, rate);
+
+  //-- Remove the DC offset and normalize: the buzzer needs all the level it can get
+  double mean = 0, peak = 0;
+  for (size_t i = 0; i < sound.size(); i++) mean += sound[i];
+  if (!sound.empty()) mean /= sound.size();
+  for (size_t i = 0; i < sound.size(); i++) peak = std::max(peak, fabs(sound[i] - mean));
+  for (size_t i = 0; i < sound.size(); i++) {
+    double x = peak > 0 ? (sound[i] - mean) / peak * gain : 0;
+    sound[i] = std::max(-1.0, std::min(1.0, x));
+  }
+
+  if (sound.size() > MAX_SAMPLES) {
+    fprintf(stderr, "wav2sample: %s truncated to %d samples\n", path, MAX_SAMPLES);
+    sound.resize(MAX_SAMPLES);
+  }
+
+  std::vector<unsigned char> bytes;
+  if (adpcm) {
+    bytes = encodeAdpcm(sound);
+  }
+  else {
+    for (size_t i = 0; i < sound.size(); i++) bytes.push_back((unsigned char)lround(sound[i] * 127) + 128);
+  }
+
+  unsigned int length = sound.size();
+  printf("// Generated by wav2sample from %s\n", baseName(path).c_str());
+  printf("// %u samples at %d Hz (%.2f s), %s, %u bytes\n", length, rate, (double)length / rate,
+         adpcm ? "4 bit IMA ADPCM" : "8 bit PCM", (unsigned int)bytes.size() + 4);
+  printf("const unsigned char %s[] PROGMEM = {\n", name.c_str());
+  printf("  %d, 0x%02X, 0x%02X, 0,", adpcm ? SYNTH_ADPCM4 : SYNTH_PCM8, length & 0xFF, length >> 8);
+  for (size_t i = 0; i < bytes.size(); i++) {
+    if (i % 16 == 0) printf("\n ");
+    printf(" 0x%02X,", bytes[i]);
+  }
+  printf("\n};\n");
+  return 0;
+}